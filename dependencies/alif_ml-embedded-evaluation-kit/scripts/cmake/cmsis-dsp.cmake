@@ -95,6 +95,9 @@ target_compile_definitions(${CMSIS_DSP_TARGET} PUBLIC
     ARM_TABLE_BITREVIDX_FLT_512 # see https://github.com/ARM-software/CMSIS-DSP/issues/61
     ARM_TABLE_BITREVIDX_FXT_1024
     ARM_TABLE_BITREVIDX_FLT_1024
+    ARM_TABLE_REALCOEF_Q15          # Q15 real FFT of 512 and 1024 points
+    ARM_TABLE_TWIDDLECOEF_Q15_256
+    ARM_TABLE_TWIDDLECOEF_Q15_512
     ARM_FAST_ALLOW_TABLES
     ARM_ALL_FAST_TABLES
 )
@@ -134,7 +134,14 @@ function(add_linker_script TARGET_NAME SCRIPT_DIR SCRIPT_NAME)
         message(FATAL_ERROR "Linker script not found: ${LINKER_SCRIPT_PATH}")
     endif()
     message(STATUS "Using linker script: ${LINKER_SCRIPT_PATH}")
+    # Scripts INCLUDE fragments, which an application may override by
+    # generating its own copies in LINKER_SCRIPT_INCLUDE_DIR.
+    if (DEFINED LINKER_SCRIPT_INCLUDE_DIR)
+        target_link_options(${TARGET_NAME} PUBLIC
+            "SHELL:-L ${LINKER_SCRIPT_INCLUDE_DIR}")
+    endif()
     target_link_options(${TARGET_NAME} PUBLIC
+        "SHELL:-L ${SCRIPT_DIR}"
         "SHELL:-T ${LINKER_SCRIPT_PATH}")
 endfunction()
 
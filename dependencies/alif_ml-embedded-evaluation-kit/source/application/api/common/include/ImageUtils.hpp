@@ -19,7 +19,6 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <forward_list>
 #include <vector>
 
 /* Helper macro to convert RGB888 to RGB565 format. */
@@ -48,10 +47,84 @@ namespace image {
 
     struct Detection {
         Box bbox;
-        std::vector<float> prob;
+        float* prob;        /* Class scores, owned by the DetectionPool. */
         float objectness;
     };
 
+    /**
+     * @brief   Fixed capacity, array backed set of detections. The detections and
+     *          their class scores are allocated once, when the pool is created, so
+     *          decoding and NMS don't allocate.
+     *
+     *          Detections are kept newest first, which is the order NMS uses to
+     *          break ties between equal scores. With topN set, only the topN
+     *          detections with the highest objectness are kept; once full, the
+     *          pool is ordered by ascending objectness.
+     */
+    class DetectionPool {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param[in]   capacity   Most detections that can be added, used when topN is 0.
+         * @param[in]   classes    Number of class scores per detection.
+         * @param[in]   topN       Number of detections to keep, 0 to keep them all.
+         **/
+        DetectionPool(size_t capacity, int classes, size_t topN = 0);
+
+        /* Detections point into the pool's storage, so it can be moved but not copied. */
+        DetectionPool(const DetectionPool&) = delete;
+        DetectionPool& operator=(const DetectionPool&) = delete;
+        DetectionPool(DetectionPool&&) = default;
+        DetectionPool& operator=(DetectionPool&&) = default;
+
+        /**
+         * @brief   Remove all detections, keeping the storage.
+         **/
+        void Clear();
+
+        /**
+         * @brief       Add a detection.
+         * @param[in]   objectness   Objectness score of the new detection.
+         * @return      The new detection, with its bbox to fill in and class scores
+         *              zeroed, or nullptr if it doesn't make the top N or the pool is full.
+         **/
+        Detection* Add(float objectness);
+
+        size_t Size() const { return m_size; }
+        int Classes() const { return m_classes; }
+        Detection* begin() { return m_detections.data() + m_first; }
+        Detection* end() { return m_detections.data() + m_first + m_size; }
+        Detection& operator[](size_t index) { return begin()[index]; }
+
+    private:
+        friend void CalculateNMS(DetectionPool& detections, float iouThreshold);
+
+        struct NmsEntry {
+            float score;
+            uint32_t det;
+            uint32_t cls;
+        };
+
+        int m_classes;
+        size_t m_topN;
+        size_t m_first{0};
+        size_t m_size{0};
+        bool m_ranked{false};
+        std::vector<Detection> m_detections;
+        std::vector<float> m_probs;
+
+        /* NMS scratch, one entry per (detection, class) pair. */
+        std::vector<NmsEntry> m_entries;
+        std::vector<float> m_left;
+        std::vector<float> m_right;
+        std::vector<float> m_top;
+        std::vector<float> m_bottom;
+        std::vector<float> m_area;
+        std::vector<uint8_t> m_suppressed;
+        std::vector<uint32_t> m_order;
+        std::vector<Detection> m_reordered;
+    };
+
     /**
      * @brief       Calculate the 1D overlap.
      * @param[in]   x1Center   First center point.
@@ -88,11 +161,12 @@ namespace image {
 
     /**
      * @brief       Calculate the Non-Maxima suppression on the given detection boxes.
-     * @param[in]   detections    List of Detection boxes.
-     * @param[in]   classes       Number of classes.
-     * @param[in]   iouThreshold  Intersection over union threshold.
+     *              Suppressed class scores are set to 0, and the detections are left
+     *              ordered by score, highest class first.
+     * @param[in,out]   detections    Pool of Detection boxes.
+     * @param[in]       iouThreshold  Intersection over union threshold.
      **/
-    void CalculateNMS(std::forward_list<Detection>& detections, int classes, float iouThreshold);
+    void CalculateNMS(DetectionPool& detections, float iouThreshold);
 
     /**
      * @brief           Helper function to convert a UINT8 image to INT8 format.
@@ -138,7 +138,6 @@ namespace audio {
         static constexpr float ms_minLogHz = 1000.0;
         static constexpr float ms_minLogMel = ms_minLogHz / ms_freqStep;
 
-    protected:
         /**
          * @brief       Project input frequency to Mel Scale.
          * @param[in]   freq           Input frequency in floating point.
@@ -160,6 +159,7 @@ namespace audio {
         static float InverseMelScale(float melFreq,
                                      bool  useHTKMethod = true);
 
+    protected:
         /**
          * @brief       Populates MEL energies after applying the MEL filter
          *              bank weights and adding them up to be placed into
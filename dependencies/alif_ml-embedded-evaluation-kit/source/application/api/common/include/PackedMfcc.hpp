@@ -0,0 +1,185 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef PACKED_MFCC_HPP
+#define PACKED_MFCC_HPP
+
+#include "Mfcc.hpp"
+#include "PlatformMath.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /* Arithmetic used for the window, FFT and mel filterbank. */
+    enum class MfccPrecision {
+        F32 = 0,
+        Q15 = 1
+    };
+
+    /**
+     * @brief   MFCC feature extraction with the mel filterbank packed into
+     *          one array of non-zero weights, and every buffer allocated at
+     *          construction, so computing a frame doesn't allocate.
+     *
+     *          F32 gives the same features as MFCC with its default filterbank
+     *          normaliser, log and DCT, to within float rounding. Q15 runs the
+     *          window, FFT and mel filterbank in fixed point, normalising each
+     *          frame to full scale first; it is faster, but less accurate in
+     *          the quietest mel bands.
+     */
+    class PackedMfcc {
+    public:
+        /**
+         * @brief       Constructor
+         * @param[in]   params      MFCC parameters.
+         * @param[in]   precision   Arithmetic for the FFT and filterbank.
+         **/
+        explicit PackedMfcc(const MfccParams& params,
+                            MfccPrecision precision = MfccPrecision::F32);
+
+        PackedMfcc() = delete;
+
+        ~PackedMfcc() = default;
+
+        /**
+         * @brief       Extract MFCC features for one frame of audio data.
+         * @param[in]   audioData   m_frameLen audio samples.
+         * @param[out]  mfccOut     m_numMfccFeatures features.
+         **/
+        void MfccCompute(const int16_t* audioData, float* mfccOut);
+
+        /**
+         * @brief       Extract MFCC features and quantise them for one frame
+         *              of audio data.
+         * @param[in]   audioData     m_frameLen audio samples.
+         * @param[in]   quantScale    Quantisation scale.
+         * @param[in]   quantOffset   Quantisation offset.
+         * @param[out]  mfccOut       m_numMfccFeatures quantised features.
+         **/
+        template<typename T>
+        void MfccComputeQuant(const int16_t* audioData,
+                              const float quantScale,
+                              const int quantOffset,
+                              T* mfccOut)
+        {
+            this->ComputeMelEnergies(audioData);
+            const float minVal = std::numeric_limits<T>::min();
+            const float maxVal = std::numeric_limits<T>::max();
+
+            for (uint32_t i = 0; i < this->m_params.m_numMfccFeatures; ++i) {
+                float sum = std::round((this->Dct(i) / quantScale) + quantOffset);
+                mfccOut[i] = static_cast<T>(std::min<float>(std::max<float>(sum, minVal), maxVal));
+            }
+        }
+
+        /**
+         * @brief       As MfccCompute, returning a vector like MFCC::MfccCompute.
+         * @param[in]   audioData   Vector of audio samples.
+         * @return      Vector of extracted MFCC features.
+         **/
+        std::vector<float> MfccCompute(const std::vector<int16_t>& audioData);
+
+        /**
+         * @brief       As MfccComputeQuant, returning a vector like
+         *              MFCC::MfccComputeQuant.
+         * @param[in]   audioData     Vector of audio samples.
+         * @param[in]   quantScale    Quantisation scale.
+         * @param[in]   quantOffset   Quantisation offset.
+         * @return      Vector of extracted quantised MFCC features.
+         **/
+        template<typename T>
+        std::vector<T> MfccComputeQuant(const std::vector<int16_t>& audioData,
+                                        const float quantScale,
+                                        const int quantOffset)
+        {
+            std::vector<T> mfccOut(this->m_params.m_numMfccFeatures);
+            this->MfccComputeQuant<T>(audioData.data(), quantScale, quantOffset, mfccOut.data());
+            return mfccOut;
+        }
+
+        /** @brief  Number of non-zero filterbank weights. */
+        size_t FilterBankSize() const;
+
+    private:
+        MfccParams                      m_params;
+        MfccPrecision                   m_precision;
+
+        /* Filter bin b applies m_fbWeights[m_fbOffset[b] .. m_fbOffset[b + 1])
+         * to the spectrum from bin m_fbFirst[b]. */
+        std::vector<uint32_t>           m_fbFirst;
+        std::vector<uint32_t>           m_fbOffset;
+        std::vector<float>              m_fbWeights;
+        std::vector<int16_t>            m_fbWeightsQ15;
+        uint32_t                        m_numSpectrumBins{0};
+
+        std::vector<float>              m_dctMatrix;
+        std::vector<float>              m_melEnergies;
+
+        /* F32 buffers */
+        std::vector<float>              m_windowFunc;
+        std::vector<float>              m_frame;
+        std::vector<float>              m_buffer;
+        std::vector<float>              m_spectrum;
+        math::FftInstance               m_fftInstance;
+
+        /* Q15 buffers */
+        std::vector<int16_t>            m_windowFuncQ15;
+        std::vector<int16_t>            m_frameQ15;
+        std::vector<int16_t>            m_bufferQ15;
+        std::vector<int16_t>            m_spectrumQ15;
+        math::FftInstanceQ15            m_fftInstanceQ15;
+
+        /** @brief  Creates the packed mel filterbank and the DCT matrix. */
+        void InitMelFilterBank();
+
+        /**
+         * @brief       Computes the log mel energies for one frame.
+         * @param[in]   audioData   m_frameLen audio samples.
+         **/
+        void ComputeMelEnergies(const int16_t* audioData);
+
+        /**
+         * @brief       Windows the frame and computes the F32 magnitude spectrum.
+         * @param[in]   audioData   m_frameLen audio samples.
+         **/
+        void ComputeSpectrumF32(const int16_t* audioData);
+
+        /**
+         * @brief       Computes the mel energies for one frame in Q15.
+         * @param[in]   audioData   m_frameLen audio samples.
+         **/
+        void ComputeMelEnergiesQ15(const int16_t* audioData);
+
+        /**
+         * @brief       One DCT coefficient of the current log mel energies.
+         * @param[in]   index   Coefficient index.
+         * @return      DCT coefficient.
+         **/
+        float Dct(uint32_t index);
+    };
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* PACKED_MFCC_HPP */
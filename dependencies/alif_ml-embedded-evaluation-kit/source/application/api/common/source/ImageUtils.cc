@@ -16,8 +16,13 @@
  */
 #include "ImageUtils.hpp"
 
+#include <algorithm>
 #include <limits>
 
+#if __ARM_FEATURE_MVE & 1
+#include <arm_mve.h>
+#endif
+
 namespace arm {
 namespace app {
 namespace image {
@@ -72,28 +77,242 @@ namespace image {
         return boxes_intersection / boxes_union;
     }
 
-    void CalculateNMS(std::forward_list<Detection>& detections, int classes, float iouThreshold)
+    DetectionPool::DetectionPool(size_t capacity, int classes, size_t topN)
+    :   m_classes{classes},
+        m_topN{topN}
+    {
+        if (topN > 0) {
+            capacity = topN;
+        }
+        const size_t entries = capacity * classes;
+
+        this->m_detections.resize(capacity);
+        this->m_probs.resize(entries);
+        for (size_t i = 0; i < capacity; ++i) {
+            this->m_detections[i].prob = &this->m_probs[i * classes];
+        }
+        this->m_entries.resize(entries);
+        this->m_left.resize(entries);
+        this->m_right.resize(entries);
+        this->m_top.resize(entries);
+        this->m_bottom.resize(entries);
+        this->m_area.resize(entries);
+        this->m_suppressed.resize(entries);
+        this->m_order.resize(capacity);
+        this->m_reordered.resize(capacity);
+        this->m_first = capacity;
+    }
+
+    void DetectionPool::Clear()
     {
-        int idxClass{0};
-        auto CompareProbs = [idxClass](Detection& prob1, Detection& prob2) {
-            return prob1.prob[idxClass] > prob2.prob[idxClass];
+        this->m_first = this->m_detections.size();
+        this->m_size = 0;
+        this->m_ranked = false;
+    }
+
+    Detection* DetectionPool::Add(float objectness)
+    {
+        Detection* det;
+
+        if (this->m_size < this->m_detections.size()) {
+            /* Fill from the back, so the newest is always first. */
+            det = &this->m_detections[--this->m_first];
+            ++this->m_size;
+        } else if (this->m_topN == 0) {
+            return nullptr;
+        } else {
+            auto first = this->m_detections.begin();
+            auto last = this->m_detections.end();
+
+            if (!this->m_ranked) {
+                /* Stable insertion sort by objectness, only done once: equal
+                 * scores stay newest first. */
+                for (auto it = first + 1; it != last; ++it) {
+                    Detection tmp = *it;
+                    auto hole = it;
+                    for (; hole != first && (hole - 1)->objectness > tmp.objectness; --hole) {
+                        *hole = *(hole - 1);
+                    }
+                    *hole = tmp;
+                }
+                this->m_ranked = true;
+            }
+
+            /* Goes after every detection with no higher objectness, and
+             * pushes out the lowest. If that's itself, drop it. */
+            auto pos = std::upper_bound(first, last, objectness,
+                [](float score, const Detection& d) { return score < d.objectness; });
+            if (pos == first) {
+                return nullptr;
+            }
+            std::rotate(first, first + 1, pos);
+            det = &*(pos - 1);
+        }
+
+        det->bbox = Box{};
+        det->objectness = objectness;
+        std::fill(det->prob, det->prob + this->m_classes, 0.0f);
+        return det;
+    }
+
+    void CalculateNMS(DetectionPool& detections, float iouThreshold)
+    {
+        Detection* dets = detections.begin();
+        const size_t count = detections.Size();
+        const int classes = detections.Classes();
+
+        DetectionPool::NmsEntry* entries = detections.m_entries.data();
+        float* left = detections.m_left.data();
+        float* right = detections.m_right.data();
+        float* top = detections.m_top.data();
+        float* bottom = detections.m_bottom.data();
+        float* area = detections.m_area.data();
+        uint8_t* suppressed = detections.m_suppressed.data();
+        uint32_t* order = detections.m_order.data();
+
+        /* Orders by score for class cls, then for each lower class, then by
+         * position. It's the order repeatedly stable sorting by class score
+         * gives, which decides which of two equal boxes is kept. */
+        auto ranksBefore = [dets](uint32_t a, uint32_t b, int cls) {
+            for (int c = cls; c >= 0; --c) {
+                if (dets[a].prob[c] != dets[b].prob[c]) {
+                    return dets[a].prob[c] > dets[b].prob[c];
+                }
+            }
+            return a < b;
         };
 
-        for (idxClass = 0; idxClass < classes; ++idxClass) {
-            detections.sort(CompareProbs);
+        /* One entry per non-zero class score, sorted once by (class, score). */
+        size_t numEntries = 0;
+        for (uint32_t d = 0; d < count; ++d) {
+            for (int c = 0; c < classes; ++c) {
+                if (dets[d].prob[c] != 0) {
+                    entries[numEntries++] = {dets[d].prob[c], d, static_cast<uint32_t>(c)};
+                }
+            }
+        }
+        std::sort(entries, entries + numEntries,
+            [&ranksBefore](const DetectionPool::NmsEntry& a, const DetectionPool::NmsEntry& b) {
+                if (a.cls != b.cls) {
+                    return a.cls < b.cls;
+                }
+                if (a.score != b.score) {
+                    return a.score > b.score;
+                }
+                return ranksBefore(a.det, b.det, static_cast<int>(a.cls) - 1);
+            });
+
+        for (size_t e = 0; e < numEntries; ++e) {
+            const Box& box = dets[entries[e].det].bbox;
+            left[e] = box.x - box.w/2;
+            right[e] = box.x + box.w/2;
+            top[e] = box.y - box.h/2;
+            bottom[e] = box.y + box.h/2;
+            area[e] = box.w * box.h;
+            suppressed[e] = 0;
+        }
+
+        /* Greedy suppression within each class, with the same arithmetic as
+         * CalculateBoxIOU so the same boxes survive. */
+#if __ARM_FEATURE_MVE & 1
+        const bool suppressDisjoint = 0.0f > iouThreshold;
+#endif
+        for (size_t begin = 0; begin < numEntries;) {
+            size_t end = begin + 1;
+            while (end < numEntries && entries[end].cls == entries[begin].cls) {
+                ++end;
+            }
+
+            for (size_t i = begin; i < end; ++i) {
+                if (suppressed[i]) {
+                    continue;
+                }
+#if __ARM_FEATURE_MVE & 1
+                const float32x4_t li = vdupq_n_f32(left[i]);
+                const float32x4_t ri = vdupq_n_f32(right[i]);
+                const float32x4_t ti = vdupq_n_f32(top[i]);
+                const float32x4_t bi = vdupq_n_f32(bottom[i]);
+                const float32x4_t ai = vdupq_n_f32(area[i]);
+
+                for (size_t j = i + 1; j < end; j += 4) {
+                    const mve_pred16_t p = vctp32q(end - j);
+                    float32x4_t width = vsubq(vminnmq(ri, vldrwq_z_f32(&right[j], p)),
+                                              vmaxnmq(li, vldrwq_z_f32(&left[j], p)));
+                    float32x4_t height = vsubq(vminnmq(bi, vldrwq_z_f32(&bottom[j], p)),
+                                               vmaxnmq(ti, vldrwq_z_f32(&top[j], p)));
+                    float32x4_t inter = vmulq(width, height);
+                    inter = vpselq(vdupq_n_f32(0.0f), inter,
+                                   vcmpltq(width, 0.0f) | vcmpltq(height, 0.0f));
 
-            for (auto it=detections.begin(); it != detections.end(); ++it) {
-                if (it->prob[idxClass] == 0) continue;
-                for (auto itc=std::next(it, 1); itc != detections.end(); ++itc) {
-                    if (itc->prob[idxClass] == 0) {
+                    /* Most boxes don't overlap at all */
+                    if (!suppressDisjoint && (vcmpneq(inter, 0.0f) & p) == 0) {
                         continue;
                     }
-                    if (CalculateBoxIOU(it->bbox, itc->bbox) > iouThreshold) {
-                        itc->prob[idxClass] = 0;
+
+                    /* No vector divide, finish the overlapping lanes as scalars */
+                    float32x4_t uni = vsubq(vaddq(ai, vldrwq_z_f32(&area[j], p)), inter);
+                    float interLanes[4];
+                    float unionLanes[4];
+                    vst1q(interLanes, inter);
+                    vst1q(unionLanes, uni);
+                    const size_t lanes = std::min<size_t>(4, end - j);
+                    for (size_t k = 0; k < lanes; ++k) {
+                        float iou = 0;
+                        if (interLanes[k] != 0 && unionLanes[k] != 0) {
+                            iou = interLanes[k] / unionLanes[k];
+                        }
+                        if (iou > iouThreshold) {
+                            suppressed[j + k] = 1;
+                        }
+                    }
+                }
+#else
+                for (size_t j = i + 1; j < end; ++j) {
+                    float iou = 0;
+                    float leftest = left[i] > left[j] ? left[i] : left[j];
+                    float rightest = right[i] < right[j] ? right[i] : right[j];
+                    float width = rightest - leftest;
+                    float toppest = top[i] > top[j] ? top[i] : top[j];
+                    float bottomest = bottom[i] < bottom[j] ? bottom[i] : bottom[j];
+                    float height = bottomest - toppest;
+                    if (width >= 0 && height >= 0) {
+                        float inter = width * height;
+                        float uni = area[i] + area[j] - inter;
+                        if (inter != 0 && uni != 0) {
+                            iou = inter / uni;
+                        }
+                    }
+                    if (iou > iouThreshold) {
+                        suppressed[j] = 1;
                     }
                 }
+#endif
+            }
+            begin = end;
+        }
+
+        /* Final order is by score, highest class first, using the scores from
+         * before suppression. */
+        for (uint32_t d = 0; d < count; ++d) {
+            order[d] = d;
+        }
+        if (classes > 0) {
+            std::sort(order, order + count, [&ranksBefore, classes](uint32_t a, uint32_t b) {
+                return ranksBefore(a, b, classes - 1);
+            });
+        }
+
+        for (size_t e = 0; e < numEntries; ++e) {
+            if (suppressed[e]) {
+                dets[entries[e].det].prob[entries[e].cls] = 0;
             }
         }
+
+        Detection* reordered = detections.m_reordered.data();
+        for (size_t d = 0; d < count; ++d) {
+            reordered[d] = dets[order[d]];
+        }
+        std::copy(reordered, reordered + count, dets);
     }
 
     void ConvertImgToInt8(void* data, const size_t kMaxImageSize)
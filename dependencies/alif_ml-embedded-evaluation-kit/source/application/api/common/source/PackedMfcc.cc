@@ -0,0 +1,272 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "PackedMfcc.hpp"
+#include "PlatformMath.hpp"
+#include "log_macros.h"
+
+#include <cfloat>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    static int16_t FloatToQ15(float value)
+    {
+        const float scaled = std::round(value * 32768.0f);
+        return static_cast<int16_t>(std::min<float>(std::max<float>(scaled, INT16_MIN), INT16_MAX));
+    }
+
+    PackedMfcc::PackedMfcc(const MfccParams& params, const MfccPrecision precision):
+        m_params(params),
+        m_precision(precision)
+    {
+        const uint32_t frameLen = this->m_params.m_frameLen;
+        const uint32_t fftLen = this->m_params.m_frameLenPadded;
+
+        /* Same window as MFCC. */
+        this->m_windowFunc = std::vector<float>(frameLen);
+        const auto multiplier = static_cast<float>(2 * M_PI / frameLen);
+        for (size_t i = 0; i < frameLen; i++) {
+            this->m_windowFunc[i] = (0.5 - (0.5 *
+                math::MathUtils::CosineF32(static_cast<float>(i) * multiplier)));
+        }
+
+        this->InitMelFilterBank();
+        this->m_melEnergies = std::vector<float>(this->m_params.m_numFbankBins);
+
+        if (MfccPrecision::Q15 == this->m_precision) {
+            this->m_windowFuncQ15 = std::vector<int16_t>(frameLen);
+            for (size_t i = 0; i < frameLen; i++) {
+                this->m_windowFuncQ15[i] = FloatToQ15(this->m_windowFunc[i]);
+            }
+            this->m_windowFunc.clear();
+            this->m_windowFunc.shrink_to_fit();
+
+            this->m_fbWeightsQ15 = std::vector<int16_t>(this->m_fbWeights.size());
+            for (size_t i = 0; i < this->m_fbWeights.size(); i++) {
+                this->m_fbWeightsQ15[i] = FloatToQ15(this->m_fbWeights[i]);
+            }
+            this->m_fbWeights.clear();
+            this->m_fbWeights.shrink_to_fit();
+
+            this->m_frameQ15 = std::vector<int16_t>(fftLen, 0);
+            this->m_bufferQ15 = std::vector<int16_t>(fftLen * 2, 0);
+            this->m_spectrumQ15 = std::vector<int16_t>(this->m_numSpectrumBins, 0);
+            math::MathUtils::FftInitQ15(fftLen, this->m_fftInstanceQ15);
+        } else {
+            this->m_frame = std::vector<float>(fftLen, 0.0);
+            this->m_buffer = std::vector<float>(fftLen, 0.0);
+            this->m_spectrum = std::vector<float>(this->m_numSpectrumBins, 0.0);
+            math::MathUtils::FftInitF32(fftLen, this->m_fftInstance);
+        }
+
+        this->m_params.Log();
+        debug("\t Packed filterbank weights:  %zu (%s)\n", this->FilterBankSize(),
+              MfccPrecision::Q15 == this->m_precision ? "Q15" : "F32");
+    }
+
+    size_t PackedMfcc::FilterBankSize() const
+    {
+        return this->m_fbOffset.back();
+    }
+
+    void PackedMfcc::InitMelFilterBank()
+    {
+        const uint32_t numBins = this->m_params.m_numFbankBins;
+        const size_t numFftBins = this->m_params.m_frameLenPadded / 2;
+        const float fftBinWidth = static_cast<float>(this->m_params.m_samplingFreq) / this->m_params.m_frameLenPadded;
+        const bool useHtk = this->m_params.m_useHtkMethod;
+
+        const float melLowFreq = MFCC::MelScale(this->m_params.m_melLoFreq, useHtk);
+        const float melHighFreq = MFCC::MelScale(this->m_params.m_melHiFreq, useHtk);
+        const float melFreqDelta = (melHighFreq - melLowFreq) / (numBins + 1);
+
+        this->m_fbFirst = std::vector<uint32_t>(numBins);
+        this->m_fbOffset = std::vector<uint32_t>(numBins + 1);
+        this->m_fbWeights.clear();
+
+        /* Same triangles as MFCC::CreateMelFilterBank, one after another. */
+        for (uint32_t bin = 0; bin < numBins; bin++) {
+            const float leftMel = melLowFreq + bin * melFreqDelta;
+            const float centerMel = melLowFreq + (bin + 1) * melFreqDelta;
+            const float rightMel = melLowFreq + (bin + 2) * melFreqDelta;
+
+            uint32_t firstIndex = 0;
+            uint32_t lastIndex = 0;
+            bool firstIndexFound = false;
+            const size_t offset = this->m_fbWeights.size();
+
+            for (size_t i = 0; i < numFftBins; i++) {
+                const float freq = (fftBinWidth * i);
+                const float mel = MFCC::MelScale(freq, useHtk);
+
+                if (mel > leftMel && mel < rightMel) {
+                    float weight;
+                    if (mel <= centerMel) {
+                        weight = (mel - leftMel) / (centerMel - leftMel);
+                    } else {
+                        weight = (rightMel - mel) / (rightMel - centerMel);
+                    }
+
+                    if (!firstIndexFound) {
+                        firstIndex = i;
+                        firstIndexFound = true;
+                    }
+                    lastIndex = i;
+                    this->m_fbWeights.resize(offset + lastIndex - firstIndex + 1, 0.0f);
+                    this->m_fbWeights.back() = weight;
+                }
+            }
+
+            /* An empty filter still has its one zero weight, as in MFCC */
+            if (!firstIndexFound) {
+                this->m_fbWeights.push_back(0.0f);
+            }
+
+            this->m_fbFirst[bin] = firstIndex;
+            this->m_fbOffset[bin] = offset;
+            this->m_numSpectrumBins = std::max(this->m_numSpectrumBins, lastIndex + 1);
+        }
+        this->m_fbOffset[numBins] = this->m_fbWeights.size();
+        this->m_fbWeights.shrink_to_fit();
+
+        /* Same DCT matrix as MFCC::CreateDCTMatrix. */
+        const uint32_t numFeatures = this->m_params.m_numMfccFeatures;
+        this->m_dctMatrix = std::vector<float>(numBins * numFeatures);
+        const float normalizer = math::MathUtils::SqrtF32(2.0f/numBins);
+        const float angleIncr = M_PI/numBins;
+        float angle = 0;
+
+        for (uint32_t k = 0, m = 0; k < numFeatures; k++, m += numBins) {
+            for (uint32_t n = 0; n < numBins; n++) {
+                this->m_dctMatrix[m+n] = normalizer *
+                    math::MathUtils::CosineF32((n + 0.5f) * angle);
+            }
+            angle += angleIncr;
+        }
+    }
+
+    void PackedMfcc::ComputeSpectrumF32(const int16_t* audioData)
+    {
+        const uint32_t frameLen = this->m_params.m_frameLen;
+
+        /* TensorFlow way of normalizing .wav data to (-1, 1), then window. */
+        constexpr float normaliser = 1.0/(1u<<15u);
+        for (size_t i = 0; i < frameLen; i++) {
+            this->m_frame[i] = static_cast<float>(audioData[i]) * normaliser;
+        }
+        math::MathUtils::VecMultiplyF32(this->m_frame.data(), this->m_windowFunc.data(),
+                                        this->m_frame.data(), frameLen);
+        std::fill(this->m_frame.begin() + frameLen, this->m_frame.end(), 0);
+
+        math::MathUtils::FftF32(this->m_frame, this->m_buffer, this->m_fftInstance);
+
+        /* Magnitudes, only of the bins the filters use. Bin 0 holds the DC
+         * and Nyquist reals, and only DC is wanted. */
+        math::MathUtils::ComplexMagnitudeF32(this->m_buffer.data(), this->m_spectrum.data(),
+                                             this->m_numSpectrumBins);
+        this->m_spectrum[0] = std::fabs(this->m_buffer[0]);
+    }
+
+    void PackedMfcc::ComputeMelEnergiesQ15(const int16_t* audioData)
+    {
+        const uint32_t frameLen = this->m_params.m_frameLen;
+        const uint32_t fftLen = this->m_params.m_frameLenPadded;
+
+        /* Scale the frame up to full range by a power of 2, so the FFT, which
+         * scales down by fftLen, keeps as many bits as it can. */
+        const int16_t maxAbs = math::MathUtils::MaxAbsQ15(audioData, frameLen);
+        int8_t shift = 0;
+        while (maxAbs != 0 && shift < 15 && (static_cast<int32_t>(maxAbs) << (shift + 1)) <= INT16_MAX) {
+            ++shift;
+        }
+
+        int16_t* frame = this->m_frameQ15.data();
+        math::MathUtils::VecShiftQ15(audioData, shift, frame, frameLen);
+        math::MathUtils::VecMultiplyQ15(frame, this->m_windowFuncQ15.data(), frame, frameLen);
+        std::fill(this->m_frameQ15.begin() + frameLen, this->m_frameQ15.end(), 0);
+
+        math::MathUtils::FftQ15(frame, this->m_bufferQ15.data(), this->m_fftInstanceQ15);
+
+        /* Magnitudes in 2.14, bin 0 holds DC only. */
+        int16_t* spectrum = this->m_spectrumQ15.data();
+        math::MathUtils::ComplexMagnitudeQ15(this->m_bufferQ15.data(), spectrum,
+                                             this->m_numSpectrumBins);
+        spectrum[0] = static_cast<int16_t>(std::abs(static_cast<int32_t>(this->m_bufferQ15[0])) >> 1);
+
+        /* 2.14 magnitude x 1.15 weight gives 34.30 (less 1 bit). Undo that,
+         * the FFT's 1/fftLen and the frame's shift in one scale. */
+        const float scale = std::ldexp(static_cast<float>(fftLen), -(29 + shift));
+
+        for (uint32_t bin = 0; bin < this->m_params.m_numFbankBins; ++bin) {
+            const uint32_t offset = this->m_fbOffset[bin];
+            const int64_t acc = math::MathUtils::DotProductQ15(
+                                    spectrum + this->m_fbFirst[bin],
+                                    this->m_fbWeightsQ15.data() + offset,
+                                    this->m_fbOffset[bin + 1] - offset);
+
+            /* Avoid log of zero at later stages */
+            this->m_melEnergies[bin] = static_cast<float>(acc) * scale + FLT_MIN;
+        }
+    }
+
+    void PackedMfcc::ComputeMelEnergies(const int16_t* audioData)
+    {
+        if (MfccPrecision::Q15 == this->m_precision) {
+            this->ComputeMelEnergiesQ15(audioData);
+        } else {
+            this->ComputeSpectrumF32(audioData);
+
+            for (uint32_t bin = 0; bin < this->m_params.m_numFbankBins; ++bin) {
+                const uint32_t offset = this->m_fbOffset[bin];
+                this->m_melEnergies[bin] = math::MathUtils::DotProductF32(
+                                            this->m_spectrum.data() + this->m_fbFirst[bin],
+                                            this->m_fbWeights.data() + offset,
+                                            this->m_fbOffset[bin + 1] - offset) + FLT_MIN;
+            }
+        }
+
+        math::MathUtils::VecLogarithmF32(this->m_melEnergies.data(), this->m_melEnergies.data(),
+                                         this->m_params.m_numFbankBins);
+    }
+
+    float PackedMfcc::Dct(const uint32_t index)
+    {
+        const uint32_t numBins = this->m_params.m_numFbankBins;
+        return math::MathUtils::DotProductF32(this->m_dctMatrix.data() + index * numBins,
+                                              this->m_melEnergies.data(), numBins);
+    }
+
+    void PackedMfcc::MfccCompute(const int16_t* audioData, float* mfccOut)
+    {
+        this->ComputeMelEnergies(audioData);
+
+        for (uint32_t i = 0; i < this->m_params.m_numMfccFeatures; ++i) {
+            mfccOut[i] = this->Dct(i);
+        }
+    }
+
+    std::vector<float> PackedMfcc::MfccCompute(const std::vector<int16_t>& audioData)
+    {
+        std::vector<float> mfccOut(this->m_params.m_numMfccFeatures);
+        this->MfccCompute(audioData.data(), mfccOut.data());
+        return mfccOut;
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
@@ -34,11 +34,17 @@ namespace audio {
         static constexpr bool      ms_defaultUseHtkMethod =  true;
 
         explicit MicroNetKwsMFCC(const size_t numFeats, const size_t frameLen)
-            :  MFCC(MfccParams(
+            :  MFCC(GetParams(numFeats, frameLen))
+        {}
+
+        /** @brief  MicroNet MFCC parameters, also for use with PackedMfcc. */
+        static MfccParams GetParams(const size_t numFeats, const size_t frameLen)
+        {
+            return MfccParams(
                         ms_defaultSamplingFreq, ms_defaultNumFbankBins,
                         ms_defaultMelLoFreq, ms_defaultMelHiFreq,
-                        numFeats, frameLen, ms_defaultUseHtkMethod))
-        {}
+                        numFeats, frameLen, ms_defaultUseHtkMethod);
+        }
         MicroNetKwsMFCC()  = delete;
         ~MicroNetKwsMFCC() = default;
     };
@@ -22,8 +22,6 @@
 #include "YoloFastestModel.hpp"
 #include "BaseProcessing.hpp"
 
-#include <forward_list>
-
 namespace arm {
 namespace app {
 namespace object_detection {
@@ -92,13 +90,7 @@ namespace object_detection {
         std::vector<object_detection::DetectionResult>& m_results;       /* Single inference results. */
         const object_detection::PostProcessParams& m_postProcessParams;  /* Post processing param struct. */
         object_detection::Network m_net;                                 /* YOLO network object. */
-
-        /**
-         * @brief       Insert the given Detection in the list.
-         * @param[in]   detections   List of detections.
-         * @param[in]   det          Detection to be inserted.
-         **/
-        void InsertTopNDetections(std::forward_list<image::Detection>& detections, image::Detection& det);
+        image::DetectionPool m_detections;                               /* Detection boxes, reused each inference. */
 
         /**
          * @brief        Given a Network calculate the detection boxes.
@@ -106,13 +98,13 @@ namespace object_detection {
          * @param[in]    imageWidth    Original image width.
          * @param[in]    imageHeight   Original image height.
          * @param[in]    threshold     Detections threshold.
-         * @param[out]   detections    Detection boxes.
+         * @param[out]   detections    Detection boxes, the top N by objectness if topN is set.
          **/
         void GetNetworkBoxes(object_detection::Network& net,
                              int imageWidth,
                              int imageHeight,
                              float threshold,
-                             std::forward_list<image::Detection>& detections);
+                             image::DetectionPool& detections);
     };
 
 } /* namespace app */
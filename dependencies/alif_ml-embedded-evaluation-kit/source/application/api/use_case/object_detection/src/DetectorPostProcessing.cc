@@ -17,11 +17,20 @@
 #include "DetectorPostProcessing.hpp"
 #include "PlatformMath.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 namespace arm {
 namespace app {
 
+    /* Most boxes the network can produce: every anchor of every cell of both branches. */
+    static size_t MaxDetections(const object_detection::PostProcessParams& params)
+    {
+        const size_t res1 = params.inputImgCols / 32;
+        const size_t res2 = params.inputImgCols / 16;
+        return 3 * (res1 * res1 + res2 * res2);
+    }
+
     DetectorPostProcess::DetectorPostProcess(
         TfLiteTensor* modelOutput0,
         TfLiteTensor* modelOutput1,
@@ -30,7 +39,10 @@ namespace app {
         :   m_outputTensor0{modelOutput0},
             m_outputTensor1{modelOutput1},
             m_results{results},
-            m_postProcessParams{postProcessParams}
+            m_postProcessParams{postProcessParams},
+            m_detections{MaxDetections(postProcessParams),
+                         postProcessParams.numClasses,
+                         static_cast<size_t>(std::max(postProcessParams.topN, 0))}
 {
     /* Init PostProcessing */
     this->m_net = object_detection::Network{
@@ -70,13 +82,13 @@ bool DetectorPostProcess::DoPostProcess()
     int originalImageWidth  = m_postProcessParams.originalImageSize;
     int originalImageHeight = m_postProcessParams.originalImageSize;
 
-    std::forward_list<image::Detection> detections;
-    GetNetworkBoxes(this->m_net, originalImageWidth, originalImageHeight, m_postProcessParams.threshold, detections);
+    this->m_detections.Clear();
+    GetNetworkBoxes(this->m_net, originalImageWidth, originalImageHeight, m_postProcessParams.threshold, this->m_detections);
 
     /* Do nms */
-    CalculateNMS(detections, this->m_net.numClasses, this->m_postProcessParams.nms);
+    CalculateNMS(this->m_detections, this->m_postProcessParams.nms);
 
-    for (auto& it: detections) {
+    for (auto& it: this->m_detections) {
         float xMin = it.bbox.x - it.bbox.w / 2.0f;
         float xMax = it.bbox.x + it.bbox.w / 2.0f;
         float yMin = it.bbox.y - it.bbox.h / 2.0f;
@@ -117,33 +129,14 @@ bool DetectorPostProcess::DoPostProcess()
     return true;
 }
 
-void DetectorPostProcess::InsertTopNDetections(std::forward_list<image::Detection>& detections, image::Detection& det)
-{
-    std::forward_list<image::Detection>::iterator it;
-    std::forward_list<image::Detection>::iterator last_it;
-    for ( it = detections.begin(); it != detections.end(); ++it ) {
-        if(it->objectness > det.objectness)
-            break;
-        last_it = it;
-    }
-    if(it != detections.begin()) {
-        detections.emplace_after(last_it, det);
-        detections.pop_front();
-    }
-}
-
 void DetectorPostProcess::GetNetworkBoxes(
         object_detection::Network& net,
         int imageWidth,
         int imageHeight,
         float threshold,
-        std::forward_list<image::Detection>& detections)
+        image::DetectionPool& detections)
 {
     int numClasses = net.numClasses;
-    int num = 0;
-    auto det_objectness_comparator = [](image::Detection& pa, image::Detection& pb) {
-        return pa.objectness < pb.objectness;
-    };
     for (size_t i = 0; i < net.branches.size(); ++i) {
         int height   = net.branches[i].resolution;
         int width    = net.branches[i].resolution;
@@ -161,8 +154,12 @@ void DetectorPostProcess::GetNetworkBoxes(
                             ) * net.branches[i].scale);
 
                     if(objectness > threshold) {
-                        image::Detection det;
-                        det.objectness = objectness;
+                        /* Only decode it if it makes the top N */
+                        image::Detection* det = detections.Add(objectness);
+                        if (det == nullptr) {
+                            continue;
+                        }
+
                         /* Get bbox prediction data for each anchor, each feature point */
                         int bbox_x_offset = bbox_obj_offset -4;
                         int bbox_y_offset = bbox_x_offset + 1;
@@ -170,57 +167,44 @@ void DetectorPostProcess::GetNetworkBoxes(
                         int bbox_h_offset = bbox_x_offset + 3;
                         int bbox_scores_offset = bbox_x_offset + 5;
 
-                        det.bbox.x = (static_cast<float>(net.branches[i].modelOutput[bbox_x_offset])
+                        det->bbox.x = (static_cast<float>(net.branches[i].modelOutput[bbox_x_offset])
                                 - net.branches[i].zeroPoint) * net.branches[i].scale;
-                        det.bbox.y = (static_cast<float>(net.branches[i].modelOutput[bbox_y_offset])
+                        det->bbox.y = (static_cast<float>(net.branches[i].modelOutput[bbox_y_offset])
                                 - net.branches[i].zeroPoint) * net.branches[i].scale;
-                        det.bbox.w = (static_cast<float>(net.branches[i].modelOutput[bbox_w_offset])
+                        det->bbox.w = (static_cast<float>(net.branches[i].modelOutput[bbox_w_offset])
                                 - net.branches[i].zeroPoint) * net.branches[i].scale;
-                        det.bbox.h = (static_cast<float>(net.branches[i].modelOutput[bbox_h_offset])
+                        det->bbox.h = (static_cast<float>(net.branches[i].modelOutput[bbox_h_offset])
                                 - net.branches[i].zeroPoint) * net.branches[i].scale;
 
                         float bbox_x, bbox_y;
 
                         /* Eliminate grid sensitivity trick involved in YOLOv4 */
-                        bbox_x = math::MathUtils::SigmoidF32(det.bbox.x);
-                        bbox_y = math::MathUtils::SigmoidF32(det.bbox.y);
-                        det.bbox.x = (bbox_x + w) / width;
-                        det.bbox.y = (bbox_y + h) / height;
+                        bbox_x = math::MathUtils::SigmoidF32(det->bbox.x);
+                        bbox_y = math::MathUtils::SigmoidF32(det->bbox.y);
+                        det->bbox.x = (bbox_x + w) / width;
+                        det->bbox.y = (bbox_y + h) / height;
 
-                        det.bbox.w = std::exp(det.bbox.w) * net.branches[i].anchor[anc*2] / net.inputWidth;
-                        det.bbox.h = std::exp(det.bbox.h) * net.branches[i].anchor[anc*2+1] / net.inputHeight;
+                        det->bbox.w = std::exp(det->bbox.w) * net.branches[i].anchor[anc*2] / net.inputWidth;
+                        det->bbox.h = std::exp(det->bbox.h) * net.branches[i].anchor[anc*2+1] / net.inputHeight;
 
                         for (int s = 0; s < numClasses; s++) {
                             float sig = math::MathUtils::SigmoidF32(
                                     (static_cast<float>(net.branches[i].modelOutput[bbox_scores_offset + s]) -
                                     net.branches[i].zeroPoint) * net.branches[i].scale
                                     ) * objectness;
-                            det.prob.emplace_back((sig > threshold) ? sig : 0);
+                            det->prob[s] = (sig > threshold) ? sig : 0;
                         }
 
                         /* Correct_YOLO_boxes */
-                        det.bbox.x *= imageWidth;
-                        det.bbox.w *= imageWidth;
-                        det.bbox.y *= imageHeight;
-                        det.bbox.h *= imageHeight;
-
-                        if (num < net.topN || net.topN <=0) {
-                            detections.emplace_front(det);
-                            num += 1;
-                        } else if (num == net.topN) {
-                            detections.sort(det_objectness_comparator);
-                            InsertTopNDetections(detections, det);
-                            num += 1;
-                        } else {
-                            InsertTopNDetections(detections, det);
-                        }
+                        det->bbox.x *= imageWidth;
+                        det->bbox.w *= imageWidth;
+                        det->bbox.y *= imageHeight;
+                        det->bbox.h *= imageHeight;
                     }
                 }
             }
         }
     }
-    if(num > net.topN)
-        num -=1;
 }
 
 } /* namespace app */
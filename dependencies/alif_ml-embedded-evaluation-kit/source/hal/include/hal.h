@@ -59,6 +59,14 @@ void hal_platform_release(void);
  */
 bool hal_get_user_input(char* user_input, int size);
 
+/**
+ * @brief       Gets one character of user input from the stdin interface,
+ *              if one has arrived, without waiting.
+ * @return      The character, or -1 if there is none (or the platform
+ *              can't check without blocking).
+ */
+int hal_get_user_char(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,8 +40,20 @@
 
 #define hal_get_audio_samples_received() get_audio_samples_received()
 
+#define hal_audio_stream_start(ring, ring_len, slice_len) audio_stream_start(ring, ring_len, slice_len)
+
+#define hal_audio_stream_get_slice()        audio_stream_get_slice()
+
+#define hal_audio_stream_release_slice()    audio_stream_release_slice()
+
+#define hal_audio_stream_stop()             audio_stream_stop()
+
+#define hal_get_audio_stream_overruns()     get_audio_stream_overruns()
+
 #define hal_audio_preprocessing(data, len) audio_preprocessing(data, len)
 
 #define hal_set_audio_gain(gain_db) set_audio_gain(gain_db)
 
+#define hal_get_audio_frontend_cycles(cycles) get_audio_frontend_cycles(cycles)
+
 #endif // HAL_DATA_H
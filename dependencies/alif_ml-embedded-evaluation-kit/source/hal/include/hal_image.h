@@ -26,10 +26,33 @@
  */
 #define hal_image_init()                image_init()
 
+/**
+ * @brief power the camera down between captures, or back up
+ */
+#define hal_image_power(on)             image_power(on)
+
 /**
  * @brief get image data with Hal implementation.
  * @return pointer to RGB image data
  * */
 #define hal_get_image_data(w, h)   get_image_data(w, h)
 
+/**
+ * @brief start/stop double-buffered capture, where the sensor fills the
+ * next frame while the current one is processed.
+ */
+#define hal_image_pipeline_start()              image_pipeline_start()
+#define hal_image_pipeline_stop()               image_pipeline_stop()
+
+/**
+ * @brief get the next frame from the capture pipeline.
+ * @return pointer to RGB image data, valid until the next capture call
+ * */
+#define hal_get_image_data_pipelined(w, h)      get_image_data_pipelined(w, h)
+
+/**
+ * @brief get per-stage cycle counts for the most recent frame
+ */
+#define hal_get_image_stage_cycles(c)           get_image_stage_cycles(c)
+
 #endif // HAL_IMAGE_H
@@ -20,6 +20,15 @@
  */
 typedef void (*audio_callback_t)(uint32_t data);
 
+/**
+ * CPU cycles spent in the audio front end
+ */
+typedef struct {
+    uint32_t copy;          /* receive interrupt: stereo->mono, DC removal (and gain for q15) */
+    uint32_t preprocessing; /* foreground: AGC and conversion to q15 */
+    uint32_t samples;       /* samples these cycles were spent on */
+} audio_frontend_cycles_t;
+
 int audio_init(int sampling_rate, int wlen);
 
 /* Call is asynchronous - use wait call, audio_get_samples_received or callback to monitor progress. Data is not valid until preprocessing is run */
@@ -33,6 +42,24 @@ int get_audio_samples_received(void);
 /* Returns error indication - 0 for success */
 int wait_for_audio(void);
 
+/* Continuous capture into a ring of ring_len samples, made of whole slices of
+ * slice_len samples. Receive is never stopped between slices; the callback is
+ * called from the interrupt each time a slice becomes ready. Returns 0 for success */
+int audio_stream_start(int16_t *ring, int ring_len, int slice_len);
+
+/* Blocks until the next slice is ready and returns it, or NULL on error. Data is
+ * not valid until preprocessing is run on it */
+int16_t *audio_stream_get_slice(void);
+
+/* Hands the slice returned by audio_stream_get_slice back to the receiver */
+void audio_stream_release_slice(void);
+
+/* Stops continuous capture after the block in flight */
+void audio_stream_stop(void);
+
+/* Returns the number of samples dropped since audio_stream_start because the ring was full */
+uint32_t get_audio_stream_overruns(void);
+
 /* Separate foreground preprocessing stage - as it will likely be slow, initiate
  * the next asynchronous get into a separate buffer before running on the previous one. */
 void audio_preprocessing(int16_t *data, int len);
@@ -40,4 +67,7 @@ void audio_preprocessing(int16_t *data, int len);
 /* Set fixed microphone gain */
 void set_audio_gain(float gain_db);
 
+/* Returns the front end cycles since the previous call, and resets them */
+void get_audio_frontend_cycles(audio_frontend_cycles_t *cycles);
+
 #endif // AUDIO_DATA_H
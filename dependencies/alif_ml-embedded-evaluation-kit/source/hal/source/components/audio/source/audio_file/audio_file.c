@@ -0,0 +1,240 @@
+/* Copyright (C) 2023 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ *
+ */
+
+// File backed microphone for the native platform.
+//
+// Samples are read from the file named by the EI_NATIVE_AUDIO_FILE environment
+// variable: a 16 bit mono PCM WAV, or headerless 16 bit little endian mono
+// samples. The file loops at the end. Data is returned as soon as it is asked
+// for, without real time pacing, so runs are repeatable and only limited by the
+// CPU. The file is expected to hold clean samples, so preprocessing does nothing.
+
+#include "audio_data.h"
+#include "log_macros.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define AUDIO_FILE_ENV "EI_NATIVE_AUDIO_FILE"
+
+static FILE *audio_file = NULL;
+static long audio_data_start;
+static audio_callback_t user_audio_callback = NULL;
+static int audio_received;
+
+static int16_t *stream_ring = NULL;
+static int stream_ring_len;
+static int stream_slice_len;
+static int stream_read_pos;
+
+static uint32_t read_le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t read_le16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+/* Finds the data chunk of a WAV file, or leaves a headerless file at 0 */
+static int find_audio_data(FILE *f, int sampling_rate)
+{
+    uint8_t hdr[12];
+
+    if (fread(hdr, 1, sizeof(hdr), f) != sizeof(hdr) ||
+        memcmp(hdr, "RIFF", 4) != 0 || memcmp(hdr + 8, "WAVE", 4) != 0) {
+        audio_data_start = 0;
+        return fseek(f, 0, SEEK_SET);
+    }
+
+    for (;;) {
+        uint8_t chunk[8];
+        if (fread(chunk, 1, sizeof(chunk), f) != sizeof(chunk)) {
+            printf_err("%s: no data chunk\n", AUDIO_FILE_ENV);
+            return -1;
+        }
+        uint32_t size = read_le32(chunk + 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            if (size < sizeof(fmt) || fread(fmt, 1, sizeof(fmt), f) != sizeof(fmt)) {
+                printf_err("%s: bad fmt chunk\n", AUDIO_FILE_ENV);
+                return -1;
+            }
+            if (read_le16(fmt) != 1 || read_le16(fmt + 2) != 1 || read_le16(fmt + 14) != 16) {
+                printf_err("%s: only 16 bit mono PCM is supported\n", AUDIO_FILE_ENV);
+                return -1;
+            }
+            if ((int)read_le32(fmt + 4) != sampling_rate) {
+                printf_err("%s: sampled at %u Hz, expected %d Hz\n",
+                    AUDIO_FILE_ENV, (unsigned)read_le32(fmt + 4), sampling_rate);
+                return -1;
+            }
+            size -= sizeof(fmt);
+        }
+        else if (memcmp(chunk, "data", 4) == 0) {
+            audio_data_start = ftell(f);
+            return 0;
+        }
+
+        // chunks are padded to an even size
+        if (fseek(f, (long)size + (size & 1), SEEK_CUR) != 0) {
+            printf_err("%s: truncated file\n", AUDIO_FILE_ENV);
+            return -1;
+        }
+    }
+}
+
+/* Reads len samples, looping at the end of the file */
+static int read_samples(int16_t *data, int len)
+{
+    int rewound = 0;
+
+    if (audio_file == NULL) {
+        return -1;
+    }
+
+    while (len > 0) {
+        size_t n = fread(data, sizeof(int16_t), len, audio_file);
+        data += n;
+        len -= n;
+        if (len > 0) {
+            // an empty file would loop for ever
+            if (n == 0 && rewound) {
+                return -1;
+            }
+            fseek(audio_file, audio_data_start, SEEK_SET);
+            rewound = 1;
+        }
+    }
+
+    return 0;
+}
+
+int audio_init(int sampling_rate, int wlen)
+{
+    (void) wlen;
+
+    const char *path = getenv(AUDIO_FILE_ENV);
+    if (path == NULL) {
+        warn("Set %s to a WAV file to use the microphone\n", AUDIO_FILE_ENV);
+        return -1;
+    }
+
+    if (audio_file) {
+        fclose(audio_file);
+    }
+    audio_file = fopen(path, "rb");
+    if (audio_file == NULL) {
+        printf_err("Can't open %s\n", path);
+        return -1;
+    }
+
+    if (find_audio_data(audio_file, sampling_rate) != 0) {
+        fclose(audio_file);
+        audio_file = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+void audio_set_callback(audio_callback_t cb)
+{
+    user_audio_callback = cb;
+}
+
+int get_audio_samples_received(void)
+{
+    return audio_received;
+}
+
+int get_audio_data(int16_t *data, int len)
+{
+    int err = read_samples(data, len);
+
+    audio_received = err ? 0 : len;
+    if (user_audio_callback) {
+        user_audio_callback(err);
+    }
+    return err;
+}
+
+int wait_for_audio(void)
+{
+    return audio_file ? 0 : -1;
+}
+
+int audio_stream_start(int16_t *ring, int ring_len, int slice_len)
+{
+    if (stream_ring != NULL || slice_len <= 0 || ring_len % slice_len != 0) {
+        return -1;
+    }
+
+    stream_ring = ring;
+    stream_ring_len = ring_len;
+    stream_slice_len = slice_len;
+    stream_read_pos = 0;
+
+    return audio_file ? 0 : -1;
+}
+
+int16_t *audio_stream_get_slice(void)
+{
+    if (stream_ring == NULL) {
+        return NULL;
+    }
+
+    int16_t *slice = stream_ring + stream_read_pos;
+    if (read_samples(slice, stream_slice_len) != 0) {
+        return NULL;
+    }
+    if (user_audio_callback) {
+        user_audio_callback(0);
+    }
+    return slice;
+}
+
+void audio_stream_release_slice(void)
+{
+    stream_read_pos += stream_slice_len;
+    if (stream_read_pos == stream_ring_len) {
+        stream_read_pos = 0;
+    }
+}
+
+void audio_stream_stop(void)
+{
+    stream_ring = NULL;
+}
+
+uint32_t get_audio_stream_overruns(void)
+{
+    return 0;
+}
+
+void audio_preprocessing(int16_t *data, int len)
+{
+    (void) data;
+    (void) len;
+}
+
+void set_audio_gain(float gain_db)
+{
+    (void) gain_db;
+}
+
+void get_audio_frontend_cycles(audio_frontend_cycles_t *cycles)
+{
+    memset(cycles, 0, sizeof(*cycles));
+}
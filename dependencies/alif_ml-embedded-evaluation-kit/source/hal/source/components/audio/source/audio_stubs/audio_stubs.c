@@ -38,6 +38,32 @@ int wait_for_audio(void)
     return -1;
 }
 
+int audio_stream_start(int16_t *ring, int ring_len, int slice_len)
+{
+    (void) ring;
+    (void) ring_len;
+    (void) slice_len;
+    return -1;
+}
+
+int16_t *audio_stream_get_slice(void)
+{
+    return NULL;
+}
+
+void audio_stream_release_slice(void)
+{
+}
+
+void audio_stream_stop(void)
+{
+}
+
+uint32_t get_audio_stream_overruns(void)
+{
+    return 0;
+}
+
 void audio_preprocessing(int16_t *data, int len)
 {
     (void) data;
@@ -48,3 +74,8 @@ void set_audio_gain(float gain_db)
 {
     (void) gain_db;
 }
+
+void get_audio_frontend_cycles(audio_frontend_cycles_t *cycles)
+{
+    memset(cycles, 0, sizeof(*cycles));
+}
@@ -28,6 +28,10 @@
 #define ENABLE_MVE_COPY_AUDIO_REC_TO_IN 0
 #endif
 
+#ifndef AUDIO_Q15_FRONTEND
+#define AUDIO_Q15_FRONTEND 0
+#endif
+
 #define AUDIO_REC_SAMPLES 512
 
 #define AUDIO_L_ONLY 1
@@ -42,7 +46,9 @@
 
 //#define STORE_AUDIO
 
+#if !AUDIO_Q15_FRONTEND
 static void copy_audio_rec_to_in(float16_t * __RESTRICT in, const int32_t * __RESTRICT rec, int samples);
+#endif
 
 // 24-bit stereo record buffer
 static int32_t audio_rec[2][AUDIO_REC_SAMPLES * 2] __ALIGNED(32) __attribute__((section(".bss.audio_rec"))); // stereo record buffer
@@ -59,14 +65,40 @@ static audio_callback_t user_audio_callback =  NULL;
 static int audio_current_rec_buf;
 
 static int32_t current_dc = 0;
+#if !AUDIO_Q15_FRONTEND
 static float current_gain = MAX_GAIN;
+#endif
 static bool auto_gain = true;
 
+#if AUDIO_Q15_FRONTEND
+// Gain in Q16.16. Microphone data is full scale int32, so q15 out = (mono * gain) >> 32
+#define GAIN_Q16(g) ((int32_t)((g) * 65536.0f))
+static int32_t current_gain_q16 = GAIN_Q16(MAX_GAIN);
+// Largest pre-gain magnitude since the last preprocessing, for the AGC
+static atomic_uint audio_absmax;
+#endif
+
+static audio_frontend_cycles_t frontend_cycles;
+
 static int16_t * restrict user_ptr;
 static int user_length;
 static atomic_int audio_received;
 static atomic_int audio_async_error;
 
+// Streaming mode: receive never stops, and each block is appended to a ring of whole slices
+#define STREAM_OFF      0
+#define STREAM_RUNNING  1
+#define STREAM_STOPPING 2
+
+static atomic_int stream_state;
+static int16_t * restrict stream_ring;
+static int stream_ring_len;
+static int stream_slice_len;
+static int stream_write_pos;
+static int stream_read_pos;
+static atomic_int stream_count;         // samples in the ring not yet released
+static atomic_uint stream_overruns;     // samples dropped because the ring was full
+
 
 static void audio_start_next_rx(int data_to_go)
 {
@@ -79,6 +111,7 @@ static void audio_start_next_rx(int data_to_go)
     }
 }
 
+#if !AUDIO_Q15_FRONTEND
 // Perform stereo->mono conversion and DC adjustment as we copy
 // Gain will be handled later. Note that we use 32-bit input -
 // the microphone provides 18 bits of precision. Using 24-bit
@@ -154,11 +187,140 @@ static void copy_audio_rec_to_in(float16_t * __RESTRICT in, const int32_t * __RE
     int32_t mean = (int32_t) (sum / len);
     current_dc = (current_dc / 8) * 7 + mean / 8;
 }
+#endif
+
+#if AUDIO_Q15_FRONTEND
+// Fixed point alternative to copy_audio_rec_to_in: stereo->mono, DC adjustment
+// and gain straight to q15, with no float16 intermediate. Gain is applied before
+// reducing to 16 bits, so quiet input keeps the microphone's full precision.
+static void copy_audio_rec_to_q15(int16_t * __RESTRICT out, const int32_t * __RESTRICT rec, int len)
+{
+    const int32_t *input = rec;
+    int16_t *output = out;
+    const int32_t offset = current_dc;
+    const int32_t gain = current_gain_q16;
+    int64_t sum = 0;
+    uint32_t absmax = 0;
+    int samples_to_go = len;
+    while (samples_to_go >= 4 && ENABLE_MVE_COPY_AUDIO_REC_TO_IN) {
+        // Deinterleave 4 sets of L/R
+        int32x4x2_t stereo = vld2q(input);
+#if AUDIO_MICS == AUDIO_LR_MIX
+        int32x4_t mono = vrhaddq(stereo.val[0], stereo.val[1]);
+#elif AUDIO_MICS == AUDIO_L_ONLY
+        int32x4_t mono = stereo.val[0];
+#elif AUDIO_MICS == AUDIO_R_ONLY
+        int32x4_t mono = stereo.val[1];
+#else
+#error "which microphone?"
+#endif
+        sum = vaddlvaq(sum, mono);
+        mono = vqsubq(mono, offset);
+        absmax = vmaxavq(absmax, mono);
+        // High half of the 64-bit product is the q15 result, then saturate to 16 bits
+        int32x4_t q = vmulhq(mono, vdupq_n_s32(gain));
+        q = vminq(vmaxq(q, vdupq_n_s32(INT16_MIN)), vdupq_n_s32(INT16_MAX));
+        vstrhq_s32(output, q);
+        input += 8;
+        output += 4;
+        samples_to_go -= 4;
+    }
+    while (samples_to_go > 0) {
+#if AUDIO_MICS == AUDIO_LR_MIX
+        int32_t mono = srshr(input[0], 1) + (input[1] >> 1);
+#elif AUDIO_MICS == AUDIO_L_ONLY
+        int32_t mono = input[0];
+#elif AUDIO_MICS == AUDIO_R_ONLY
+        int32_t mono = input[1];
+#else
+#error "which microphone?"
+#endif
+        sum += mono;
+        mono = __QSUB(mono, offset);
+        uint32_t mag = mono < 0 ? -(uint32_t) mono : (uint32_t) mono;
+        if (mag > absmax) {
+            absmax = mag;
+        }
+        *output++ = (int16_t) __SSAT((int32_t) (((int64_t) mono * gain) >> 32), 16);
+        input += 2;
+        samples_to_go -= 1;
+    }
+    int32_t mean = (int32_t) (sum / len);
+    current_dc = (current_dc / 8) * 7 + mean / 8;
+
+    // AGC attack: if this block clipped, reduce the gain for the next one straight away
+    if (auto_gain && absmax != 0 && (((int64_t) absmax * gain) >> 32) > INT16_MAX) {
+        current_gain_q16 = (int32_t) (((int64_t) INT16_MAX << 32) / absmax);
+    }
+    if (absmax > audio_absmax) {
+        audio_absmax = absmax;
+    }
+}
+#endif
+
+static void copy_audio_rec(int16_t * __RESTRICT in, const int32_t * __RESTRICT rec, int samples)
+{
+    uint32_t start = ARM_PMU_Get_CCNTR();
+#if AUDIO_Q15_FRONTEND
+    copy_audio_rec_to_q15(in, rec, samples);
+#else
+    copy_audio_rec_to_in((float16_t *) in, rec, samples);
+#endif
+    frontend_cycles.copy += ARM_PMU_Get_CCNTR() - start;
+    frontend_cycles.samples += samples;
+}
+
+static void stream_data_cb(void)
+{
+    if (stream_state == STREAM_STOPPING) {
+        // don't restart receive, let audio_stream_stop return
+        stream_state = STREAM_OFF;
+        return;
+    }
+
+    // restart receive into the other buffer first, so no samples are missed
+    audio_start_next_rx(AUDIO_REC_SAMPLES);
+
+    const int32_t *rec = audio_rec[!audio_current_rec_buf];
+    if (stream_count + AUDIO_REC_SAMPLES > stream_ring_len) {
+        // consumer is too slow: drop this block rather than corrupt unreleased slices
+        stream_overruns += AUDIO_REC_SAMPLES;
+    } else {
+        int first = stream_ring_len - stream_write_pos;
+        if (first > AUDIO_REC_SAMPLES) {
+            first = AUDIO_REC_SAMPLES;
+        }
+        copy_audio_rec(stream_ring + stream_write_pos, rec, first);
+        if (first < AUDIO_REC_SAMPLES) {
+            copy_audio_rec(stream_ring, rec + 2 * first, AUDIO_REC_SAMPLES - first);
+        }
+        stream_write_pos = (stream_write_pos + AUDIO_REC_SAMPLES) % stream_ring_len;
+
+        int count = atomic_fetch_add(&stream_count, AUDIO_REC_SAMPLES) + AUDIO_REC_SAMPLES;
+        if (count >= stream_slice_len && count - AUDIO_REC_SAMPLES < stream_slice_len) {
+            // a slice just became ready
+            if (user_audio_callback) {
+                user_audio_callback(0);
+            }
+        }
+    }
+
+    if (audio_async_error) {
+        stream_state = STREAM_OFF;
+        if (user_audio_callback) {
+            user_audio_callback(audio_async_error);
+        }
+    }
+}
 
 static void voice_data_cb(uint32_t event)
 {
     (void) event;
     audio_current_rec_buf = !audio_current_rec_buf;
+    if (stream_state != STREAM_OFF) {
+        stream_data_cb();
+        return;
+    }
     int samples = AUDIO_REC_SAMPLES;
     int new_total = audio_received + AUDIO_REC_SAMPLES;
     if (new_total < user_length) {
@@ -173,7 +335,7 @@ static void voice_data_cb(uint32_t event)
         store_pos += 2 * samples;
     }
 #endif
-    copy_audio_rec_to_in((float16_t *) user_ptr + audio_received, audio_rec[!audio_current_rec_buf], samples);
+    copy_audio_rec(user_ptr + audio_received, audio_rec[!audio_current_rec_buf], samples);
     audio_received = new_total;
     if (audio_received >= user_length || audio_async_error) {
         if (user_audio_callback) {
@@ -223,6 +385,69 @@ int wait_for_audio(void)
     return audio_async_error;
 }
 
+int audio_stream_start(int16_t *ring, int ring_len, int slice_len)
+{
+    if (stream_state != STREAM_OFF || slice_len <= 0 || ring_len % slice_len != 0 ||
+        ring_len < slice_len + AUDIO_REC_SAMPLES) {
+        return -1;
+    }
+
+    stream_ring = ring;
+    stream_ring_len = ring_len;
+    stream_slice_len = slice_len;
+    stream_write_pos = 0;
+    stream_read_pos = 0;
+    stream_count = 0;
+    stream_overruns = 0;
+    audio_async_error = 0;
+    stream_state = STREAM_RUNNING;
+
+    audio_start_next_rx(AUDIO_REC_SAMPLES);
+    if (audio_async_error) {
+        stream_state = STREAM_OFF;
+    }
+
+    return audio_async_error;
+}
+
+int16_t *audio_stream_get_slice(void)
+{
+    while (stream_count < stream_slice_len) {
+        if (stream_state != STREAM_RUNNING || audio_async_error) {
+            return NULL;
+        }
+        __WFE();
+    }
+    return stream_ring + stream_read_pos;
+}
+
+void audio_stream_release_slice(void)
+{
+    stream_read_pos += stream_slice_len;
+    if (stream_read_pos == stream_ring_len) {
+        stream_read_pos = 0;
+    }
+    atomic_fetch_sub(&stream_count, stream_slice_len);
+}
+
+void audio_stream_stop(void)
+{
+    int expected = STREAM_RUNNING;
+    if (atomic_compare_exchange_strong(&stream_state, &expected, STREAM_STOPPING)) {
+        // wait for the block in flight, which won't be restarted
+        while (stream_state == STREAM_STOPPING && audio_async_error == 0) {
+            __WFE();
+        }
+    }
+    stream_state = STREAM_OFF;
+}
+
+uint32_t get_audio_stream_overruns(void)
+{
+    return stream_overruns;
+}
+
+#if !AUDIO_Q15_FRONTEND
 static void convert_to_s16_from_f16_with_gain(void *ptr, int length, float16_t gain)
 {
     while (length > 0) {
@@ -240,6 +465,7 @@ static void convert_to_s16_from_f16_with_gain(void *ptr, int length, float16_t g
         length -= 8;
     }
 }
+#endif
 
 
 void set_audio_gain(float gain_db)
@@ -248,24 +474,70 @@ void set_audio_gain(float gain_db)
         auto_gain = true;
     } else {
         auto_gain = false;
+#if AUDIO_Q15_FRONTEND
+        current_gain_q16 = GAIN_Q16(fmin(gain_db, MAX_GAIN));
+#else
         current_gain = gain_db;
+#endif
     }
 }
 
+void get_audio_frontend_cycles(audio_frontend_cycles_t *cycles)
+{
+    __disable_irq();
+    *cycles = frontend_cycles;
+    frontend_cycles = (audio_frontend_cycles_t) { 0 };
+    __enable_irq();
+}
 
+#if AUDIO_Q15_FRONTEND
+/* The input is already q15 with gain applied as it arrived, so this only
+ * adjusts the gain for the following samples, to the gain that would have
+ * put this slice's peak at full scale. That is a cut straight away if the
+ * peak was above it, and at most 1 dB of boost if it was below. The receive
+ * interrupt also cuts it at once on clipping, without waiting for a slice.
+ */
+void audio_preprocessing(int16_t *audio, int samples)
+{
+    uint32_t start = ARM_PMU_Get_CCNTR();
+
+    uint32_t absmax = atomic_exchange(&audio_absmax, 0);
+    if (auto_gain && absmax != 0) {
+        int64_t new_gain = ((int64_t) INT16_MAX << 32) / absmax;
+        int64_t inc_gain = ((int64_t) current_gain_q16 * GAIN_Q16(MAX_GAIN_INC_PER_STRIDE)) >> 16;
+        if (new_gain > GAIN_Q16(MAX_GAIN)) {
+            new_gain = GAIN_Q16(MAX_GAIN);
+        }
+        current_gain_q16 = (int32_t) (new_gain < inc_gain ? new_gain : inc_gain);
+    }
+
+    q15_t audio_mean_q15, audio_absmax_q15;
+    arm_mean_q15(audio, samples, &audio_mean_q15);
+    arm_absmax_no_idx_q15(audio, samples, &audio_absmax_q15);
+    if (audio_absmax_q15 == INT16_MIN) audio_absmax_q15 = INT16_MAX; // CMSIS-DSP issue #66
+
+    frontend_cycles.preprocessing += ARM_PMU_Get_CCNTR() - start;
+
+    printf("Normalized sample stats: absmax = %d, mean = %d (gain = %.0f dB)\n", audio_absmax_q15, audio_mean_q15, 20 * log10f(current_gain_q16 * 0x1p-16f) );
+}
+#else
 /* Reads the input in float16 format
  * Adjusts gain up or down, attempting to get full-scale input
  * Applies
  */
 void audio_preprocessing(int16_t *audio, int samples)
 {
+    uint32_t start = ARM_PMU_Get_CCNTR();
+
     float16_t *audio_fp = (float16_t *) audio;
     float16_t audio_mean, audio_absmax;
 
     arm_mean_f16(audio_fp, samples, &audio_mean);
     arm_absmax_no_idx_f16(audio_fp, samples, &audio_absmax);
     //if (audio_absmax == INT16_MIN) audio_absmax = INT16_MAX; // CMSIS-DSP issue #66
+    uint32_t print_start = ARM_PMU_Get_CCNTR();
     printf("Original sample stats: absmax = %ld, mean = %ld\n", lround(32768*audio_absmax), lround(32768*audio_mean));
+    start += ARM_PMU_Get_CCNTR() - print_start;
 
     if (auto_gain) {
         // Rescale to full range  while converting to integer
@@ -279,5 +551,9 @@ void audio_preprocessing(int16_t *audio, int samples)
     arm_mean_q15(audio, samples, &audio_mean_q15);
     arm_absmax_no_idx_q15(audio, samples, &audio_absmax_q15);
     if (audio_absmax_q15 == INT16_MIN) audio_absmax_q15 = INT16_MAX; // CMSIS-DSP issue #66
+
+    frontend_cycles.preprocessing += ARM_PMU_Get_CCNTR() - start;
+
     printf("Normalized sample stats: absmax = %d, mean = %d (gain = %.0f dB)\n", audio_absmax_q15, audio_mean_q15, 20 * log10f(current_gain) );
 }
+#endif
@@ -15,10 +15,37 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+/* Cycle counts of the stages that produced the most recent frame */
+typedef struct {
+    uint32_t capture_wait;      /* Time spent blocked waiting for the sensor */
+    uint32_t demosaic;
+    uint32_t crop;
+    uint32_t resize;
+    uint32_t white_balance;
+} image_stage_cycles_t;
+
 int image_init(void);
 
+/*
+ * Power the camera down while it's not needed, and back up before the next
+ * capture. Stop the capture pipeline first.
+ */
+int image_power(bool on);
+
 const uint8_t *get_image_data(int width, int height);
 
+/*
+ * Pipelined capture: while the returned frame is being processed, the sensor
+ * is already filling the next one into a second buffer. The returned RGB
+ * buffer is owned by the caller until the next call to
+ * get_image_data_pipelined, get_image_data or image_pipeline_stop.
+ */
+int image_pipeline_start(void);
+const uint8_t *get_image_data_pipelined(int width, int height);
+void image_pipeline_stop(void);
+
+void get_image_stage_cycles(image_stage_cycles_t *cycles);
+
 float get_image_gain(void);
 
 
@@ -21,8 +21,19 @@
 #include <tgmath.h>
 #include <string.h>
 
+#ifndef CAMERA_FUSED_DEMOSAIC
+#define CAMERA_FUSED_DEMOSAIC 0
+#endif
+
+#if CAMERA_FUSED_DEMOSAIC
+// Demosaic, scaling and colour correction are one pass from the Bayer frame to the output,
+// so there is no full resolution RGB frame and the Bayer buffer isn't needed as scratch.
+static uint8_t rgb_image[CIMAGE_OUT_MAX_X*CIMAGE_OUT_MAX_Y*RGB_BYTES] __attribute__((section(".bss.camera_frame_bayer_to_rgb_buf")));  // 480x480x3 = 691,200
+static uint8_t raw_image[CIMAGE_X*CIMAGE_Y + 0x460] __attribute__((aligned(32),section(".bss.camera_frame_buf")));   // 560x560 = 313,600
+#else
 static uint8_t rgb_image[CIMAGE_X*CIMAGE_Y*RGB_BYTES] __attribute__((section(".bss.camera_frame_bayer_to_rgb_buf")));      // 560x560x3 = 940,800
 static uint8_t raw_image[CIMAGE_X*CIMAGE_Y*RGB_BYTES + 0x460] __attribute__((aligned(32),section(".bss.camera_frame_buf")));   // 560x560x3 = 940,800
+#endif
 
 extern ARM_DRIVER_GPIO Driver_GPIO1;
 
@@ -152,28 +163,51 @@ static void process_autogain(void)
     }
 }
 
+int image_power(bool on)
+{
+    if (!on) {
+        image_pipeline_stop();
+    }
+
+    int32_t err = camera_power(on);
+    if (err != 0) {
+        printf_err("camera_power(%d) returned error %" PRId32 "\n", on, err);
+        return err;
+    }
+
+    // The sensor comes back up with its default gain
+    if (on && current_api_gain > 0) {
+        int32_t ret = camera_gain(current_api_gain);
+        if (ret < 0) {
+            printf_err("Camera gain error %" PRId32 "\n", ret);
+        }
+        else {
+            current_api_gain = ret;
+        }
+    }
+
+    return 0;
+}
+
 #define FAKE_CAMERA 0
 
-const uint8_t *get_image_data(int ml_width, int ml_height)
-{
-    extern uint32_t tprof1, tprof2, tprof3, tprof4, tprof5;
+// Second Bayer buffer for pipelined capture. It takes the same role as raw_image
+// (including crop/resize scratch when not fused), so it must be the same size.
+static uint8_t raw_image_alt[sizeof raw_image] __attribute__((aligned(32),section(".bss.camera_frame_buf")));
 
-#if !FAKE_CAMERA
-    camera_start(CAMERA_MODE_SNAPSHOT);
-    // It's a huge buffer (941920 bytes) - actually doing it by address can take 0.5ms, while
-    // a global clean+invalidate is 0.023ms. (Although there will be a reload cost
-    // on stuff we lost).
-    // Notably, just invalidate is faster at 0.015ms, but we'd have to be sure
-    // there were no writeback cacheable areas.
-    // From that Breakeven point for ranged invalidate time = global clean+invalidate would be 43Kbyte.
-    // So maybe go to global if >128K, considering cost of refills?
-    //SCB_InvalidateDCache_by_Addr(raw_image, sizeof raw_image);
-    SCB_CleanInvalidateDCache();
-    camera_wait(100);
-#else
+static uint8_t * const frame_buffers[2] = { raw_image, raw_image_alt };
+
+// Index of the buffer currently owned by the CPI, or -1 if no capture is in flight
+static int capture_index = -1;
+
+static image_stage_cycles_t stage_cycles;
+
+#if FAKE_CAMERA
+static void fake_capture(uint8_t *frame)
+{
     static int roll = 0;
     for (int y = 0; y < CIMAGE_Y; y+=2) {
-    	uint8_t *p = raw_image + y * CIMAGE_X;
+    	uint8_t *p = frame + y * CIMAGE_X;
     	int bar = (7 * ((y+roll) % CIMAGE_Y)) / CIMAGE_Y + 1;
     	float barb = bar & 1 ? 255 : 0;
     	float barr = bar & 2 ? 255 : 0;
@@ -189,18 +223,137 @@ const uint8_t *get_image_data(int ml_width, int ml_height)
     	}
     }
     roll = (roll + 1) % CIMAGE_Y;
+}
 #endif
+
+/* Demosaic, crop, scale and colour correct a captured Bayer frame into rgb_image.
+ * The Bayer buffer may be used as scratch space, so it must be owned by the CPU.
+ */
+static const uint8_t *process_frame(uint8_t *frame, int ml_width, int ml_height)
+{
+    extern uint32_t tprof1, tprof2, tprof3, tprof4, tprof5;
+
+#if CAMERA_FUSED_DEMOSAIC
+    if (ml_width * ml_height > CIMAGE_OUT_MAX_X * CIMAGE_OUT_MAX_Y) {
+        printf_err("Image size %dx%d too large\n", ml_width, ml_height);
+        return NULL;
+    }
+
+    tprof1 = ARM_PMU_Get_CCNTR();
+    int err = bayer_to_RGB_scaled(frame, rgb_image, ml_width, ml_height);
+    tprof1 = ARM_PMU_Get_CCNTR() - tprof1;
+    if (err < 0) {
+        printf_err("Demosaic to %dx%d failed (%d), dropping frame\n", ml_width, ml_height, err);
+        return NULL;
+    }
+    tprof2 = tprof3 = tprof4 = 0;
+    // Use pixel analysis from bayer_to_RGB_scaled to adjust gain
+    process_autogain();
+#else
     tprof1 = ARM_PMU_Get_CCNTR();
     // RGB conversion and frame resize
-    bayer_to_RGB(raw_image, rgb_image);
+    bayer_to_RGB(frame, rgb_image);
     tprof1 = ARM_PMU_Get_CCNTR() - tprof1;
     // Use pixel analysis from bayer_to_RGB to adjust gain
     process_autogain();
     // Cropping and scaling
-    crop_and_interpolate(rgb_image, CIMAGE_X, CIMAGE_Y, raw_image, ml_width, ml_height, RGB_BYTES * 8);
+    crop_and_interpolate(rgb_image, CIMAGE_X, CIMAGE_Y, frame, ml_width, ml_height, RGB_BYTES * 8);
     tprof4 = ARM_PMU_Get_CCNTR();
     // Color correction for white balance
-    white_balance(ml_width, ml_height, raw_image, rgb_image);
+    white_balance(ml_width, ml_height, frame, rgb_image);
     tprof4 = ARM_PMU_Get_CCNTR() - tprof4;
+#endif
+
+    stage_cycles.demosaic = tprof1;
+    stage_cycles.crop = tprof2;
+    stage_cycles.resize = tprof3;
+    stage_cycles.white_balance = tprof4;
+
     return rgb_image;
 }
+
+const uint8_t *get_image_data(int ml_width, int ml_height)
+{
+    // Single-shot capture uses raw_image, which the pipeline may be filling
+    image_pipeline_stop();
+
+    uint32_t start = ARM_PMU_Get_CCNTR();
+#if !FAKE_CAMERA
+    camera_start(CAMERA_MODE_SNAPSHOT);
+    // It's a huge buffer (941920 bytes) - actually doing it by address can take 0.5ms, while
+    // a global clean+invalidate is 0.023ms. (Although there will be a reload cost
+    // on stuff we lost).
+    // Notably, just invalidate is faster at 0.015ms, but we'd have to be sure
+    // there were no writeback cacheable areas.
+    // From that Breakeven point for ranged invalidate time = global clean+invalidate would be 43Kbyte.
+    // So maybe go to global if >128K, considering cost of refills?
+    //SCB_InvalidateDCache_by_Addr(raw_image, sizeof raw_image);
+    SCB_CleanInvalidateDCache();
+    camera_wait(100);
+#else
+    fake_capture(raw_image);
+#endif
+    stage_cycles.capture_wait = ARM_PMU_Get_CCNTR() - start;
+
+    return process_frame(raw_image, ml_width, ml_height);
+}
+
+int image_pipeline_start(void)
+{
+    if (capture_index >= 0) {
+        return 0;
+    }
+
+    capture_index = 0;
+#if !FAKE_CAMERA
+    // Both buffers are CPU scratch between frames - make sure no dirty lines
+    // can be written back over the incoming frame
+    SCB_CleanInvalidateDCache();
+    camera_start_buffer(CAMERA_MODE_SNAPSHOT, frame_buffers[capture_index]);
+#endif
+    return 0;
+}
+
+const uint8_t *get_image_data_pipelined(int ml_width, int ml_height)
+{
+    image_pipeline_start();
+
+    // Frame N: wait for the CPI to finish, then it belongs to the CPU
+    uint8_t *frame = frame_buffers[capture_index];
+    uint32_t start = ARM_PMU_Get_CCNTR();
+#if !FAKE_CAMERA
+    camera_wait(100);
+#else
+    fake_capture(frame);
+#endif
+    stage_cycles.capture_wait = ARM_PMU_Get_CCNTR() - start;
+
+    // Frame N+1: hand the other buffer (our scratch for frame N-1) to the CPI.
+    // The global clean+invalidate both flushes that scratch data and drops any
+    // stale lines covering frame N.
+    capture_index ^= 1;
+#if !FAKE_CAMERA
+    SCB_CleanInvalidateDCache();
+    camera_start_buffer(CAMERA_MODE_SNAPSHOT, frame_buffers[capture_index]);
+#endif
+
+    // Gain changes from this frame now apply to frame N+2, as N+1 is already exposing
+    return process_frame(frame, ml_width, ml_height);
+}
+
+void image_pipeline_stop(void)
+{
+    if (capture_index < 0) {
+        return;
+    }
+#if !FAKE_CAMERA
+    // There is no abort - let the frame in flight land before reusing its buffer
+    camera_wait(100);
+#endif
+    capture_index = -1;
+}
+
+void get_image_stage_cycles(image_stage_cycles_t *cycles)
+{
+    *cycles = stage_cycles;
+}
@@ -12,6 +12,7 @@
 #define DRIVER_CPI_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #define CAM_CTRL		0x00
 #define CAM_INTR		0x04
@@ -30,7 +31,9 @@
 
 
 int32_t camera_init(uint8_t *buffer);
+int32_t camera_power(bool on);
 void camera_start(uint32_t mode);
+void camera_start_buffer(uint32_t mode, uint8_t *buffer);
 int32_t camera_gain(uint32_t gain);
 int32_t camera_vsync(uint32_t timeout_ms);
 int32_t camera_wait(uint32_t timeout_ms);
@@ -22,6 +22,10 @@
 #define CIMAGE_X		560
 #define CIMAGE_Y		560
 
+// Largest scaled output (the biggest snapshot resolution)
+#define CIMAGE_OUT_MAX_X	480
+#define CIMAGE_OUT_MAX_Y	480
+
 #define TIFF_HDR_NUM_ENTRY 8
 #define TIFF_HDR_SIZE 10+TIFF_HDR_NUM_ENTRY*12
 
@@ -30,11 +34,48 @@
 #define FRAME_OUT_OF_RANGE           -2
 
 
+// Exposure analysis: high and low threshold values - code uses >=
+// checks, so a neutral value is >= low and < high.
+#define THRESH_LOW 32
+#define THRESH_HIGH 248
+
 extern uint32_t exposure_low_count, exposure_high_count;
 
+// Largest error (in LSBs) crop_and_interpolate accepts when it picks a resize
+// variant. 8 is the bound of A, the resize used before there were variants.
+// bayer_to_RGB_scaled (CAMERA_FUSED_DEMOSAIC) does not use the variants.
+#ifndef RESIZE_MAX_ERROR
+#define RESIZE_MAX_ERROR 8
+#endif
+
+// Bilinear resize of RGB888 images, in place if dstImage == srcImage
+typedef int (*resize_image_fn)(const uint8_t *srcImage, int srcWidth, int srcHeight, uint8_t *dstImage, int dstWidth, int dstHeight, int pixel_size_B);
+
+typedef struct {
+    const char *name;
+    resize_image_fn resize;
+    uint32_t max_error; // worst case difference from an exact resize, in LSBs
+} resize_variant_t;
+
+// Available resize variants, fastest first
+extern const resize_variant_t resize_variants[];
+extern const uint32_t resize_variant_count;
+
+// Fastest variant within max_error, or the most accurate one if none is
+const resize_variant_t *resize_variant_for_error(uint32_t max_error);
+
+// Fixed point
+int resize_image_A(const uint8_t *srcImage, int srcWidth, int srcHeight, uint8_t *dstImage, int dstWidth, int dstHeight, int pixel_size_B);
+// float16
+int resize_image_B(const uint8_t *srcImage, int srcWidth, int srcHeight, uint8_t *dstImage, int dstWidth, int dstHeight, int pixel_size_B);
+// 16 bit rounding multiplies
+int resize_image_C(const uint8_t *srcImage, int srcWidth, int srcHeight, uint8_t *dstImage, int dstWidth, int dstHeight, int pixel_size_B);
+
 int frame_crop(const void *input_fb, uint32_t ip_row_size, uint32_t ip_col_size, uint32_t row_start, uint32_t col_start, void *output_fb, uint32_t op_row_size, uint32_t op_col_size, uint32_t bpp);
+void calculate_crop_dims(uint32_t srcWidth, uint32_t srcHeight, uint32_t dstWidth, uint32_t dstHeight, uint32_t *cropWidth, uint32_t *cropHeight);
 int crop_and_interpolate(uint8_t const *srcImage, uint32_t srcWidth, uint32_t srcHeight, uint8_t *dstImage, uint32_t dstWidth, uint32_t dstHeight, uint32_t bpp);
 void white_balance(int width, int height, const uint8_t *sp, uint8_t *dp);
 int bayer_to_RGB(uint8_t *src, uint8_t *dest);
+int bayer_to_RGB_scaled(const uint8_t *src, uint8_t *dest, uint32_t dstWidth, uint32_t dstHeight);
 
 #endif /* IMAGE_PROCESSING_H_ */
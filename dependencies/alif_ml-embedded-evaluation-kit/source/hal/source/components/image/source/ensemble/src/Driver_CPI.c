@@ -194,13 +194,40 @@ int32_t camera_init(uint8_t* buffer)
     return res;
 }
 
+/* Power the sensor and controller down between captures, or back up with
+ * the configuration camera_init set. The gain has to be set again after.
+ */
+int32_t camera_power(bool on)
+{
+    if (!on) {
+        return camera->PowerControl(ARM_POWER_OFF);
+    }
+
+    int32_t res = camera->PowerControl(ARM_POWER_FULL);
+    if (res != ARM_DRIVER_OK) {
+        return res;
+    }
+
+    res = camera->Control(CAMERA_SENSOR_CONFIGURE, CAMERA_RESOLUTION_560x560);
+    if (res != ARM_DRIVER_OK) {
+        return res;
+    }
+
+    return camera->Control(CAMERA_EVENTS_CONFIGURE, ARM_CAMERA_CONTROLLER_EVENT_CAMERA_CAPTURE_STOPPED);
+}
+
 void camera_start(uint32_t mode)
+{
+    camera_start_buffer(mode, buf);
+}
+
+void camera_start_buffer(uint32_t mode, uint8_t* buffer)
 {
     image_received = 0;
     if (mode == CAMERA_MODE_SNAPSHOT) {
-        camera->CaptureFrame(buf);
+        camera->CaptureFrame(buffer);
     } else {
-        camera->CaptureVideo(buf);
+        camera->CaptureVideo(buffer);
     }
 }
 
@@ -76,11 +76,6 @@
 #define CE(...)
 #endif
 
-// High and low threshold values - code uses >=
-// checks, so a neutral value is >= low and < high.
-#define THRESH_LOW 32
-#define THRESH_HIGH 248
-
 uint32_t exposure_high_count, exposure_low_count;
 
 dc1394error_t
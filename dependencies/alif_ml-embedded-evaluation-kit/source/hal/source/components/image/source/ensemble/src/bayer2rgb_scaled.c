@@ -0,0 +1,190 @@
+/* Copyright (C) 2023 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ *
+ */
+
+// Fused Bayer to RGB conversion, crop, bilinear scale and colour correction.
+//
+// Produces the same image as bayer_to_RGB + crop_and_interpolate + white_balance,
+// but only demosaics the source pixels the bilinear filter samples, and never
+// materialises the full resolution RGB frame. Demosaic and interpolation are
+// identical to the separate stages; colour correction uses a fixed point matrix,
+// so may differ from the float16 version by 1 LSB.
+
+#include <stdint.h>
+#include <string.h>
+#include "base_def.h"
+#include "image_processing.h"
+
+#if defined(__arm__)
+#include "RTE_Components.h"
+#endif
+
+#if __ARM_FEATURE_MVE & 1
+#include <arm_mve.h>
+#endif
+
+// Must match resize_image_A
+#define FRAC_BITS 14
+#define FRAC_VAL  (1 << FRAC_BITS)
+#define FRAC_MASK (FRAC_VAL - 1)
+
+// Same matrix as color_correction.c
+#define CCM_BITS 12
+#define CCM(a) (int32_t)((a) * (1 << CCM_BITS) + ((a) < 0 ? -0.5 : 0.5))
+
+static const int32_t ccm[3][3] = {
+    { CCM( 2.092), CCM(-0.369), CCM(-0.636) },
+    { CCM(-0.492), CCM( 1.315), CCM( 0.162) },
+    { CCM(-0.139), CCM(-0.664), CCM( 3.017) },
+};
+
+/* Simple demosaic of one pixel, as dc1394_bayer_Simple with a BGGR tile: each
+ * RGB pixel comes from the 2x2 Bayer quad to its bottom right. The last row
+ * and column have no quad, and are black. One pixel past the right edge is the
+ * first pixel of the next row, which is what resize_image_A reads from the RGB
+ * frame there.
+ */
+static inline void demosaic_pixel(const uint8_t * restrict bayer, uint32_t x, uint32_t y, uint8_t rgb[4])
+{
+    if (x == CIMAGE_X) {
+        x = 0;
+        y++;
+    }
+    if (x >= CIMAGE_X - 1 || y >= CIMAGE_Y - 1) {
+        rgb[0] = rgb[1] = rgb[2] = 0;
+        return;
+    }
+
+    const uint8_t *p = bayer + y * CIMAGE_X + x;
+    uint32_t p00 = p[0], p01 = p[1], p10 = p[CIMAGE_X], p11 = p[CIMAGE_X + 1];
+
+    switch (((y & 1) << 1) | (x & 1)) {
+    case 0: // B G / G R
+        rgb[0] = p11; rgb[1] = (p01 + p10 + 1) >> 1; rgb[2] = p00;
+        break;
+    case 1: // G B / R G
+        rgb[0] = p10; rgb[1] = (p00 + p11 + 1) >> 1; rgb[2] = p01;
+        break;
+    case 2: // G R / B G
+        rgb[0] = p01; rgb[1] = (p00 + p11 + 1) >> 1; rgb[2] = p10;
+        break;
+    default: // R G / G B
+        rgb[0] = p00; rgb[1] = (p01 + p10 + 1) >> 1; rgb[2] = p11;
+        break;
+    }
+}
+
+int bayer_to_RGB_scaled(const uint8_t * restrict src, uint8_t * restrict dest, uint32_t dstWidth, uint32_t dstHeight)
+{
+    uint32_t cropWidth, cropHeight;
+
+    // Same aspect-preserving centre crop as crop_and_interpolate
+    calculate_crop_dims(CIMAGE_X, CIMAGE_Y, dstWidth, dstHeight, &cropWidth, &cropHeight);
+    if (cropHeight < 2 || cropWidth > CIMAGE_X || cropHeight > CIMAGE_Y) {
+        return FRAME_OUT_OF_RANGE;
+    }
+    const uint32_t crop_x = (CIMAGE_X - cropWidth) / 2;
+    const uint32_t crop_y = (CIMAGE_Y - cropHeight) / 2;
+
+    const uint32_t src_x_frac = (cropWidth * FRAC_VAL) / dstWidth;
+    const uint32_t src_y_frac = (cropHeight * FRAC_VAL) / dstHeight;
+
+    uint32_t high_count = 0, not_low_count = 0;
+
+#if __ARM_FEATURE_MVE & 1
+    const mve_pred16_t p = vctp32q(3);
+    const int32x4_t ccm_r = { ccm[0][0], ccm[1][0], ccm[2][0], 0 };
+    const int32x4_t ccm_g = { ccm[0][1], ccm[1][1], ccm[2][1], 0 };
+    const int32x4_t ccm_b = { ccm[0][2], ccm[1][2], ccm[2][2], 0 };
+#endif
+
+    // start at 1/2 pixel in to account for integer downsampling which might miss pixels
+    uint32_t src_y_accum = FRAC_VAL / 2;
+    uint8_t *d = dest;
+
+    for (uint32_t y = 0; y < dstHeight; y++) {
+        const uint32_t ty = crop_y + (src_y_accum >> FRAC_BITS);
+        const uint32_t y_frac = src_y_accum & FRAC_MASK;
+        const uint32_t ny_frac = FRAC_VAL - y_frac;
+        src_y_accum += src_y_frac;
+
+        uint32_t src_x_accum = FRAC_VAL / 2;
+        for (uint32_t x = 0; x < dstWidth; x++) {
+            const uint32_t tx = crop_x + (src_x_accum >> FRAC_BITS);
+            const uint32_t x_frac = src_x_accum & FRAC_MASK;
+            const uint32_t nx_frac = FRAC_VAL - x_frac;
+            src_x_accum += src_x_frac;
+
+            // Exposure analysis on the sampled pixels, as bayer_to_RGB does for the full frame
+            if (tx < CIMAGE_X - 1 && ty < CIMAGE_Y - 1) {
+                const uint8_t *e = src + ty * CIMAGE_X + tx;
+                if (e[0] >= THRESH_HIGH || e[1] >= THRESH_HIGH) {
+                    high_count++;
+                }
+                if (e[0] >= THRESH_LOW && e[1] >= THRESH_LOW) {
+                    not_low_count++;
+                }
+            }
+
+            uint8_t q00[4], q10[4], q01[4], q11[4];
+            demosaic_pixel(src, tx, ty, q00);
+            demosaic_pixel(src, tx + 1, ty, q10);
+            demosaic_pixel(src, tx, ty + 1, q01);
+            demosaic_pixel(src, tx + 1, ty + 1, q11);
+
+#if __ARM_FEATURE_MVE & 1
+            uint32x4_t p00 = vldrbq_z_u32(q00, p);
+            uint32x4_t p10 = vldrbq_z_u32(q10, p);
+            uint32x4_t p01 = vldrbq_z_u32(q01, p);
+            uint32x4_t p11 = vldrbq_z_u32(q11, p);
+            p00 = vmulq_x(p00, nx_frac, p);
+            p00 = vmlaq_m(p00, p10, x_frac, p);
+            p00 = vrshrq_x(p00, FRAC_BITS, p);
+            p01 = vmulq_x(p01, nx_frac, p);
+            p01 = vmlaq_m(p01, p11, x_frac, p);
+            p01 = vrshrq_x(p01, FRAC_BITS, p);
+            p00 = vmulq_x(p00, ny_frac, p);
+            p00 = vmlaq_m(p00, p01, y_frac, p);
+            p00 = vrshrq_x(p00, FRAC_BITS, p);
+
+            // colour correction: out = R * col_r + G * col_g + B * col_b
+            int32x4_t c = vmulq(ccm_r, (int32_t)vgetq_lane_u32(p00, 0));
+            c = vmlaq(c, ccm_g, (int32_t)vgetq_lane_u32(p00, 1));
+            c = vmlaq(c, ccm_b, (int32_t)vgetq_lane_u32(p00, 2));
+            c = vshrq(c, CCM_BITS);
+            c = vmaxq(c, vdupq_n_s32(0));
+            c = vminq(c, vdupq_n_s32(255));
+            vstrbq_p_s32((int8_t *)d, c, p);
+            d += RGB_BYTES;
+#else
+            int32_t rgb[3];
+            for (int color = 0; color < RGB_BYTES; color++) {
+                uint32_t top = (q00[color] * nx_frac + q10[color] * x_frac + FRAC_VAL / 2) >> FRAC_BITS;
+                uint32_t bottom = (q01[color] * nx_frac + q11[color] * x_frac + FRAC_VAL / 2) >> FRAC_BITS;
+                rgb[color] = (top * ny_frac + bottom * y_frac + FRAC_VAL / 2) >> FRAC_BITS;
+            }
+
+            for (int color = 0; color < RGB_BYTES; color++) {
+                int32_t c = (ccm[color][0] * rgb[0] + ccm[color][1] * rgb[1] + ccm[color][2] * rgb[2]) >> CCM_BITS;
+                if (c < 0) c = 0;
+                if (c > 255) c = 255;
+                *d++ = (uint8_t)c;
+            }
+#endif
+        }
+    }
+
+    /* Scale the sampled counts up to what bayer_to_RGB would have reported */
+    const uint64_t frame_pixels = (uint64_t)(CIMAGE_X - 2) * (CIMAGE_Y - 1);
+    const uint32_t samples = dstWidth * dstHeight;
+    exposure_high_count = (uint32_t)((high_count * frame_pixels) / samples);
+    exposure_low_count = (uint32_t)(frame_pixels - (not_low_count * frame_pixels) / samples);
+
+    return 0;
+}
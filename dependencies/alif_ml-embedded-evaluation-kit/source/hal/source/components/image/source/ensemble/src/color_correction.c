@@ -18,7 +18,12 @@
 #endif
 
 #define SKIP_COLOR_CORRECTION 0
+// The bulk version needs Helium, so scalar builds (eg the native unit tests) use the pixelwise one
+#if __ARM_FEATURE_MVE & 1
 #define PIXELWISE_COLOR_CORRECTION 0
+#else
+#define PIXELWISE_COLOR_CORRECTION 1
+#endif
 
 #if PIXELWISE_COLOR_CORRECTION
 static void color_correction(const uint8_t sp[static 3], uint8_t dp[static 3])
@@ -14,14 +14,31 @@
 #include <tgmath.h>
 #include "image_processing.h"
 
-#include "RTE_Components.h"
-
 #if __ARM_FEATURE_MVE & 1
 #include <arm_mve.h>
 #endif
 
+#if defined(__arm__)
 #include "RTE_Components.h"
 
+extern uint32_t tprof1, tprof2, tprof3, tprof4, tprof5;
+#define PROF_START(t) ((t) = ARM_PMU_Get_CCNTR())
+#define PROF_END(t)   ((t) = ARM_PMU_Get_CCNTR() - (t))
+#else
+// Host builds (the native unit tests) have no cycle counter
+#define PROF_START(t) ((void)0)
+#define PROF_END(t)   ((void)0)
+#endif
+
+// Scalar stand-in for the Helium float16 arithmetic of resize_image_B
+#if __ARM_FEATURE_MVE & 1
+typedef float16_t resize_f16_t;
+#elif defined(__FLT16_MAX__)
+typedef _Float16 resize_f16_t;
+#else
+typedef float resize_f16_t;
+#endif
+
 int frame_crop(const void * restrict input_fb,
 		       uint32_t ip_row_size,
 			   uint32_t ip_col_size,
@@ -222,7 +239,9 @@ int resize_image_B(
     //dstWidth still needed as is
     //dstHeight shouldn't be scaled
 
+#if __ARM_FEATURE_MVE & 1
     const uint16x8_t incpix = vmulq_n_u16(vidupq_n_u16(0, 1), pixel_size_B);
+#endif
 
     for (int y = 0; y < dstHeight; y++) {
         // do indexing computations
@@ -235,6 +254,7 @@ int resize_image_B(
         uint8_t *d = &dstImage[y * dstWidth * pixel_size_B]; //not scaled above
         // start at 1/2 pixel in to account for integer downsampling which might miss pixels
         float src_x_accum = 0.5f;
+#if __ARM_FEATURE_MVE & 1
         for (int x_count = dstWidth; x_count > 0; x_count -= 8) {
             uint16_t tx_array[8];
             float16_t x_frac_array[8];
@@ -272,6 +292,31 @@ int resize_image_B(
             }
             d += pixel_size_B * 8;
         } // for x
+#else
+        // Same operations one pixel at a time, rounding to float16 where Helium does
+        const resize_f16_t ny_frac_h = ny_frac;
+        const resize_f16_t y_frac_h = y_frac;
+        for (int x = 0; x < dstWidth; x++) {
+            int tx = (int)src_x_accum * pixel_size_B;
+            resize_f16_t x_frac = src_x_accum - trunc(src_x_accum);
+            resize_f16_t nx_frac = 1 - x_frac;
+            src_x_accum += src_x_frac;
+
+            for (int color = 0; color < pixel_size_B; color++) {
+                resize_f16_t p00 = s[tx + color];
+                resize_f16_t p10 = s[tx + color + pixel_size_B];
+                resize_f16_t p01 = s[tx + color + srcWidth];
+                resize_f16_t p11 = s[tx + color + srcWidth + pixel_size_B];
+                p00 = p00 * nx_frac;
+                p00 = fmaf(p10, x_frac, p00);
+                p01 = p01 * nx_frac;
+                p01 = fmaf(p11, x_frac, p01);
+                p00 = p00 * ny_frac_h;
+                p00 = fmaf(p01, y_frac_h, p00);
+                *d++ = (uint8_t)lrintf(p00); // vcvtnq rounds to nearest even
+            }
+        } // for x
+#endif
     } // for y
     return 0;
 } // resizeImage()
@@ -312,19 +357,22 @@ int resize_image_C(
     const uint8_t *s;
     uint8_t *d;
 
+#if __ARM_FEATURE_MVE & 1
     const uint16x8_t incpix = vmulq_n_u16(vidupq_n_u16(0, 1), pixel_size_B);
+#endif
 
     for (int y = 0; y < dstHeight; y++) {
         // do indexing computations
         int ty = src_y_accum >> FRAC_BITS; // src y
         uint16_t y_frac = src_y_accum & FRAC_MASK;
         src_y_accum += src_y_frac;
-        uint16_t ny_frac = __USAT(FRAC_VAL - y_frac, 16); // y fraction and 1.0 - y fraction
+        uint16_t ny_frac = y_frac ? FRAC_VAL - y_frac : FRAC_MASK; // y fraction and 1.0 - y fraction, saturated
 
         s = &srcImage[ty * srcWidth];
         d = &dstImage[y * dstWidth * pixel_size_B]; //not scaled above
         // start at 1/2 pixel in to account for integer downsampling which might miss pixels
         uint32_t src_x_accum = FRAC_VAL / 2;
+#if __ARM_FEATURE_MVE & 1
         for (int x_count = dstWidth; x_count > 0; x_count -= 8) {
             uint16_t tx_array[8];
             uint16_t x_frac_array[8];
@@ -353,7 +401,7 @@ int resize_image_C(
                 uint16x8_t p01 = vldrbq_gather_offset_z_u16(&s[color + srcWidth], tx, p);
                 uint16x8_t p11 = vldrbq_gather_offset_z_u16(&s[color + srcWidth + pixel_size_B], tx, p);
                 p01 = vrmulhq(p01, nx_frac);
-                p01 = vrmulhq(p11, x_frac);
+                p11 = vrmulhq(p11, x_frac);
                 p01 = vaddq(p01, p11);
                 p00 = vrmulhq(p00, vdupq_n_u16(ny_frac));
                 p01 = vrmulhq(p01, vdupq_n_u16(y_frac));
@@ -365,10 +413,64 @@ int resize_image_C(
             }
             d += pixel_size_B * 8;
         } // for x
+#else
+        // Same operations one pixel at a time - bit exact with the Helium version
+#define RMULH(a, b) (((uint32_t)(a) * (b) + 0x8000) >> 16) // vrmulhq
+        for (int x = 0; x < dstWidth; x++) {
+            uint32_t tx = (src_x_accum >> FRAC_BITS) * pixel_size_B;
+            uint16_t x_frac = src_x_accum & FRAC_MASK;
+            uint16_t nx_frac = x_frac ? FRAC_VAL - x_frac : FRAC_MASK;
+            src_x_accum += src_x_frac;
+
+            for (int color = 0; color < pixel_size_B; color++) {
+                uint32_t p00 = RMULH(s[tx + color], nx_frac) + RMULH(s[tx + color + pixel_size_B], x_frac);
+                uint32_t p01 = RMULH(s[tx + color + srcWidth], nx_frac) + RMULH(s[tx + color + srcWidth + pixel_size_B], x_frac);
+                uint32_t out = RMULH(p00, ny_frac) + RMULH(p01, y_frac);
+                *d++ = out > 255 ? 255 : out; // vqmovnbq
+            }
+        } // for x
+#undef RMULH
+#endif
     } // for y
     return 0;
 } // resizeImage()
 
+#undef FRAC_BITS
+
+
+/* Worst case differences from an exact bilinear resize of noise, for outputs up
+ * to CIMAGE_OUT_MAX_X, checked by the native unit tests. The truncated 14 bit
+ * step of A drifts by up to 1/50 pixel across a 480 pixel row, C rounds every
+ * product, and B is limited by float16.
+ * Ordered fastest first, as measured by the native unit tests: there C takes
+ * about 1.5x and B (float16 in software) about 40x the time of A. The same
+ * order is used on the board, where it has not been measured; the default
+ * RESIZE_MAX_ERROR of 8 picks A whatever the order.
+ * Only crop_and_interpolate picks a variant. With CAMERA_FUSED_DEMOSAIC the
+ * camera path uses bayer_to_RGB_scaled instead, which has its own fixed point
+ * interpolation (that of A), so none of this applies there.
+ */
+const resize_variant_t resize_variants[] = {
+    { "A", resize_image_A, 8 },
+    { "C", resize_image_C, 3 },
+    { "B", resize_image_B, 1 },
+};
+const uint32_t resize_variant_count = sizeof resize_variants / sizeof resize_variants[0];
+
+const resize_variant_t *resize_variant_for_error(uint32_t max_error)
+{
+    const resize_variant_t *best = &resize_variants[0];
+    for (uint32_t i = 0; i < resize_variant_count; i++) {
+        if (resize_variants[i].max_error <= max_error) {
+            return &resize_variants[i];
+        }
+        // Nothing meets the bound: fall back to the most accurate
+        if (resize_variants[i].max_error < best->max_error) {
+            best = &resize_variants[i];
+        }
+    }
+    return best;
+}
 
 void calculate_crop_dims(uint32_t srcWidth,
 						 uint32_t srcHeight,
@@ -398,11 +500,10 @@ int crop_and_interpolate( uint8_t const * restrict srcImage,
 						  uint32_t bpp)
 {
     uint32_t cropWidth, cropHeight;
-    extern uint32_t tprof1, tprof2, tprof3, tprof4, tprof5;
     if (bpp != 24) {
         abort();
     }
-    tprof2 = ARM_PMU_Get_CCNTR();
+    PROF_START(tprof2);
     // What are dimensions that maintain aspect ratio?
     calculate_crop_dims(srcWidth, srcHeight, dstWidth, dstHeight, &cropWidth, &cropHeight);
     // Now crop to that dimension
@@ -418,12 +519,13 @@ int crop_and_interpolate( uint8_t const * restrict srcImage,
 		bpp);
 
     if( res < 0 ) { return res; }
-    tprof2 = ARM_PMU_Get_CCNTR() - tprof2;
+    PROF_END(tprof2);
 
-    tprof3 = ARM_PMU_Get_CCNTR();
+    PROF_START(tprof3);
     // Finally, interpolate down to desired dimensions, in place
-    int result = resize_image_A(dstImage, cropWidth, cropHeight, dstImage, dstWidth, dstHeight, bpp/8);
-    tprof3 = ARM_PMU_Get_CCNTR() - tprof3;
+    const resize_variant_t *variant = resize_variant_for_error(RESIZE_MAX_ERROR);
+    int result = variant->resize(dstImage, cropWidth, cropHeight, dstImage, dstWidth, dstHeight, bpp/8);
+    PROF_END(tprof3);
     return result;
 }
 
@@ -0,0 +1,244 @@
+/* Copyright (C) 2023 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ *
+ */
+
+// File backed camera for the native platform.
+//
+// Frames are read from the binary PPM (P6, 8 bit) file named by the
+// EI_NATIVE_IMAGE_FILE environment variable. The file may hold several images
+// back to back, which are returned in turn, looping at the end. Each frame is
+// centre cropped to the requested aspect ratio and bilinearly scaled, the same
+// way crop_and_interpolate treats camera frames.
+
+#include "image_data.h"
+#include "log_macros.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define IMAGE_FILE_ENV "EI_NATIVE_IMAGE_FILE"
+
+// Same fixed point as resize_image_A
+#define FRAC_BITS 14
+#define FRAC_VAL  (1 << FRAC_BITS)
+#define FRAC_MASK (FRAC_VAL - 1)
+
+static FILE *image_file = NULL;
+static uint8_t *src_frame = NULL;
+static size_t src_frame_size;
+static uint8_t *dst_frame = NULL;
+static size_t dst_frame_size;
+
+/* Reads one PPM header value, skipping whitespace and comments */
+static int read_ppm_value(FILE *f, unsigned *value)
+{
+    int c = fgetc(f);
+
+    for (;;) {
+        while (c != EOF && isspace(c)) {
+            c = fgetc(f);
+        }
+        if (c != '#') {
+            break;
+        }
+        while (c != EOF && c != '\n') {
+            c = fgetc(f);
+        }
+    }
+
+    if (c == EOF || !isdigit(c)) {
+        return -1;
+    }
+
+    *value = 0;
+    while (c != EOF && isdigit(c)) {
+        *value = *value * 10 + (c - '0');
+        c = fgetc(f);
+    }
+
+    // a single whitespace character ends the value (and the header)
+    return isspace(c) ? 0 : -1;
+}
+
+/* Reads the next frame into src_frame, rewinding at the end of the file */
+static int read_frame(unsigned *width, unsigned *height)
+{
+    char magic[2];
+    unsigned maxval;
+
+    if (image_file == NULL) {
+        return -1;
+    }
+
+    if (fread(magic, 1, 2, image_file) != 2) {
+        rewind(image_file);
+        if (fread(magic, 1, 2, image_file) != 2) {
+            return -1;
+        }
+    }
+
+    if (magic[0] != 'P' || magic[1] != '6' ||
+        read_ppm_value(image_file, width) != 0 ||
+        read_ppm_value(image_file, height) != 0 ||
+        read_ppm_value(image_file, &maxval) != 0 ||
+        *width == 0 || *height == 0) {
+        printf_err("%s: not a binary PPM\n", IMAGE_FILE_ENV);
+        return -1;
+    }
+    if (maxval != 255) {
+        printf_err("%s: only 8 bit PPM is supported\n", IMAGE_FILE_ENV);
+        return -1;
+    }
+
+    size_t size = (size_t)*width * *height * 3;
+    if (size > src_frame_size) {
+        uint8_t *p = realloc(src_frame, size);
+        if (p == NULL) {
+            return -1;
+        }
+        src_frame = p;
+        src_frame_size = size;
+    }
+
+    if (fread(src_frame, 1, size, image_file) != size) {
+        printf_err("%s: truncated frame\n", IMAGE_FILE_ENV);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Centre crop to the destination aspect ratio, then bilinear scale */
+static void crop_and_scale(const uint8_t *src, uint32_t srcWidth, uint32_t srcHeight,
+                           uint8_t *dst, uint32_t dstWidth, uint32_t dstHeight)
+{
+    uint32_t cropWidth = srcWidth;
+    uint32_t cropHeight = srcHeight;
+
+    if (srcWidth * dstHeight > srcHeight * dstWidth) {
+        cropWidth = (dstWidth * srcHeight) / dstHeight;
+    }
+    else {
+        cropHeight = (dstHeight * srcWidth) / dstWidth;
+    }
+    const uint32_t crop_x = (srcWidth - cropWidth) / 2;
+    const uint32_t crop_y = (srcHeight - cropHeight) / 2;
+
+    const uint32_t src_x_frac = (cropWidth * FRAC_VAL) / dstWidth;
+    const uint32_t src_y_frac = (cropHeight * FRAC_VAL) / dstHeight;
+
+    // start at 1/2 pixel in, as resize_image_A
+    uint32_t src_y_accum = FRAC_VAL / 2;
+    for (uint32_t y = 0; y < dstHeight; y++) {
+        uint32_t ty = src_y_accum >> FRAC_BITS;
+        const uint32_t y_frac = src_y_accum & FRAC_MASK;
+        src_y_accum += src_y_frac;
+        const uint32_t ty1 = (ty + 1 < cropHeight) ? ty + 1 : ty;
+
+        const uint8_t *row0 = src + ((crop_y + ty) * srcWidth + crop_x) * 3;
+        const uint8_t *row1 = src + ((crop_y + ty1) * srcWidth + crop_x) * 3;
+
+        uint32_t src_x_accum = FRAC_VAL / 2;
+        for (uint32_t x = 0; x < dstWidth; x++) {
+            const uint32_t tx = src_x_accum >> FRAC_BITS;
+            const uint32_t x_frac = src_x_accum & FRAC_MASK;
+            src_x_accum += src_x_frac;
+            const uint32_t tx1 = (tx + 1 < cropWidth) ? tx + 1 : tx;
+
+            for (int color = 0; color < 3; color++) {
+                uint32_t top = (row0[tx * 3 + color] * (FRAC_VAL - x_frac) +
+                                row0[tx1 * 3 + color] * x_frac + FRAC_VAL / 2) >> FRAC_BITS;
+                uint32_t bottom = (row1[tx * 3 + color] * (FRAC_VAL - x_frac) +
+                                   row1[tx1 * 3 + color] * x_frac + FRAC_VAL / 2) >> FRAC_BITS;
+                *dst++ = (top * (FRAC_VAL - y_frac) + bottom * y_frac + FRAC_VAL / 2) >> FRAC_BITS;
+            }
+        }
+    }
+}
+
+int image_init(void)
+{
+    const char *path = getenv(IMAGE_FILE_ENV);
+    if (path == NULL) {
+        warn("Set %s to a PPM file to use the camera\n", IMAGE_FILE_ENV);
+        return -1;
+    }
+
+    if (image_file) {
+        fclose(image_file);
+    }
+    image_file = fopen(path, "rb");
+    if (image_file == NULL) {
+        printf_err("Can't open %s\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+int image_power(bool on)
+{
+    (void) on;
+    return 0;
+}
+
+const uint8_t *get_image_data(int width, int height)
+{
+    unsigned src_width, src_height;
+
+    if (width <= 0 || height <= 0 || read_frame(&src_width, &src_height) != 0) {
+        return NULL;
+    }
+
+    size_t size = (size_t)width * height * 3;
+    if (size > dst_frame_size) {
+        uint8_t *p = realloc(dst_frame, size);
+        if (p == NULL) {
+            return NULL;
+        }
+        dst_frame = p;
+        dst_frame_size = size;
+    }
+
+    if (src_width == (unsigned)width && src_height == (unsigned)height) {
+        memcpy(dst_frame, src_frame, size);
+    }
+    else {
+        crop_and_scale(src_frame, src_width, src_height, dst_frame, width, height);
+    }
+
+    return dst_frame;
+}
+
+int image_pipeline_start(void)
+{
+    return image_file ? 0 : -1;
+}
+
+const uint8_t *get_image_data_pipelined(int width, int height)
+{
+    return get_image_data(width, height);
+}
+
+void image_pipeline_stop(void)
+{
+}
+
+void get_image_stage_cycles(image_stage_cycles_t *cycles)
+{
+    memset(cycles, 0, sizeof(*cycles));
+}
+
+float get_image_gain(void)
+{
+    return 1.0f;
+}
@@ -9,12 +9,21 @@
  */
 
 #include <inttypes.h>
+#include <string.h>
+
+#include "image_data.h"
 
 int image_init(void)
 {
     return 0;
 }
 
+int image_power(bool on)
+{
+    (void) on;
+    return 0;
+}
+
 const uint8_t *get_image_data(int width, int height)
 {
     (void) width;
@@ -22,6 +31,25 @@ const uint8_t *get_image_data(int width, int height)
     return 0;
 }
 
+int image_pipeline_start(void)
+{
+    return 0;
+}
+
+const uint8_t *get_image_data_pipelined(int width, int height)
+{
+    return get_image_data(width, height);
+}
+
+void image_pipeline_stop(void)
+{
+}
+
+void get_image_stage_cycles(image_stage_cycles_t *cycles)
+{
+    memset(cycles, 0, sizeof(*cycles));
+}
+
 float get_image_gain(void)
 {
     return 1.0f;
@@ -18,12 +18,21 @@
 #include "ethosu_profiler.h"
 #include "ethosu_cpu_cache.h"
 #include "log_macros.h"
+#include "RTE_Components.h"         /* For CPU related defintiions */
 
 #include <string.h>
 
+#if defined(__PMU_PRESENT) && (__PMU_PRESENT == 1U)
+#define CPU_CYCLE_COUNT() ARM_PMU_Get_CCNTR()
+#else
+#define CPU_CYCLE_COUNT() 0
+#endif
+
 extern struct ethosu_driver ethosu_drv;    /* Default Arm Ethos-U NPU device driver object */
 static ethosu_pmu_counters s_npu_counters; /* NPU counter local instance */
 static uint32_t s_evt_mask = 0;            /* PMU event mask */
+static uint32_t s_cpu_start = 0;           /* CPU cycle count at inference begin */
+static uint64_t s_cpu_wait = 0;            /* CPU cycles spent inside inferences */
 
 static const char* unit_beats  = "beats";
 static const char* unit_cycles = "cycles";
@@ -134,6 +143,7 @@ void ethosu_pmu_reset_counters(void)
     /* Reset all cycle and event counters. */
     ETHOSU_PMU_CYCCNT_Reset(&ethosu_drv);
     ETHOSU_PMU_EVCNTR_ALL_Reset(&ethosu_drv);
+    s_cpu_wait = 0;
 }
 
 /**
@@ -166,6 +176,8 @@ ethosu_pmu_counters ethosu_get_pmu_counters(void)
     }
 #endif /* ETHOSU_DERIVED_NCOUNTERS >= 1 */
 
+    counters->cpu_wait_ccnt = s_cpu_wait;
+
     return *counters;
 }
 
@@ -175,10 +187,13 @@ void ethosu_inference_begin(struct ethosu_driver* drv, void* userArg)
     ethosu_clear_cache_states();
     ETHOSU_PMU_CNTR_Disable(drv, get_event_mask());
     ETHOSU_PMU_CNTR_Enable(drv, get_event_mask());
+    s_cpu_start = CPU_CYCLE_COUNT();
 }
 
 void ethosu_inference_end(struct ethosu_driver* drv, void* userArg)
 {
     UNUSED(userArg);
     ETHOSU_PMU_CNTR_Disable(drv, get_event_mask());
+    /* 32 bit CPU counter, so fine for inferences of up to 2^32 cycles */
+    s_cpu_wait += (uint32_t)(CPU_CYCLE_COUNT() - s_cpu_start);
 }
@@ -44,6 +44,7 @@ typedef struct ethosu_pmu_counters_ {
     npu_evt_counter         npu_evt_counters[ETHOSU_PMU_NCOUNTERS];
     npu_derived_counter     npu_derived_counters[ETHOSU_DERIVED_NCOUNTERS];
     uint32_t                num_total_counters; /**< Total number of counters */
+    uint64_t                cpu_wait_ccnt;      /**< CPU cycles spent inside NPU inferences (0 without a CPU PMU) */
 } ethosu_pmu_counters;
 
 /**
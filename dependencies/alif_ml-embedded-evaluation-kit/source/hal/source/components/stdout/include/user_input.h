@@ -23,6 +23,9 @@ extern "C" {
 
 unsigned int GetLine(char *user_input, unsigned int size);
 
+/* stdio has no way to poll, so this always returns -1 (nothing received). */
+int GetCharNoBlock(void);
+
 #ifdef __cplusplus
 }
 #endif
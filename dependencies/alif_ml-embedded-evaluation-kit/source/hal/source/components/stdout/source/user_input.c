@@ -28,6 +28,11 @@ unsigned int GetLine(char *user_input, unsigned int size)
     return 0;
 }
 
+int GetCharNoBlock(void)
+{
+    return -1;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -51,3 +51,8 @@ bool hal_get_user_input(char* user_input, int size)
     }
     return false;
 }
+
+int hal_get_user_char(void)
+{
+    return GetCharNoBlock();
+}
@@ -62,6 +62,20 @@ extern bool run_requested(void);
 extern void init_trigger_rx(void);
 extern void init_trigger_tx(void);
 
+/**
+ * @brief   Handler for MHU messages from the other M55 core.
+ * @param[in]   data    The received payload, valid until the handler returns.
+ */
+typedef void (*mhu_msg_handler_t)(void* data);
+
+/**
+ * @brief   Sets the handler for MHU messages the platform does not handle
+ *          itself (any id other than the "go"/"stop" one). Runs in the MHU
+ *          interrupt, after init_trigger_rx.
+ * @param[in]   handler     The handler, or NULL to drop those messages.
+ */
+extern void set_mhu_msg_handler(mhu_msg_handler_t handler);
+
 #ifdef __cplusplus
 }
 #endif
@@ -60,13 +60,55 @@ void tracef(const char * format, ...);
 /**
  * @brief Send string to UART, no prefix is prepended.
  *
+ * The string is copied into the transmit ring and sent in the background, so
+ * this returns before the data is on the wire. When the ring is full this
+ * waits for space, except in interrupt context or with interrupts masked
+ * where the rest of the string is dropped. Either case counts an overflow.
+ *
  * @param str string to send over UART
  * @param len length of the string
  */
 int send_str(const char* str, uint32_t len);
 
+/**
+ * @brief Wait until everything queued with send_str has been sent.
+ *
+ * Use before changing the baud rate, resetting or sleeping.
+ */
+void send_wait(void);
+
+/**
+ * @brief Number of writes that found the transmit ring full
+ */
+uint32_t get_uart_tx_overflows(void);
+
+/**
+ * @brief Read received bytes without blocking.
+ *
+ * Input is collected into the receive ring from the UART interrupt from
+ * tracelib_init on, so nothing is lost while the caller is busy, as long as
+ * the ring doesn't fill up. Only one context may read.
+ *
+ * @param buf  destination
+ * @param len  size of buf
+ * @return number of bytes copied to buf, 0 if nothing has been received
+ */
+int UartRead(uint8_t *buf, uint32_t len);
+
+/**
+ * @brief Number of times the receive ring filled up or the UART reported an
+ * overrun, either of which can lose input
+ */
+uint32_t get_uart_rx_overflows(void);
+
 unsigned int GetLine(char *user_input, unsigned int size);
 
+/**
+ * @brief Read one received character, without waiting
+ * @return the character, or -1 if nothing has been received
+ */
+int GetCharNoBlock(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -209,6 +209,13 @@ static bool last_btn0 = false;
 static bool last_btn1 = false;
 #endif
 
+static mhu_msg_handler_t mhu_msg_handler = NULL;
+
+void set_mhu_msg_handler(mhu_msg_handler_t handler)
+{
+    mhu_msg_handler = handler;
+}
+
 static void MHU_msg_received(void* data)
 {
     m55_data_payload_t* payload = data;
@@ -230,6 +237,9 @@ static void MHU_msg_received(void* data)
         case 3:
             break;
         default:
+            if (mhu_msg_handler) {
+                mhu_msg_handler(data);
+            }
             break;
     }
 }
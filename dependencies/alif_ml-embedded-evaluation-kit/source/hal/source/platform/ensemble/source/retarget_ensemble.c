@@ -91,10 +91,6 @@ const char __stdout_name[] __attribute__((aligned(4))) = "STDOUT";
 const char __stderr_name[] __attribute__((aligned(4))) = "STDERR";
 #define UNUSED(x) (void)(x)
 
-#define RETARGET_BUF_MAX 128
-static char retarget_buf[RETARGET_BUF_MAX];
-static uint32_t retarget_buf_len = 0;
-
 void _ttywrch(int ch) {
     (void)fputc(ch, stdout);
 }
@@ -125,28 +121,8 @@ int RETARGET(_write)(FILEHANDLE fh, const unsigned char *buf, unsigned int len,
     switch (fh) {
     case STDOUT:
     case STDERR: {
-        if(__get_IPSR() != 0U)
-        {
-           // this is ISR context so don't push to UART
-           if(retarget_buf_len < RETARGET_BUF_MAX)
-           {
-               // if we're full just drop
-               if (len > RETARGET_BUF_MAX - retarget_buf_len) {
-                   len = RETARGET_BUF_MAX - retarget_buf_len;
-               }
-               memcpy(retarget_buf + retarget_buf_len, buf, len);
-               retarget_buf_len += len;
-           }
-        }
-        else
-        {
-            if (retarget_buf_len != 0)
-            {
-                send_str(retarget_buf, retarget_buf_len);
-                retarget_buf_len = 0;
-            }
-            send_str((const char *) buf, len);
-        }
+        // queued for the UART, safe from ISR context too (dropped if the queue is full)
+        send_str((const char *) buf, len);
 #ifdef __ARMCC_VERSION
         // armcc expects to get the amount of characters that were not written
         return 0;
@@ -271,6 +247,8 @@ void RETARGET(_exit)(int return_code)
     UNUSED(return_code);
 
     putchar('\n');
+    fflush(stdout);
+    send_wait();
 
     __BKPT();
     while(1) {
@@ -39,6 +39,7 @@
 #include <string.h>
 #include <stdatomic.h>
 #include "Driver_PINMUX_AND_PINPAD.h"
+#include "uart_tracelib.h"
 #include <RTE_Device.h>
 #include <RTE_Components.h>
 #include CMSIS_device_header
@@ -65,12 +66,42 @@ extern ARM_DRIVER_USART ARM_Driver_USART_(CONSOLE_UART);
 /* UART Driver instance */
 static ARM_DRIVER_USART *USARTdrv = &ARM_Driver_USART_(CONSOLE_UART);
 
-static atomic_uint_fast32_t uart_event;
 static bool initialized = false;
 const char * tr_prefix = NULL;
 uint16_t prefix_len;
 #define MAX_TRACE_LEN 256
 
+/* Transmit ring. Writers copy into it and return, the UART driver sends it
+ * out in contiguous chunks, and the send complete callback chains the next
+ * chunk. Indices are free running, so the size must be a power of two.
+ */
+#ifndef UART_TX_RING_SIZE
+#define UART_TX_RING_SIZE 4096
+#endif
+_Static_assert((UART_TX_RING_SIZE & (UART_TX_RING_SIZE - 1)) == 0, "UART_TX_RING_SIZE must be a power of two");
+
+static uint8_t tx_ring[UART_TX_RING_SIZE];
+static volatile uint32_t tx_head;       /* next byte to write */
+static volatile uint32_t tx_tail;       /* next byte to send */
+static volatile uint32_t tx_inflight;   /* bytes handed to the driver */
+static atomic_uint_fast32_t tx_overflows;
+
+/* Receive ring. The driver always has a one byte receive pending into the
+ * next free slot, re-armed from the receive complete callback, so input is
+ * collected while the CPU is busy and read later with UartRead. Same free
+ * running indices as the transmit ring.
+ */
+#ifndef UART_RX_RING_SIZE
+#define UART_RX_RING_SIZE 1024
+#endif
+_Static_assert((UART_RX_RING_SIZE & (UART_RX_RING_SIZE - 1)) == 0, "UART_RX_RING_SIZE must be a power of two");
+
+static uint8_t rx_ring[UART_RX_RING_SIZE];
+static volatile uint32_t rx_head;       /* next byte the driver fills */
+static volatile uint32_t rx_tail;       /* next byte to read */
+static volatile bool rx_armed;          /* a receive is pending */
+static atomic_uint_fast32_t rx_overflows;
+
 static int hardware_init(void)
 {
     int32_t ret;
@@ -147,15 +178,124 @@ static int hardware_init(void)
     return 0;
 }
 
+/* Start sending the next contiguous chunk of the ring, if the driver is idle.
+ * Called with interrupts masked, or from the UART interrupt.
+ */
+static void tx_kick(void)
+{
+    if (tx_inflight != 0) {
+        return;
+    }
+
+    uint32_t used = tx_head - tx_tail;
+    if (used == 0) {
+        return;
+    }
+
+    uint32_t offset = tx_tail & (UART_TX_RING_SIZE - 1);
+    uint32_t len = UART_TX_RING_SIZE - offset;
+    if (len > used) {
+        len = used;
+    }
+
+    if (USARTdrv->Send(&tx_ring[offset], len) == ARM_DRIVER_OK) {
+        tx_inflight = len;
+    }
+}
+
+/* Retry a chunk the driver refused, so waiting on the ring can't stall */
+static void tx_restart(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    tx_kick();
+    __set_PRIMASK(primask);
+}
+
+/* Copy as much of str as fits into the ring, returns the number of bytes taken */
+static uint32_t tx_enqueue(const char *str, uint32_t len)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t space = UART_TX_RING_SIZE - (tx_head - tx_tail);
+    if (len > space) {
+        len = space;
+    }
+
+    uint32_t offset = tx_head & (UART_TX_RING_SIZE - 1);
+    uint32_t first = UART_TX_RING_SIZE - offset;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&tx_ring[offset], str, first);
+    memcpy(tx_ring, str + first, len - first);
+    tx_head += len;
+
+    tx_kick();
+
+    __set_PRIMASK(primask);
+    return len;
+}
+
+/* Hand the driver the next free slot of the receive ring. With the ring full
+ * it stays disarmed (further input backs up in the UART FIFO) until UartRead
+ * frees some space. Called with interrupts masked, or from the UART interrupt.
+ */
+static void rx_arm(void)
+{
+    if (rx_armed || !initialized) {
+        return;
+    }
+
+    if (rx_head - rx_tail == UART_RX_RING_SIZE) {
+        return;
+    }
+
+    if (USARTdrv->Receive(&rx_ring[rx_head & (UART_RX_RING_SIZE - 1)], 1) == ARM_DRIVER_OK) {
+        rx_armed = true;
+    }
+}
+
+static void rx_restart(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    rx_arm();
+    __set_PRIMASK(primask);
+}
+
 void myUART_callback(uint32_t event)
 {
-    uart_event = event;
+    if (event & ARM_USART_EVENT_SEND_COMPLETE) {
+        tx_tail += tx_inflight;
+        tx_inflight = 0;
+        tx_kick();
+    }
+
+    if (event & ARM_USART_EVENT_RECEIVE_COMPLETE) {
+        rx_head++;
+        rx_armed = false;
+        if (rx_head - rx_tail == UART_RX_RING_SIZE) {
+            rx_overflows++;
+        }
+        rx_arm();
+    }
+
+    if (event & ARM_USART_EVENT_RX_OVERFLOW) {
+        rx_overflows++;
+    }
 }
 
 int tracelib_init(const char * prefix, int baudrate)
 {
     int32_t ret    = 0;
 
+    /* reconfiguring (e.g. for a baud rate change) would cut off queued output */
+    if (initialized) {
+        send_wait();
+    }
+
     tr_prefix = prefix;
     if (tr_prefix) {
         prefix_len = strlen(tr_prefix);
@@ -171,7 +311,9 @@ int tracelib_init(const char * prefix, int baudrate)
         return ret;
     }
 
-    /* Initialize UART driver */
+    /* Initialize UART driver, this drops any pending receive */
+    initialized = false;
+    rx_armed = false;
     ret = USARTdrv->Initialize(myUART_callback);
     if(ret != ARM_DRIVER_OK)
     {
@@ -211,26 +353,59 @@ int tracelib_init(const char * prefix, int baudrate)
     }
 
     initialized = true;
+    rx_restart();
     return ret;
 }
 
 int send_str(const char* str, uint32_t len)
 {
-    int ret = 0;
-    if (initialized)
-    {
-        uart_event = 0;
-        int32_t ret = USARTdrv->Send(str, len);
-        if(ret != ARM_DRIVER_OK)
-        {
-            return ret;
+    bool overflowed = false;
+
+    if (!initialized) {
+        return 0;
+    }
+
+    while (len) {
+        uint32_t n = tx_enqueue(str, len);
+        str += n;
+        len -= n;
+        if (len == 0) {
+            break;
         }
 
-        while (!uart_event) {
-            __WFE();
+        if (!overflowed) {
+            tx_overflows++;
+            overflowed = true;
         }
+
+        /* The ring only drains from the UART interrupt, so waiting for it
+         * with interrupts masked or from another handler could hang: drop
+         * the rest instead.
+         */
+        if (__get_IPSR() != 0U || __get_PRIMASK() != 0U) {
+            break;
+        }
+        tx_restart();
+        __WFE();
     }
-    return ret;
+    return 0;
+}
+
+void send_wait(void)
+{
+    if (__get_IPSR() != 0U || __get_PRIMASK() != 0U) {
+        return;
+    }
+
+    while (tx_head != tx_tail) {
+        tx_restart();
+        __WFE();
+    }
+}
+
+uint32_t get_uart_tx_overflows(void)
+{
+    return tx_overflows;
 }
 
 void tracef(const char * format, ...)
@@ -260,16 +435,43 @@ unsigned char UartPutc(unsigned char ch)
     return ch;
 }
 
+int UartRead(uint8_t *buf, uint32_t len)
+{
+    if (!initialized) {
+        return 0;
+    }
+
+    /* single reader: only the interrupt moves rx_head, only we move rx_tail */
+    uint32_t tail = rx_tail;
+    uint32_t avail = rx_head - tail;
+    if (len > avail) {
+        len = avail;
+    }
+
+    for (uint32_t ix = 0; ix < len; ix++) {
+        buf[ix] = rx_ring[(tail + ix) & (UART_RX_RING_SIZE - 1)];
+    }
+    rx_tail = tail + len;
+
+    /* the ring may have filled up and left the receiver disarmed */
+    if (!rx_armed) {
+        rx_restart();
+    }
+
+    return len;
+}
+
+uint32_t get_uart_rx_overflows(void)
+{
+    return rx_overflows;
+}
+
 unsigned char UartGetc(void)
 {
     unsigned char c;
-    uart_event = 0;
-    if (initialized) {
-        USARTdrv->Receive(&c, 1);
-    }
 
     /* We'll just loop for ever if not initialized or anything goes wrong */
-    while (!(uart_event & ARM_USART_EVENT_RECEIVE_COMPLETE)) {
+    while (UartRead(&c, 1) == 0) {
         __WFE();
     }
 
@@ -278,19 +480,22 @@ unsigned char UartGetc(void)
 
 unsigned char UartGetcNoBlock(void)
 {
-	static uint8_t buf[1];
+    unsigned char c;
 
-    if(USARTdrv->GetRxCount()) {
-		if (USARTdrv->Receive(buf, 1) != ARM_DRIVER_OK)
-		{
-			return (-1);
-		} else {
-			return buf[0];
-		}
+    if (UartRead(&c, 1) == 0) {
+        return -1;
     }
-    else {
+    return c;
+}
+
+int GetCharNoBlock(void)
+{
+    unsigned char c;
+
+    if (UartRead(&c, 1) == 0) {
         return -1;
     }
+    return c;
 }
 
 
@@ -355,6 +560,25 @@ int send_str(const char* str, uint32_t len)
     return 0;
 }
 
+void send_wait(void)
+{
+}
+
+uint32_t get_uart_tx_overflows(void)
+{
+    return 0;
+}
+
+int UartRead(uint8_t *buf, uint32_t len)
+{
+    return 0;
+}
+
+uint32_t get_uart_rx_overflows(void)
+{
+    return 0;
+}
+
 void tracef(const char * format, ...)
 {
 }
@@ -364,6 +588,11 @@ unsigned int GetLine(char *user_input, unsigned int size)
     return 0;
 }
 
+int GetCharNoBlock(void)
+{
+    return -1;
+}
+
 #endif // DISABLE_UART_TRACE
 
 /************************ (C) COPYRIGHT ALIF SEMICONDUCTOR *****END OF FILE****/
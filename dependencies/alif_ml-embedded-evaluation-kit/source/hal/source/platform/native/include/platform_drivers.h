@@ -22,6 +22,7 @@
 #include "lcd_img.h"        /* LCD functions */
 #include "user_input.h"     /* User input function */
 #include "timer_native.h"   /* Native platform timer/profiler support */
+#include "uart_tracelib.h"  /* Console on stdin/stdout */
 
 /**
  * @brief   Initialises the platform components.
@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UART_TRACELIB_H_
+#define UART_TRACELIB_H_
+
+/*
+ * Native stand-in for the Ensemble console UART (uart_tracelib), so code written
+ * against it runs on the host: output goes to stdout and input comes from stdin.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Nothing to set up, the baud rate is ignored.
+ */
+int tracelib_init(const char * prefix, int baudrate);
+
+/**
+ * @brief write trace to stdout
+ */
+void tracef(const char * format, ...);
+
+/**
+ * @brief Write to stdout, no prefix is prepended.
+ */
+int send_str(const char* str, uint32_t len);
+
+/**
+ * @brief Flush stdout.
+ */
+void send_wait(void);
+
+/**
+ * @brief Always 0, stdout blocks instead of dropping.
+ */
+uint32_t get_uart_tx_overflows(void);
+
+/**
+ * @brief Read from stdin without blocking.
+ *
+ * LF and CRLF line endings are turned into a CR, which is what a serial
+ * terminal sends.
+ *
+ * @param buf  destination
+ * @param len  size of buf, 0 only checks whether stdin has been closed
+ * @return number of bytes copied to buf, 0 if nothing is waiting, or -1 once
+ * stdin has been closed
+ */
+int UartRead(uint8_t *buf, uint32_t len);
+
+/**
+ * @brief Always 0, unread input waits in the pipe.
+ */
+uint32_t get_uart_rx_overflows(void);
+
+/**
+ * @brief Wait up to timeout_ms (forever if negative) for input on stdin.
+ */
+void UartWaitRx(int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_TRACELIB_H_ */
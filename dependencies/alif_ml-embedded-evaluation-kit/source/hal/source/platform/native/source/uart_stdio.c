@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Console UART on stdin/stdout, see uart_tracelib.h
+
+#include "uart_tracelib.h"
+
+#include <poll.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static int rx_closed = 0;
+static int rx_last_cr = 0;
+
+int tracelib_init(const char * prefix, int baudrate)
+{
+    (void) prefix;
+    (void) baudrate;
+    return 0;
+}
+
+void tracef(const char * format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+int send_str(const char* str, uint32_t len)
+{
+    fwrite(str, 1, len, stdout);
+    return 0;
+}
+
+void send_wait(void)
+{
+    fflush(stdout);
+}
+
+uint32_t get_uart_tx_overflows(void)
+{
+    return 0;
+}
+
+int UartRead(uint8_t *buf, uint32_t len)
+{
+    struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+
+    if (rx_closed) {
+        return -1;
+    }
+    if (len == 0 || poll(&pfd, 1, 0) <= 0) {
+        return 0;
+    }
+
+    // stdin is not buffered by stdio, so poll and read agree
+    ssize_t n = read(STDIN_FILENO, buf, len);
+    if (n <= 0) {
+        rx_closed = 1;
+        return -1;
+    }
+
+    uint32_t out = 0;
+    for (ssize_t ix = 0; ix < n; ix++) {
+        uint8_t c = buf[ix];
+        if (c == '\n') {
+            if (rx_last_cr) {
+                rx_last_cr = 0;
+                continue;
+            }
+            c = '\r';
+        }
+        else {
+            rx_last_cr = (c == '\r');
+        }
+        buf[out++] = c;
+    }
+
+    return out;
+}
+
+uint32_t get_uart_rx_overflows(void)
+{
+    return 0;
+}
+
+void UartWaitRx(int timeout_ms)
+{
+    struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+
+    if (!rx_closed) {
+        poll(&pfd, 1, timeout_ms);
+    }
+}
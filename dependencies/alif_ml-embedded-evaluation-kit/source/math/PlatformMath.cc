@@ -17,6 +17,8 @@
 #include "PlatformMath.hpp"
 #include "log_macros.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 
 namespace arm {
 namespace app {
@@ -114,6 +116,21 @@ namespace math {
         } else {
             fftInstance.m_optimisedOptionAvailable = true;
         }
+#else  /* __ARM_FEATURE_DSP */
+        if (fftLen >= 2 && 0 == (fftLen & (fftLen - 1))) {
+            /* W^k = e^(-2*pi*i*k/fftLen), for k up to 3/4 of fftLen, which is
+             * as far as the radix-4 stages and the real split reach. */
+            const uint32_t numTwiddles = 3 * fftLen / 4 + 1;
+            fftInstance.m_twiddles.resize(2 * numTwiddles);
+            for (uint32_t k = 0; k < numTwiddles; ++k) {
+                const double angle = 2 * M_PI * k / fftLen;
+                fftInstance.m_twiddles[2 * k] = static_cast<float>(std::cos(angle));
+                fftInstance.m_twiddles[2 * k + 1] = static_cast<float>(-std::sin(angle));
+            }
+            fftInstance.m_optimisedOptionAvailable = true;
+        } else {
+            fftInstance.m_twiddles.clear();
+        }
 #endif /* __ARM_FEATURE_DSP */
 
         debug("Optimised FFT will be used: %s.\n", fftInstance.m_optimisedOptionAvailable? "yes": "no");
@@ -173,6 +190,139 @@ namespace math {
         }
     }
 
+#if !(defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+    /**
+     * @brief       In place complex FFT of a power of 2 length: radix-4
+     *              decimation in time, with one radix-2 stage first when the
+     *              length is an odd power of 2.
+     * @param[in,out]   data            fftLen interleaved (real, imaginary) pairs.
+     * @param[in]       fftLen          Number of complex points.
+     * @param[in]       twiddles        W^k pairs for a length of fftLen * twiddleStride.
+     * @param[in]       twiddleStride   Twiddle table step for W^1 of fftLen.
+     */
+    static void FftComplexRadix4F32(float* data, const uint32_t fftLen,
+                                    const float* twiddles, const uint32_t twiddleStride)
+    {
+        /* Bit reversed order */
+        for (uint32_t i = 1, j = 0; i < fftLen; ++i) {
+            uint32_t bit = fftLen >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j |= bit;
+            if (i < j) {
+                std::swap(data[2 * i], data[2 * j]);
+                std::swap(data[2 * i + 1], data[2 * j + 1]);
+            }
+        }
+
+        uint32_t stages = 0;
+        for (uint32_t n = fftLen; n > 1; n >>= 1) {
+            ++stages;
+        }
+
+        uint32_t len = 1;
+        if (0 != (stages & 1)) {
+            for (uint32_t i = 0; i < 2 * fftLen; i += 4) {
+                const float re = data[i + 2];
+                const float im = data[i + 3];
+                data[i + 2] = data[i] - re;
+                data[i + 3] = data[i + 1] - im;
+                data[i] += re;
+                data[i + 1] += im;
+            }
+            len = 2;
+        }
+
+        /* Each butterfly merges four DFTs of len points, in the order two
+         * radix-2 stages would: B pairs with A, D with C, then (C, D) with
+         * (A, B). So B takes W^2k and C takes W^k, where W is of 4 * len. */
+        for (; len < fftLen; len *= 4) {
+            const uint32_t step = twiddleStride * fftLen / (4 * len);
+            for (uint32_t group = 0; group < fftLen; group += 4 * len) {
+                for (uint32_t k = 0; k < len; ++k) {
+                    float* a = data + 2 * (group + k);
+                    float* b = a + 2 * len;
+                    float* c = b + 2 * len;
+                    float* d = c + 2 * len;
+                    const float* w1 = twiddles + 2 * (k * step);
+                    const float* w2 = twiddles + 2 * (2 * k * step);
+                    const float* w3 = twiddles + 2 * (3 * k * step);
+
+                    const float t1Re = b[0] * w2[0] - b[1] * w2[1];
+                    const float t1Im = b[0] * w2[1] + b[1] * w2[0];
+                    const float t2Re = c[0] * w1[0] - c[1] * w1[1];
+                    const float t2Im = c[0] * w1[1] + c[1] * w1[0];
+                    const float t3Re = d[0] * w3[0] - d[1] * w3[1];
+                    const float t3Im = d[0] * w3[1] + d[1] * w3[0];
+
+                    const float sum01Re = a[0] + t1Re;
+                    const float sum01Im = a[1] + t1Im;
+                    const float diff01Re = a[0] - t1Re;
+                    const float diff01Im = a[1] - t1Im;
+                    const float sum23Re = t2Re + t3Re;
+                    const float sum23Im = t2Im + t3Im;
+                    const float diff23Re = t2Re - t3Re;
+                    const float diff23Im = t2Im - t3Im;
+
+                    a[0] = sum01Re + sum23Re;
+                    a[1] = sum01Im + sum23Im;
+                    c[0] = sum01Re - sum23Re;
+                    c[1] = sum01Im - sum23Im;
+                    /* -i and +i times (t2 - t3) */
+                    b[0] = diff01Re + diff23Im;
+                    b[1] = diff01Im - diff23Re;
+                    d[0] = diff01Re - diff23Im;
+                    d[1] = diff01Im + diff23Re;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief       Real FFT of a power of 2 length, packed as arm_rfft_fast_f32.
+     *              The input is treated as fftLen / 2 complex points, and the
+     *              two interleaved spectra are split apart afterwards.
+     * @param[in]   input       fftLen real points.
+     * @param[out]  fftOutput   fftLen values: [real0, realN/2, real1, im1, ...]
+     * @param[in]   twiddles    W^k pairs for fftLen.
+     * @param[in]   fftLen      FFT length.
+     */
+    static void FftRealRadix4F32(const float* input, float* fftOutput,
+                                 const float* twiddles, const uint32_t fftLen)
+    {
+        const uint32_t halfLen = fftLen / 2;
+        std::copy(input, input + fftLen, fftOutput);
+        FftComplexRadix4F32(fftOutput, halfLen, twiddles, 2);
+
+        /* Z = E + iO, with E and O the spectra of the even and odd samples:
+         * X[k] = E[k] + W^k O[k], and X[N/2 - k] = conj(E[k] - W^k O[k]). */
+        const float dcRe = fftOutput[0];
+        const float dcIm = fftOutput[1];
+        fftOutput[0] = dcRe + dcIm;
+        fftOutput[1] = dcRe - dcIm;
+
+        for (uint32_t k = 1; k <= halfLen / 2; ++k) {
+            float* zk = fftOutput + 2 * k;
+            float* zm = fftOutput + 2 * (halfLen - k);
+            const float* w = twiddles + 2 * k;
+
+            const float evenRe = 0.5f * (zk[0] + zm[0]);
+            const float evenIm = 0.5f * (zk[1] - zm[1]);
+            const float oddRe = 0.5f * (zk[1] + zm[1]);
+            const float oddIm = 0.5f * (zm[0] - zk[0]);
+
+            const float tRe = oddRe * w[0] - oddIm * w[1];
+            const float tIm = oddRe * w[1] + oddIm * w[0];
+
+            zk[0] = evenRe + tRe;
+            zk[1] = evenIm + tIm;
+            zm[0] = evenRe - tRe;
+            zm[1] = tIm - evenIm;
+        }
+    }
+#endif /* !__ARM_FEATURE_DSP */
+
     void MathUtils::FftF32(std::vector<float>& input,
                            std::vector<float>& fftOutput,
                            arm::app::math::FftInstance& fftInstance)
@@ -192,12 +342,15 @@ namespace math {
         switch (fftInstance.m_type) {
         case FftType::real:
 
-#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
             if (fftInstance.m_optimisedOptionAvailable) {
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
                 arm_rfft_fast_f32(&fftInstance.m_instanceReal, input.data(), fftOutput.data(), 0);
+#else  /* __ARM_FEATURE_DSP */
+                FftRealRadix4F32(input.data(), fftOutput.data(),
+                                 fftInstance.m_twiddles.data(), fftInstance.m_fftLen);
+#endif /* __ARM_FEATURE_DSP */
                 return;
             }
-#endif /* __ARM_FEATURE_DSP */
             FftRealF32(input, fftOutput);
             return;
 
@@ -206,13 +359,16 @@ namespace math {
                 printf_err("Complex FFT instance should have input size >= (FFT len x 2)");
                 return;
             }
-#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
             if (fftInstance.m_optimisedOptionAvailable) {
                 fftOutput = input; /* Complex function works in-place */
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
                 arm_cfft_f32(&fftInstance.m_instanceComplex, fftOutput.data(), 0, 1);
+#else  /* __ARM_FEATURE_DSP */
+                FftComplexRadix4F32(fftOutput.data(), fftInstance.m_fftLen,
+                                    fftInstance.m_twiddles.data(), 1);
+#endif /* __ARM_FEATURE_DSP */
                 return;
             }
-#endif /* __ARM_FEATURE_DSP */
             FftComplexF32(input, fftOutput);
             return;
 
@@ -236,6 +392,189 @@ namespace math {
 #endif /* __ARM_FEATURE_DSP */
     }
 
+    void MathUtils::VecLogarithmF32(float* input, float* output, const uint32_t len)
+    {
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+        arm_vlog_f32(input, output, len);
+#else  /* __ARM_FEATURE_DSP */
+        for (uint32_t i = 0; i < len; ++i) {
+            output[i] = logf(input[i]);
+        }
+#endif /* __ARM_FEATURE_DSP */
+    }
+
+    void MathUtils::VecMultiplyF32(const float* srcPtrA, const float* srcPtrB,
+                                   float* dstPtr, const uint32_t len)
+    {
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+        arm_mult_f32(srcPtrA, srcPtrB, dstPtr, len);
+#else  /* __ARM_FEATURE_DSP */
+        for (uint32_t i = 0; i < len; ++i) {
+            dstPtr[i] = srcPtrA[i] * srcPtrB[i];
+        }
+#endif /* __ARM_FEATURE_DSP */
+    }
+
+    void MathUtils::ComplexMagnitudeF32(const float* ptrSrc, float* ptrDst,
+                                        const uint32_t numSamples)
+    {
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+        arm_cmplx_mag_f32(ptrSrc, ptrDst, numSamples);
+#else  /* __ARM_FEATURE_DSP */
+        for (uint32_t j = 0; j < numSamples; ++j) {
+            const float real = *ptrSrc++;
+            const float im = *ptrSrc++;
+            *ptrDst++ = sqrtf(real*real + im*im);
+        }
+#endif /* __ARM_FEATURE_DSP */
+    }
+
+    void MathUtils::FftInitQ15(const uint16_t fftLen, FftInstanceQ15& fftInstance)
+    {
+        fftInstance.m_fftLen = fftLen;
+        fftInstance.m_initialised = false;
+        fftInstance.m_optimisedOptionAvailable = false;
+
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+        if (ARM_MATH_SUCCESS != arm_rfft_init_q15(&fftInstance.m_instanceReal, fftLen, 0, 1)) {
+            printf_err("Failed to initialise Q15 FFT for len %d\n", fftLen);
+        } else {
+            fftInstance.m_optimisedOptionAvailable = true;
+        }
+#else  /* __ARM_FEATURE_DSP */
+        /* Float FFT, rounded back to Q15 as arm_rfft_q15 would give */
+        MathUtils::FftInitF32(fftLen, fftInstance.m_instanceF32);
+        if (fftInstance.m_instanceF32.m_optimisedOptionAvailable) {
+            fftInstance.m_input = std::vector<float>(fftLen);
+            fftInstance.m_output = std::vector<float>(fftLen);
+            fftInstance.m_optimisedOptionAvailable = true;
+        }
+#endif /* __ARM_FEATURE_DSP */
+
+        debug("Optimised Q15 FFT will be used: %s.\n", fftInstance.m_optimisedOptionAvailable? "yes": "no");
+
+        fftInstance.m_initialised = true;
+    }
+
+    static int16_t SaturateQ15(int32_t value)
+    {
+        return static_cast<int16_t>(std::min<int32_t>(std::max<int32_t>(value, INT16_MIN), INT16_MAX));
+    }
+
+    void MathUtils::FftQ15(int16_t* input, int16_t* fftOutput, FftInstanceQ15& fftInstance)
+    {
+        if (!fftInstance.m_initialised) {
+            printf_err("FFT uninitialised\n");
+            return;
+        }
+
+        const uint32_t fftLen = fftInstance.m_fftLen;
+
+        if (fftInstance.m_optimisedOptionAvailable) {
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+            arm_rfft_q15(&fftInstance.m_instanceReal, input, fftOutput);
+#else  /* __ARM_FEATURE_DSP */
+            float* in = fftInstance.m_input.data();
+            float* out = fftInstance.m_output.data();
+            std::copy(input, input + fftLen, in);
+            FftRealRadix4F32(in, out, fftInstance.m_instanceF32.m_twiddles.data(), fftLen);
+
+            /* Bins 0 to fftLen / 2, scaled down by fftLen as arm_rfft_q15 */
+            const float scale = 1.0f / fftLen;
+            fftOutput[0] = SaturateQ15(static_cast<int32_t>(std::round(out[0] * scale)));
+            fftOutput[1] = 0;
+            for (uint32_t j = 2; j < fftLen; ++j) {
+                fftOutput[j] = SaturateQ15(static_cast<int32_t>(std::round(out[j] * scale)));
+            }
+            fftOutput[fftLen] = SaturateQ15(static_cast<int32_t>(std::round(out[1] * scale)));
+            fftOutput[fftLen + 1] = 0;
+#endif /* __ARM_FEATURE_DSP */
+            return;
+        }
+
+        /* DFT of bins 0 to fftLen / 2, scaled down by fftLen as arm_rfft_q15 */
+        for (uint32_t k = 0; k <= fftLen / 2; ++k) {
+            float sumReal = 0;
+            float sumImag = 0;
+            for (uint32_t t = 0; t < fftLen; ++t) {
+                const auto angle = static_cast<float>(((k * t) % fftLen) * (2 * M_PI / fftLen));
+                sumReal += input[t] * MathUtils::CosineF32(angle);
+                sumImag -= input[t] * MathUtils::SineF32(angle);
+            }
+            fftOutput[2 * k] = SaturateQ15(static_cast<int32_t>(std::round(sumReal / fftLen)));
+            fftOutput[2 * k + 1] = SaturateQ15(static_cast<int32_t>(std::round(sumImag / fftLen)));
+        }
+    }
+
+    void MathUtils::ComplexMagnitudeQ15(const int16_t* ptrSrc, int16_t* ptrDst,
+                                        const uint32_t numSamples)
+    {
+        /* The CMSIS-DSP Q15 complex functions aren't built, see cmsis-dsp.cmake;
+         * a float square root is a single instruction on the FPU anyway. */
+        for (uint32_t j = 0; j < numSamples; ++j) {
+            const int32_t real = *ptrSrc++;
+            const int32_t im = *ptrSrc++;
+            const auto power = static_cast<uint32_t>(real * real) + static_cast<uint32_t>(im * im);
+            *ptrDst++ = SaturateQ15(static_cast<int32_t>(sqrtf(static_cast<float>(power)) * 0.5f + 0.5f));
+        }
+    }
+
+    void MathUtils::VecMultiplyQ15(const int16_t* srcPtrA, const int16_t* srcPtrB,
+                                   int16_t* dstPtr, const uint32_t len)
+    {
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+        arm_mult_q15(srcPtrA, srcPtrB, dstPtr, len);
+#else  /* __ARM_FEATURE_DSP */
+        for (uint32_t i = 0; i < len; ++i) {
+            dstPtr[i] = SaturateQ15((static_cast<int32_t>(srcPtrA[i]) * srcPtrB[i]) >> 15);
+        }
+#endif /* __ARM_FEATURE_DSP */
+    }
+
+    void MathUtils::VecShiftQ15(const int16_t* srcPtr, const int8_t shift,
+                                int16_t* dstPtr, const uint32_t len)
+    {
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+        arm_shift_q15(srcPtr, shift, dstPtr, len);
+#else  /* __ARM_FEATURE_DSP */
+        for (uint32_t i = 0; i < len; ++i) {
+            const int32_t value = srcPtr[i];
+            dstPtr[i] = SaturateQ15(shift >= 0 ? value * (1 << shift) : value >> -shift);
+        }
+#endif /* __ARM_FEATURE_DSP */
+    }
+
+    int16_t MathUtils::MaxAbsQ15(const int16_t* srcPtr, const uint32_t len)
+    {
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+        q15_t result = 0;
+        arm_absmax_no_idx_q15(srcPtr, len, &result);
+        return result;
+#else  /* __ARM_FEATURE_DSP */
+        int32_t result = 0;
+        for (uint32_t i = 0; i < len; ++i) {
+            result = std::max<int32_t>(result, std::abs(static_cast<int32_t>(srcPtr[i])));
+        }
+        return SaturateQ15(result);
+#endif /* __ARM_FEATURE_DSP */
+    }
+
+    int64_t MathUtils::DotProductQ15(const int16_t* srcPtrA, const int16_t* srcPtrB,
+                                     const uint32_t srcLen)
+    {
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+        q63_t result = 0;
+        arm_dot_prod_q15(srcPtrA, srcPtrB, srcLen, &result);
+        return result;
+#else  /* __ARM_FEATURE_DSP */
+        int64_t result = 0;
+        for (uint32_t i = 0; i < srcLen; ++i) {
+            result += static_cast<int32_t>(srcPtrA[i]) * srcPtrB[i];
+        }
+        return result;
+#endif /* __ARM_FEATURE_DSP */
+    }
+
     float MathUtils::DotProductF32(float* srcPtrA, float* srcPtrB,
                                    const uint32_t srcLen)
     {
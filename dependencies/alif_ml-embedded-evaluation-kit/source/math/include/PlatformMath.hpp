@@ -42,6 +42,8 @@ namespace math {
 #if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
         arm_rfft_fast_instance_f32  m_instanceReal;
         arm_cfft_instance_f32       m_instanceComplex;
+#else /* (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)) */
+        std::vector<float>          m_twiddles;     /* (cos, -sin) pairs for power of 2 lengths. */
 #endif /* (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)) */
         uint16_t                    m_fftLen{0};
         FftType                     m_type{FftType::real};
@@ -49,6 +51,19 @@ namespace math {
         bool                        m_initialised{false};
     };
 
+    struct FftInstanceQ15 {
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+        arm_rfft_instance_q15       m_instanceReal;
+#else /* (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)) */
+        FftInstance                 m_instanceF32;
+        std::vector<float>          m_input;
+        std::vector<float>          m_output;
+#endif /* (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)) */
+        uint16_t                    m_fftLen{0};
+        bool                        m_optimisedOptionAvailable{false};
+        bool                        m_initialised{false};
+    };
+
     /* Class to provide Math functions like FFT, mean, stddev etc.
      * This will allow other classes, functions to be independent of
      * #if definition checks and provide a cleaner API. Also, it will
@@ -101,6 +116,8 @@ namespace math {
          * @brief       Initialises the internal FFT structures (if available
          *              for the platform). This function should be called
          *              prior to Fft32 function call if built with ARM DSP functions.
+         *              Without them, power of 2 lengths use a portable radix-2/4
+         *              FFT, and other lengths a DFT.
          * @param[in]   fftLen        Requested length of the FFT.
          * @param[in]   fftInstance   FFT instance struct to use.
          * @param[in]   type          FFT type (real or complex)
@@ -110,7 +127,9 @@ namespace math {
                                FftType type = FftType::real);
 
         /**
-         * @brief       Computes the FFT for the input vector.
+         * @brief       Computes the FFT for the input vector. A real FFT is
+         *              packed as arm_rfft_fast_f32 does:
+         *              [real0, realN/2, real1, im1, real2, im2, ...]
          * @param[in]   input       Floating point vector of input elements
          * @param[out]  fftOutput   Output buffer to be populated by computed FFTs.
          * @param[in]   fftInstance FFT instance struct to use.
@@ -129,6 +148,104 @@ namespace math {
         static void VecLogarithmF32(std::vector<float>& input,
                                     std::vector<float>& output);
 
+        /**
+         * @brief       Computes the natural logarithms of a floating point
+         *              array, in place or into another array.
+         * @param[in]   input    Pointer to the first input element.
+         * @param[out]  output   Pointer to the first output element.
+         * @param[in]   len      Number of elements.
+         */
+        static void VecLogarithmF32(float* input, float* output, uint32_t len);
+
+        /**
+         * @brief       Element by element product of two floating point arrays.
+         * @param[in]   srcPtrA   Pointer to the first element of first array.
+         * @param[in]   srcPtrB   Pointer to the first element of second array.
+         * @param[out]  dstPtr    Output array, can be one of the inputs.
+         * @param[in]   len       Number of elements.
+         */
+        static void VecMultiplyF32(const float* srcPtrA, const float* srcPtrB,
+                                   float* dstPtr, uint32_t len);
+
+        /**
+         * @brief       Computes the magnitude of a floating point complex
+         *              number array.
+         * @param[in]   ptrSrc       Pointer to the interleaved real, imaginary input.
+         * @param[out]  ptrDst       Output buffer, numSamples long.
+         * @param[in]   numSamples   Number of complex samples.
+         */
+        static void ComplexMagnitudeF32(const float* ptrSrc, float* ptrDst,
+                                        uint32_t numSamples);
+
+        /**
+         * @brief       Initialises the internal Q15 real FFT structures (if
+         *              available for the platform). Should be called prior
+         *              to FftQ15.
+         * @param[in]   fftLen        Requested length of the FFT.
+         * @param[in]   fftInstance   FFT instance struct to use.
+         */
+        static void FftInitQ15(uint16_t fftLen, FftInstanceQ15& fftInstance);
+
+        /**
+         * @brief       Computes the real FFT of a Q15 array, as arm_rfft_q15: the
+         *              output is interleaved real and imaginary parts, bin 0 to
+         *              fftLen / 2, scaled down by fftLen.
+         * @param[in]   input       fftLen Q15 elements, used as scratch.
+         * @param[out]  fftOutput   Output buffer of 2 x fftLen elements.
+         * @param[in]   fftInstance FFT instance struct to use.
+         */
+        static void FftQ15(int16_t* input, int16_t* fftOutput,
+                           FftInstanceQ15& fftInstance);
+
+        /**
+         * @brief       Computes the magnitude of a Q15 complex number array.
+         *              The output is in 2.14 format, as arm_cmplx_mag_q15.
+         * @param[in]   ptrSrc       Pointer to the interleaved real, imaginary input.
+         * @param[out]  ptrDst       Output buffer, numSamples long.
+         * @param[in]   numSamples   Number of complex samples.
+         */
+        static void ComplexMagnitudeQ15(const int16_t* ptrSrc, int16_t* ptrDst,
+                                        uint32_t numSamples);
+
+        /**
+         * @brief       Element by element product of two Q15 arrays, saturated.
+         * @param[in]   srcPtrA   Pointer to the first element of first array.
+         * @param[in]   srcPtrB   Pointer to the first element of second array.
+         * @param[out]  dstPtr    Output array, can be one of the inputs.
+         * @param[in]   len       Number of elements.
+         */
+        static void VecMultiplyQ15(const int16_t* srcPtrA, const int16_t* srcPtrB,
+                                   int16_t* dstPtr, uint32_t len);
+
+        /**
+         * @brief       Shifts a Q15 array left (positive shift) or right
+         *              (negative shift), saturated.
+         * @param[in]   srcPtr   Pointer to the first input element.
+         * @param[in]   shift    Number of bits to shift by.
+         * @param[out]  dstPtr   Output array, can be the input.
+         * @param[in]   len      Number of elements.
+         */
+        static void VecShiftQ15(const int16_t* srcPtr, int8_t shift,
+                                int16_t* dstPtr, uint32_t len);
+
+        /**
+         * @brief       Largest absolute value in a Q15 array, saturated.
+         * @param[in]   srcPtr   Pointer to the first element.
+         * @param[in]   len      Number of elements.
+         * @return      Largest absolute value.
+         */
+        static int16_t MaxAbsQ15(const int16_t* srcPtr, uint32_t len);
+
+        /**
+         * @brief       Computes the dot product of two Q15 arrays.
+         * @param[in]   srcPtrA   Pointer to the first element of first array.
+         * @param[in]   srcPtrB   Pointer to the first element of second array.
+         * @param[in]   srcLen    Number of elements.
+         * @return      Dot product in 34.30 format.
+         */
+        static int64_t DotProductQ15(const int16_t* srcPtrA, const int16_t* srcPtrB,
+                                     uint32_t srcLen);
+
         /**
          * @brief       Computes the dot product of two 1D floating point
          *              vectors.
@@ -180,7 +297,7 @@ namespace math {
         arm_sqrt_f32(input, &output);
         return output;
 #else  /* __ARM_FEATURE_DSP */
-        return std::sqrtf(input);
+        return sqrtf(input);
 #endif /* __ARM_FEATURE_DSP */
     }
 
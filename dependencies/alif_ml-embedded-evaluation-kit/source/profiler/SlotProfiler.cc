@@ -0,0 +1,274 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SlotProfiler.hpp"
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+namespace arm {
+namespace app {
+
+    void StdoutProfilerWriter(const void* data, size_t len, void* userData)
+    {
+        UNUSED(userData);
+        fwrite(data, 1, len, stdout);
+    }
+
+    SlotProfilerBase::SlotProfilerBase(const char* const* names, Slot* slots, const uint32_t numSlots,
+                                       uint64_t* samples, uint64_t* scratch,
+                                       const uint32_t numSamples, const uint32_t numCounters)
+    :   m_names{names},
+        m_slots{slots},
+        m_numSlots{numSlots},
+        m_samples{samples},
+        m_scratch{scratch},
+        m_numSamples{numSamples},
+        m_numCounters{numCounters}
+    {}
+
+    bool SlotProfilerBase::Start(const uint32_t slot)
+    {
+        Slot& state = this->m_slots[slot];
+        if (!state.started) {
+            state.start.initialised = false;
+            hal_pmu_get_counters(&state.start);
+            if (state.start.initialised) {
+                state.started = true;
+                return true;
+            }
+        }
+        printf_err("Failed to start profiler slot %s\n", this->m_names[slot]);
+        return false;
+    }
+
+    bool SlotProfilerBase::Stop(const uint32_t slot)
+    {
+        Slot& state = this->m_slots[slot];
+        if (state.started) {
+            pmu_counters end;
+            end.initialised = false;
+            hal_pmu_get_counters(&end);
+            state.started = false;
+            if (this->Record(slot, state.start, end)) {
+                return true;
+            }
+        }
+        printf_err("Failed to stop profiler slot %s\n", this->m_names[slot]);
+        return false;
+    }
+
+    bool SlotProfilerBase::Record(const uint32_t slot, const pmu_counters& start, const pmu_counters& end)
+    {
+        if (slot >= this->m_numSlots || end.num_counters != start.num_counters ||
+            !end.initialised || !start.initialised) {
+            printf_err("Invalid profiler slot or counters\n");
+            return false;
+        }
+
+        Slot& state = this->m_slots[slot];
+        const uint32_t numCounters = std::min(end.num_counters, this->m_numCounters);
+        const uint32_t index = state.samplesNum % this->m_numSamples;
+
+        for (uint32_t i = 0; i < numCounters; ++i) {
+            uint64_t value = 0;
+            if (end.counters[i].value < start.counters[i].value) {
+                warn("Overflow detected for %s\n", end.counters[i].name);
+            } else {
+                value = end.counters[i].value - start.counters[i].value;
+            }
+
+            state.names[i] = end.counters[i].name;
+            state.units[i] = end.counters[i].unit;
+            state.total[i] += value;
+            state.min[i] = std::min(state.min[i], value);
+            state.max[i] = std::max(state.max[i], value);
+            this->Samples(slot, i)[index] = value;
+        }
+        state.numCounters = numCounters;
+        ++state.samplesNum;
+        return true;
+    }
+
+    uint64_t* SlotProfilerBase::Samples(const uint32_t slot, const uint32_t counter) const
+    {
+        return this->m_samples + (slot * this->m_numCounters + counter) * this->m_numSamples;
+    }
+
+    uint32_t SlotProfilerBase::StoredNum(const uint32_t slot) const
+    {
+        return std::min(this->m_slots[slot].samplesNum, this->m_numSamples);
+    }
+
+    uint32_t SlotProfilerBase::NumSlots() const
+    {
+        return this->m_numSlots;
+    }
+
+    uint32_t SlotProfilerBase::NumCounters(const uint32_t slot) const
+    {
+        return slot < this->m_numSlots ? this->m_slots[slot].numCounters : 0;
+    }
+
+    const char* SlotProfilerBase::SlotName(const uint32_t slot) const
+    {
+        return slot < this->m_numSlots ? this->m_names[slot] : "";
+    }
+
+    /* Nearest rank percentile of sorted values. */
+    static uint64_t Percentile(const uint64_t* sorted, const uint32_t count, const uint32_t percent)
+    {
+        const uint32_t rank = (percent * count + 99) / 100;
+        return sorted[rank > 0 ? rank - 1 : 0];
+    }
+
+    bool SlotProfilerBase::GetStatistics(const uint32_t slot, const uint32_t counter, SlotStatistics& stats)
+    {
+        if (counter >= this->NumCounters(slot)) {
+            return false;
+        }
+
+        const Slot& state = this->m_slots[slot];
+        const uint32_t stored = this->StoredNum(slot);
+        const uint64_t* samples = this->Samples(slot, counter);
+        std::copy(samples, samples + stored, this->m_scratch);
+        std::sort(this->m_scratch, this->m_scratch + stored);
+
+        stats.name = state.names[counter];
+        stats.unit = state.units[counter];
+        stats.samplesNum = state.samplesNum;
+        stats.storedNum = stored;
+        stats.total = state.total[counter];
+        stats.avrg = static_cast<double>(state.total[counter]) / state.samplesNum;
+        stats.min = state.min[counter];
+        stats.max = state.max[counter];
+        stats.p50 = Percentile(this->m_scratch, stored, 50);
+        stats.p95 = Percentile(this->m_scratch, stored, 95);
+        stats.p99 = Percentile(this->m_scratch, stored, 99);
+        return true;
+    }
+
+    void SlotProfilerBase::Reset()
+    {
+        for (uint32_t slot = 0; slot < this->m_numSlots; ++slot) {
+            Slot& state = this->m_slots[slot];
+            state.started = false;
+            state.numCounters = 0;
+            state.samplesNum = 0;
+            std::fill(std::begin(state.total), std::end(state.total), 0);
+            std::fill(std::begin(state.min), std::end(state.min), UINT64_MAX);
+            std::fill(std::begin(state.max), std::end(state.max), 0);
+        }
+    }
+
+    void SlotProfilerBase::PrintProfilingResult()
+    {
+        SlotStatistics stats{};
+        for (uint32_t slot = 0; slot < this->m_numSlots; ++slot) {
+            if (this->NumCounters(slot) == 0) {
+                continue;
+            }
+            info("Profile for %s (%" PRIu32 " samples):\n", this->m_names[slot],
+                 this->m_slots[slot].samplesNum);
+            info("%s\n", "Avg. / Min / Max / P50 / P95 / P99");
+
+            for (uint32_t counter = 0; this->GetStatistics(slot, counter, stats); ++counter) {
+                info("%s %s: %.0f / %" PRIu64 " / %" PRIu64 " / %" PRIu64 " / %" PRIu64 " / %" PRIu64 "\n",
+                     stats.name, stats.unit, stats.avrg, stats.min, stats.max,
+                     stats.p50, stats.p95, stats.p99);
+            }
+        }
+    }
+
+    void SlotProfilerBase::ExportCsv(ProfilerWriter writer, void* userData)
+    {
+        static const char header[] = "slot,counter,unit,samples,total,avg,min,max,p50,p95,p99\n";
+        writer(header, sizeof(header) - 1, userData);
+
+        char line[160];
+        SlotStatistics stats{};
+        for (uint32_t slot = 0; slot < this->m_numSlots; ++slot) {
+            for (uint32_t counter = 0; this->GetStatistics(slot, counter, stats); ++counter) {
+                const int len = snprintf(line, sizeof(line),
+                    "%s,%s,%s,%" PRIu32 ",%" PRIu64 ",%.1f,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+                    this->m_names[slot], stats.name, stats.unit, stats.samplesNum, stats.total,
+                    stats.avrg, stats.min, stats.max, stats.p50, stats.p95, stats.p99);
+                if (len > 0) {
+                    writer(line, std::min<size_t>(len, sizeof(line) - 1), userData);
+                }
+            }
+        }
+    }
+
+    /* Little endian, whatever the host. */
+    template<typename T>
+    static void WriteValue(ProfilerWriter writer, void* userData, T value)
+    {
+        uint8_t bytes[sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+        writer(bytes, sizeof(T), userData);
+    }
+
+    static void WriteString(ProfilerWriter writer, void* userData, const char* str)
+    {
+        const size_t len = str ? std::min<size_t>(strlen(str), UINT8_MAX) : 0;
+        WriteValue<uint8_t>(writer, userData, len);
+        if (len > 0) {
+            writer(str, len, userData);
+        }
+    }
+
+    void SlotProfilerBase::ExportBinary(ProfilerWriter writer, void* userData)
+    {
+        static const uint8_t magic[] = {'S', 'P', 'R', 'F', 1};
+        writer(magic, sizeof(magic), userData);
+        WriteValue<uint8_t>(writer, userData, this->m_numSlots);
+
+        for (uint32_t slot = 0; slot < this->m_numSlots; ++slot) {
+            const Slot& state = this->m_slots[slot];
+            const uint32_t stored = this->StoredNum(slot);
+            /* Oldest first: once the ring has wrapped, that's the next to be replaced. */
+            const uint32_t oldest = state.samplesNum > this->m_numSamples ?
+                                    state.samplesNum % this->m_numSamples : 0;
+
+            WriteString(writer, userData, this->m_names[slot]);
+            WriteValue<uint32_t>(writer, userData, state.samplesNum);
+            WriteValue<uint16_t>(writer, userData, stored);
+            WriteValue<uint8_t>(writer, userData, state.numCounters);
+
+            for (uint32_t counter = 0; counter < state.numCounters; ++counter) {
+                WriteString(writer, userData, state.names[counter]);
+                WriteString(writer, userData, state.units[counter]);
+                WriteValue<uint64_t>(writer, userData, state.total[counter]);
+                WriteValue<uint64_t>(writer, userData, state.min[counter]);
+                WriteValue<uint64_t>(writer, userData, state.max[counter]);
+
+                const uint64_t* samples = this->Samples(slot, counter);
+                for (uint32_t i = 0; i < stored; ++i) {
+                    WriteValue<uint64_t>(writer, userData, samples[(oldest + i) % this->m_numSamples]);
+                }
+            }
+        }
+    }
+
+} /* namespace app */
+} /* namespace arm */
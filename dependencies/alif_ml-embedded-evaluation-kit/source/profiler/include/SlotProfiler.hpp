@@ -0,0 +1,234 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef APP_SLOT_PROFILER_HPP
+#define APP_SLOT_PROFILER_HPP
+
+#include "hal.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /** Statistics for one counter of a profiling slot. */
+    struct SlotStatistics {
+        const char*     name;
+        const char*     unit;
+        std::uint32_t   samplesNum;     /* Measurements since the last reset. */
+        std::uint32_t   storedNum;      /* The latest of those, kept for percentiles. */
+        std::uint64_t   total;
+        double          avrg;
+        std::uint64_t   min;
+        std::uint64_t   max;
+        std::uint64_t   p50;            /* Percentiles of the stored measurements. */
+        std::uint64_t   p95;
+        std::uint64_t   p99;
+    };
+
+    /** Receives exported profiling data, a piece at a time. */
+    using ProfilerWriter = void (*)(const void* data, size_t len, void* userData);
+
+    /** @brief  ProfilerWriter for stdout, which is the UART on target. */
+    void StdoutProfilerWriter(const void* data, size_t len, void* userData);
+
+    /**
+     * @brief   The part of SlotProfiler that doesn't depend on its sizes.
+     *          Holds no storage of its own.
+     */
+    class SlotProfilerBase {
+    public:
+        SlotProfilerBase(const SlotProfilerBase&) = delete;
+        SlotProfilerBase& operator=(const SlotProfilerBase&) = delete;
+
+        /**
+         * @brief       Records a measurement taken elsewhere against a slot.
+         * @param[in]   slot    Slot index.
+         * @param[in]   start   Counters at the start of the measurement.
+         * @param[in]   end     Counters at the end of the measurement.
+         * @return      true if recorded, false if the slot or counters are invalid.
+         **/
+        bool Record(std::uint32_t slot, const pmu_counters& start, const pmu_counters& end);
+
+        /**
+         * @brief       Gets the statistics for one counter of a slot. Sorts
+         *              the stored samples, so call it outside timed regions.
+         * @param[in]   slot      Slot index.
+         * @param[in]   counter   Counter index, below NumCounters(slot).
+         * @param[out]  stats     Statistics.
+         * @return      true if the slot has samples for that counter.
+         **/
+        bool GetStatistics(std::uint32_t slot, std::uint32_t counter, SlotStatistics& stats);
+
+        /** @brief  Number of slots. */
+        std::uint32_t NumSlots() const;
+
+        /** @brief  Number of counters recorded for a slot, 0 until its first sample. */
+        std::uint32_t NumCounters(std::uint32_t slot) const;
+
+        /** @brief  Name of a slot. */
+        const char* SlotName(std::uint32_t slot) const;
+
+        /** @brief  Clears all samples and stops all slots. */
+        void Reset();
+
+        /** @brief  Prints the statistics of every slot with samples. */
+        void PrintProfilingResult();
+
+        /**
+         * @brief       Exports the statistics of every slot and counter as CSV,
+         *              with a header line.
+         * @param[in]   writer     Destination of the text.
+         * @param[in]   userData   Passed to writer.
+         **/
+        void ExportCsv(ProfilerWriter writer = StdoutProfilerWriter, void* userData = nullptr);
+
+        /**
+         * @brief       Exports every counter with its stored samples, oldest
+         *              first, in a compact little endian binary format:
+         *
+         *              "SPRF", u8 version (1), u8 slots, then per slot:
+         *                u8 name length, name, u32 samplesNum, u16 storedNum,
+         *                u8 counters, then per counter:
+         *                  u8 name length, name, u8 unit length, unit,
+         *                  u64 total, u64 min, u64 max, u64 samples[storedNum]
+         *
+         * @param[in]   writer     Destination of the data.
+         * @param[in]   userData   Passed to writer.
+         **/
+        void ExportBinary(ProfilerWriter writer = StdoutProfilerWriter, void* userData = nullptr);
+
+    protected:
+        /** Per slot state. */
+        struct Slot {
+            pmu_counters    start;                                  /* Counters when started. */
+            bool            started;
+            std::uint32_t   numCounters;
+            std::uint32_t   samplesNum;
+            const char*     names[NUM_PMU_COUNTERS];
+            const char*     units[NUM_PMU_COUNTERS];
+            std::uint64_t   total[NUM_PMU_COUNTERS];
+            std::uint64_t   min[NUM_PMU_COUNTERS];
+            std::uint64_t   max[NUM_PMU_COUNTERS];
+        };
+
+        /**
+         * @brief       Constructor, over storage owned by SlotProfiler.
+         * @param[in]   names            Name of each slot.
+         * @param[in]   slots            State of each slot.
+         * @param[in]   numSlots         Number of slots.
+         * @param[in]   samples          Sample rings, numSamples per counter per slot.
+         * @param[in]   scratch          numSamples values for sorting.
+         * @param[in]   numSamples       Samples kept per counter.
+         * @param[in]   numCounters      Counters kept per slot, at most NUM_PMU_COUNTERS.
+         **/
+        SlotProfilerBase(const char* const* names, Slot* slots, std::uint32_t numSlots,
+                         std::uint64_t* samples, std::uint64_t* scratch,
+                         std::uint32_t numSamples, std::uint32_t numCounters);
+
+        ~SlotProfilerBase() = default;
+
+        /** @brief  Gets the starting counters for a slot. */
+        bool Start(std::uint32_t slot);
+
+        /** @brief  Gets the ending counters for a slot and records the measurement. */
+        bool Stop(std::uint32_t slot);
+
+    private:
+        const char* const*  m_names;
+        Slot*               m_slots;
+        std::uint32_t       m_numSlots;
+        std::uint64_t*      m_samples;
+        std::uint64_t*      m_scratch;
+        std::uint32_t       m_numSamples;
+        std::uint32_t       m_numCounters;
+
+        /** @brief  Sample ring for one counter of one slot. */
+        std::uint64_t* Samples(std::uint32_t slot, std::uint32_t counter) const;
+
+        /** @brief  Number of samples held in each ring of a slot. */
+        std::uint32_t StoredNum(std::uint32_t slot) const;
+    };
+
+    /**
+     * @brief   A profiler with a fixed set of slots, known at compile time,
+     *          and no allocation or string handling while measuring. Each
+     *          slot keeps running totals, and the latest NSamples values of
+     *          each counter for percentiles.
+     *
+     *          Slots are identified by constants, with a name for each:
+     *
+     *              constexpr uint32_t kInference = 0;
+     *              constexpr uint32_t kPostProcess = 1;
+     *              constexpr const char* kSlotNames[] = {"inference", "postprocess"};
+     *              SlotProfiler<2, 64> profiler{kSlotNames};
+     *
+     *              profiler.Start<kInference>();
+     *              ...
+     *              profiler.Stop<kInference>();
+     *
+     * @tparam  NSlots      Number of slots.
+     * @tparam  NSamples    Samples kept per counter, for percentiles.
+     * @tparam  NCounters   Counters kept per slot, the first of those the
+     *                        platform gives.
+     */
+    template<std::uint32_t NSlots, std::uint32_t NSamples,
+             std::uint32_t NCounters = NUM_PMU_COUNTERS>
+    class SlotProfiler : public SlotProfilerBase {
+        static_assert(NSlots > 0 && NSlots <= UINT8_MAX, "Slots must fit the export format");
+        static_assert(NSamples > 0 && NSamples <= UINT16_MAX, "Samples must fit the export format");
+        static_assert(NCounters > 0 && NCounters <= NUM_PMU_COUNTERS, "Too many counters");
+
+    public:
+        /**
+         * @brief       Constructor
+         * @param[in]   names   Name of each slot, which must outlive the profiler.
+         **/
+        explicit SlotProfiler(const char* const (&names)[NSlots])
+        :   SlotProfilerBase(names, m_slotState, NSlots, m_sampleRings, m_sortScratch,
+                             NSamples, NCounters)
+        {
+            /* The storage is only initialised once the base is constructed */
+            this->Reset();
+        }
+
+        /** @brief  Starts measuring a slot. */
+        template<std::uint32_t Slot>
+        bool Start()
+        {
+            static_assert(Slot < NSlots, "No such profiling slot");
+            return SlotProfilerBase::Start(Slot);
+        }
+
+        /** @brief  Stops measuring a slot and records the measurement. */
+        template<std::uint32_t Slot>
+        bool Stop()
+        {
+            static_assert(Slot < NSlots, "No such profiling slot");
+            return SlotProfilerBase::Stop(Slot);
+        }
+
+    private:
+        SlotProfilerBase::Slot  m_slotState[NSlots]{};
+        std::uint64_t           m_sampleRings[NSlots * NCounters * NSamples]{};
+        std::uint64_t           m_sortScratch[NSamples]{};
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* APP_SLOT_PROFILER_HPP */
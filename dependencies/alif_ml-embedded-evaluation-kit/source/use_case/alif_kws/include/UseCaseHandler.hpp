@@ -30,10 +30,20 @@
 #define ALIF_KWS_EVT_HANDLER_HPP
 
 #include "AppContext.hpp"
+#include "SlotProfiler.hpp"
 
 namespace alif {
 namespace app {
 
+    /* Stages of each stride timed by the KWS profiler. */
+    constexpr uint32_t kKwsFeatures = 0;
+    constexpr uint32_t kKwsInference = 1;
+    constexpr uint32_t kKwsPostProcess = 2;
+    constexpr const char* kKwsStageNames[] = {"features", "inference", "postprocess"};
+
+    /* Keeps the latest 32 strides of each stage for percentiles. */
+    using KwsStageProfiler = arm::app::SlotProfiler<3, 32>;
+
     /**
      * @brief       Handles the inference event.
      * @param[in]   ctx         Pointer to the application context.
@@ -67,6 +67,8 @@ void main_loop()
 
     arm::app::Profiler profiler{"kws"};
     caseContext.Set<arm::app::Profiler&>("profiler", profiler);
+    alif::app::KwsStageProfiler stageProfiler{alif::app::kKwsStageNames};
+    caseContext.Set<alif::app::KwsStageProfiler&>("stageProfiler", stageProfiler);
     caseContext.Set<arm::app::Model&>("model", model);
     caseContext.Set<int>("frameLength", arm::app::kws::g_FrameLength);
     caseContext.Set<int>("frameStride", arm::app::kws::g_FrameStride);
@@ -37,9 +37,12 @@
 #include "KwsResult.hpp"
 #include "log_macros.h"
 #include "KwsProcessing.hpp"
+#include "MicroNetKwsMfcc.hpp"
+#include "PackedMfcc.hpp"
 #include "services_lib_api.h"
 #include "services_main.h"
 
+#include <cstring>
 #include <vector>
 
 extern uint32_t m55_comms_handle;
@@ -50,15 +53,15 @@ using arm::app::Profiler;
 using arm::app::ClassificationResult;
 using arm::app::ApplicationContext;
 using arm::app::Model;
-using arm::app::KwsPreProcess;
 using arm::app::KwsPostProcess;
 using arm::app::MicroNetKwsModel;
 
 #define AUDIO_SAMPLES 16000 // 16k samples/sec, 1sec sample
 #define AUDIO_STRIDE 8000 // 0.5 seconds
+#define AUDIO_SLICES 3 // one stride being classified, the rest filling
 #define RESULTS_MEMORY 8
 
-static int16_t audio_inf[AUDIO_SAMPLES + AUDIO_STRIDE];
+static int16_t audio_ring[AUDIO_SLICES * AUDIO_STRIDE];
 
 namespace alif {
 namespace app {
@@ -102,10 +105,103 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
 }
 
 
+    /**
+     * @brief   Circular cache of the MFCC feature columns of one inference
+     *          window. Each stride computes only the columns of the new audio,
+     *          over the oldest ones, and the input tensor is written starting
+     *          from the oldest column, so nothing already computed is redone
+     *          or shifted.
+     */
+    class MfccColumnCache {
+    public:
+        /**
+         * @brief       Constructor
+         * @param[in]   inputTensor   Model input tensor, int8 quantised or float.
+         * @param[in]   numColumns    MFCC frames in the inference window.
+         * @param[in]   numFeatures   MFCC features in each frame.
+         * @param[in]   frameLength   Audio samples in each MFCC frame.
+         **/
+        MfccColumnCache(TfLiteTensor* inputTensor, size_t numColumns,
+                        size_t numFeatures, size_t frameLength)
+        :   m_mfcc{audio::MicroNetKwsMFCC::GetParams(numFeatures, frameLength)},
+            m_inputTensor{inputTensor},
+            m_numColumns{numColumns}
+        {
+            if (kTfLiteAffineQuantization == inputTensor->quantization.type) {
+                auto* quantParams = static_cast<TfLiteAffineQuantization*>(
+                                        inputTensor->quantization.params);
+                this->m_quantised = true;
+                this->m_quantScale = quantParams->scale->data[0];
+                this->m_quantOffset = quantParams->zero_point->data[0];
+                this->m_columnBytes = numFeatures * sizeof(int8_t);
+            } else {
+                this->m_columnBytes = numFeatures * sizeof(float);
+            }
+            this->m_columns = std::vector<uint8_t>(numColumns * this->m_columnBytes);
+        }
+
+        /**
+         * @brief       Sets every column to the features of one frame.
+         * @param[in]   frame   frameLength audio samples.
+         **/
+        void Fill(const int16_t* frame)
+        {
+            this->m_head = 0;
+            this->Push(frame);
+            for (size_t i = 1; i < this->m_numColumns; ++i) {
+                std::memcpy(this->m_columns.data() + i * this->m_columnBytes,
+                            this->m_columns.data(), this->m_columnBytes);
+            }
+            this->m_head = 0;
+        }
+
+        /**
+         * @brief       Computes the features of the newest frame over the
+         *              oldest column.
+         * @param[in]   frame   frameLength audio samples.
+         **/
+        void Push(const int16_t* frame)
+        {
+            uint8_t* column = this->m_columns.data() + this->m_head * this->m_columnBytes;
+            if (this->m_quantised) {
+                this->m_mfcc.MfccComputeQuant<int8_t>(frame, this->m_quantScale, this->m_quantOffset,
+                                                      reinterpret_cast<int8_t*>(column));
+            } else {
+                this->m_mfcc.MfccCompute(frame, reinterpret_cast<float*>(column));
+            }
+            if (++this->m_head == this->m_numColumns) {
+                this->m_head = 0;
+            }
+        }
+
+        /** @brief  Writes the columns to the input tensor, oldest first. */
+        void WriteTensor() const
+        {
+            auto* tensorData = tflite::GetTensorData<uint8_t>(this->m_inputTensor);
+            const size_t headBytes = this->m_head * this->m_columnBytes;
+            const size_t tailBytes = this->m_columns.size() - headBytes;
+
+            std::memcpy(tensorData, this->m_columns.data() + headBytes, tailBytes);
+            std::memcpy(tensorData + tailBytes, this->m_columns.data(), headBytes);
+        }
+
+    private:
+        audio::PackedMfcc       m_mfcc;
+        TfLiteTensor*           m_inputTensor;
+        size_t                  m_numColumns;
+        bool                    m_quantised{false};
+        float                   m_quantScale{1.0f};
+        int                     m_quantOffset{0};
+        size_t                  m_columnBytes{0};
+        size_t                  m_head{0};      /* Oldest column, and next to be replaced. */
+        std::vector<uint8_t>    m_columns;
+    };
+
     /* KWS inference handler. */
     bool ClassifyAudioHandler(ApplicationContext& ctx)
     {
         auto& profiler = ctx.Get<Profiler&>("profiler");
+        auto& stageProfiler = ctx.Get<KwsStageProfiler&>("stageProfiler");
         auto& model = ctx.Get<Model&>("model");
         const auto mfccFrameLength = ctx.Get<int>("frameLength");
         const auto mfccFrameStride = ctx.Get<int>("frameStride");
@@ -132,18 +228,41 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
             return false;
         }
 
+        const bool quantised = kTfLiteAffineQuantization == inputTensor->quantization.type;
+        if ((quantised && inputTensor->type != kTfLiteInt8) ||
+            (!quantised && inputTensor->type != kTfLiteFloat32)) {
+            printf_err("Tensor type %s not supported\n", TfLiteTypeGetName(inputTensor->type));
+            return false;
+        }
+
         /* Get input shape for feature extraction. */
         TfLiteIntArray* inputShape = model.GetInputShape(0);
         const uint32_t numMfccFeatures = inputShape->data[MicroNetKwsModel::ms_inputColsIdx];
         const uint32_t numMfccFrames = inputShape->data[arm::app::MicroNetKwsModel::ms_inputRowsIdx];
 
+        /* Each stride brings whole MFCC frames, and the window the model sees
+         * must be the one we capture. Audio from before a stride that a new
+         * frame needs is kept in stridePrefix. */
+        const int mfccOverlap = mfccFrameLength - mfccFrameStride;
+        const uint32_t numNewFrames = AUDIO_STRIDE / mfccFrameStride;
+        if (mfccOverlap < 0 || mfccOverlap > AUDIO_STRIDE ||
+            0 != AUDIO_STRIDE % mfccFrameStride || numNewFrames > numMfccFrames ||
+            numMfccFrames * mfccFrameStride + mfccOverlap != AUDIO_SAMPLES) {
+            printf_err("MFCC frames (%" PRIu32 " of %d, stride %d) don't fit %d sample strides\n",
+                       numMfccFrames, mfccFrameLength, mfccFrameStride, AUDIO_STRIDE);
+            return false;
+        }
+
         /* We expect to be sampling 1 second worth of data at a time.
         *  NOTE: This is only used for time stamp calculation. */
         const float secondsPerSample = 1.0f / audioRate;
 
-        /* Set up pre and post-processing. */
-        KwsPreProcess preProcess = KwsPreProcess(inputTensor, numMfccFeatures, numMfccFrames,
-                                                 mfccFrameLength, mfccFrameStride);
+        /* Set up pre and post-processing. Until audio arrives, the window is
+         * silence. */
+        MfccColumnCache mfccColumns(inputTensor, numMfccFrames, numMfccFeatures, mfccFrameLength);
+        std::vector<int16_t> stridePrefix(mfccOverlap, 0);
+        std::vector<int16_t> mfccFrame(mfccFrameLength, 0);
+        mfccColumns.Fill(mfccFrame.data());
 
         std::vector<ClassificationResult> singleInfResult;
         KwsPostProcess postProcess = KwsPostProcess(outputTensor, ctx.Get<KwsClassifier &>("classifier"),
@@ -162,55 +281,89 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
             audio_inited = true;
         }
 
-        // Start first fill of final stride section of buffer
-        hal_get_audio_data(audio_inf + AUDIO_SAMPLES, AUDIO_STRIDE);
+        // Capture continuously into the ring, one stride per slice, so nothing is lost while we process
+        int err = hal_audio_stream_start(audio_ring, AUDIO_SLICES * AUDIO_STRIDE, AUDIO_STRIDE);
+        if (err) {
+            printf_err("hal_audio_stream_start failed with error: %d\n", err);
+            return false;
+        }
+
+        /* The slots only read the counters. The inference profiler resets
+         * them each stride, which happens between slots. */
+        hal_pmu_reset();
+        info("Profiling keys: p = print, c = CSV, b = binary export, r = reset\n");
 
         do {
-            // Wait until stride buffer is full - initiated above or by previous interation of loop
-            int err = hal_wait_for_audio();
-            if (err) {
-                printf_err("hal_get_audio_data failed with error: %d\n", err);
+            // Wait until the next stride is in
+            int16_t* stride = hal_audio_stream_get_slice();
+            if (!stride) {
+                printf_err("hal_audio_stream_get_slice failed\n");
+                hal_audio_stream_stop();
                 return false;
             }
 
-            // move buffer down by one stride, clearing space at the end for the next stride
-            std::copy(audio_inf + AUDIO_STRIDE, audio_inf + AUDIO_STRIDE + AUDIO_SAMPLES, audio_inf);
-
-            // start receiving the next stride immediately before we start heavy processing, so as not to lose anything
-            hal_get_audio_data(audio_inf + AUDIO_SAMPLES, AUDIO_STRIDE);
-
-            hal_audio_preprocessing(audio_inf + AUDIO_SAMPLES - AUDIO_STRIDE, AUDIO_STRIDE);
-
-            const int16_t* inferenceWindow = audio_inf;
+            hal_audio_preprocessing(stride, AUDIO_STRIDE);
 
+            stageProfiler.Start<kKwsFeatures>();
             uint32_t start = ARM_PMU_Get_CCNTR();
-            /* Run the pre-processing, inference and post-processing. */
-            if (!preProcess.DoPreProcess(inferenceWindow, index)) {
-                printf_err("Pre-processing failed.");
-                return false;
+            /* Only the frames ending in this stride are new. Frame k starts
+             * mfccOverlap samples before the stride, plus k frame strides. */
+            for (uint32_t k = 0; k < numNewFrames; ++k) {
+                const int frameStart = static_cast<int>(k) * mfccFrameStride - mfccOverlap;
+                if (frameStart >= 0) {
+                    mfccColumns.Push(stride + frameStart);
+                } else {
+                    std::copy(stridePrefix.end() + frameStart, stridePrefix.end(), mfccFrame.begin());
+                    std::copy(stride, stride + mfccFrameLength + frameStart, mfccFrame.begin() - frameStart);
+                    mfccColumns.Push(mfccFrame.data());
+                }
             }
-            printf("Preprocessing time = %.3f ms\n", (double) (ARM_PMU_Get_CCNTR() - start) / SystemCoreClock * 1000);
-
+            std::copy(stride + AUDIO_STRIDE - mfccOverlap, stride + AUDIO_STRIDE, stridePrefix.begin());
+            hal_audio_stream_release_slice();
+
+            mfccColumns.WriteTensor();
+            const uint32_t preprocessingCycles = ARM_PMU_Get_CCNTR() - start;
+            stageProfiler.Stop<kKwsFeatures>();
+
+            /* Every cached column would have cost about as much as a new one. */
+            const uint32_t cachedFrames = numMfccFrames - numNewFrames;
+            printf("Preprocessing time = %.3f ms, %" PRIu32 " cycles for %" PRIu32
+                   " new MFCC frames, ~%" PRIu32 " cycles saved by %" PRIu32 " cached\n",
+                   (double) preprocessingCycles / SystemCoreClock * 1000, preprocessingCycles,
+                   numNewFrames, preprocessingCycles / numNewFrames * cachedFrames, cachedFrames);
+
+            /* As RunInference(model, profiler), with the slot inside the
+             * profiler's PMU reset. */
+            profiler.StartProfiling("Inference");
+            stageProfiler.Start<kKwsInference>();
             start = ARM_PMU_Get_CCNTR();
-            if (!RunInference(model, profiler)) {
+            const bool inferenceOk = model.RunInference();
+            const uint32_t inferenceCycles = ARM_PMU_Get_CCNTR() - start;
+            stageProfiler.Stop<kKwsInference>();
+            profiler.StopProfiling();
+            if (!inferenceOk) {
                 printf_err("Inference failed.");
+                hal_audio_stream_stop();
                 return false;
             }
-            printf("Inference time = %.3f ms\n", (double) (ARM_PMU_Get_CCNTR() - start) / SystemCoreClock * 1000);
+            printf("Inference time = %.3f ms\n", (double) inferenceCycles / SystemCoreClock * 1000);
 
+            stageProfiler.Start<kKwsPostProcess>();
             start = ARM_PMU_Get_CCNTR();
             if (!postProcess.DoPostProcess()) {
                 printf_err("Post-processing failed.");
+                hal_audio_stream_stop();
                 return false;
             }
             printf("Postprocessing time = %.3f ms\n", (double) (ARM_PMU_Get_CCNTR() - start) / SystemCoreClock * 1000);
+            stageProfiler.Stop<kKwsPostProcess>();
 
             /* Add results from this window to our final results vector. */
             if (infResults.size() == RESULTS_MEMORY) {
                 infResults.erase(infResults.begin());
             }
             infResults.emplace_back(kws::KwsResult(singleInfResult,
-                    index * secondsPerSample * preProcess.m_audioDataStride,
+                    index * secondsPerSample * AUDIO_STRIDE,
                     index, scoreThreshold));
 
             send_msg_if_needed(infResults.back());
@@ -222,11 +375,31 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
             hal_lcd_clear(COLOR_BLACK);
 
             if (!PresentInferenceResult(infResults)) {
+                hal_audio_stream_stop();
                 return false;
             }
 
+            /* NPU and CPU counters of this stride's inference */
             profiler.PrintProfilingResult();
 
+            switch (hal_get_user_char()) {
+            case 'p':
+                stageProfiler.PrintProfilingResult();
+                break;
+            case 'c':
+                stageProfiler.ExportCsv();
+                break;
+            case 'b':
+                stageProfiler.ExportBinary();
+                break;
+            case 'r':
+                stageProfiler.Reset();
+                info("Profiling reset\n");
+                break;
+            default:
+                break;
+            }
+
             ++index;
 
         } while (true);
@@ -0,0 +1,391 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Checks the camera image processing kernels (scalar builds) against double
+ * precision references, and reports their error and time per output pixel.
+ */
+extern "C" {
+#include "image_processing.h"
+}
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct ErrorStats {
+    uint32_t max = 0;
+    double mean = 0;
+};
+
+/* Random noise is the worst case for the interpolators - every sample sits on an edge. */
+std::vector<uint8_t> RandomImage(size_t bytes, uint32_t seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<uint8_t> image(bytes);
+    for (auto &b : image) {
+        b = dist(gen);
+    }
+    return image;
+}
+
+/* Exact bilinear resize of RGB888. As in the kernels, the first sample is half a
+ * source pixel in, and the rest follow at the exact scale factor.
+ * Like the kernels, the second tap is read from the next pixel in memory, so the
+ * source needs one spare row and pixel. */
+std::vector<double> ReferenceResize(const uint8_t *src, int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+{
+    std::vector<double> dst(dstWidth * dstHeight * RGB_BYTES);
+    const double x_step = double(srcWidth) / dstWidth;
+    const double y_step = double(srcHeight) / dstHeight;
+    const int stride = srcWidth * RGB_BYTES;
+
+    for (int y = 0; y < dstHeight; y++) {
+        const double sy = 0.5 + y * y_step;
+        const int ty = int(sy);
+        const double y_frac = sy - ty;
+        for (int x = 0; x < dstWidth; x++) {
+            const double sx = 0.5 + x * x_step;
+            const int tx = int(sx);
+            const double x_frac = sx - tx;
+            const uint8_t *s = src + ty * stride + tx * RGB_BYTES;
+            for (int c = 0; c < RGB_BYTES; c++) {
+                const double top = s[c] * (1 - x_frac) + s[c + RGB_BYTES] * x_frac;
+                const double bottom = s[c + stride] * (1 - x_frac) + s[c + stride + RGB_BYTES] * x_frac;
+                dst[(y * dstWidth + x) * RGB_BYTES + c] = top * (1 - y_frac) + bottom * y_frac;
+            }
+        }
+    }
+    return dst;
+}
+
+ErrorStats CompareToReference(const uint8_t *out, const std::vector<double> &ref)
+{
+    ErrorStats stats;
+    double sum = 0;
+    for (size_t i = 0; i < ref.size(); i++) {
+        const double err = std::fabs(out[i] - ref[i]);
+        stats.max = std::max(stats.max, uint32_t(std::ceil(err - 0.5))); // in whole LSBs, after rounding
+        sum += err;
+    }
+    stats.mean = sum / ref.size();
+    return stats;
+}
+
+/* dc1394 "simple" demosaic of a BGGR tile: each pixel from the 2x2 quad to its
+ * bottom right, with a black last row and column. */
+void ReferenceDemosaic(const uint8_t *bayer, uint8_t *rgb)
+{
+    for (uint32_t y = 0; y < CIMAGE_Y; y++) {
+        for (uint32_t x = 0; x < CIMAGE_X; x++) {
+            uint8_t *d = rgb + (y * CIMAGE_X + x) * RGB_BYTES;
+            if (x == CIMAGE_X - 1 || y == CIMAGE_Y - 1) {
+                d[0] = d[1] = d[2] = 0;
+                continue;
+            }
+            const uint8_t *p = bayer + y * CIMAGE_X + x;
+            // position of the red and blue samples in the quad
+            const uint32_t phase = ((y & 1) << 1) | (x & 1);
+            const uint8_t quad[4] = { p[0], p[1], p[CIMAGE_X], p[CIMAGE_X + 1] };
+            const uint32_t red = 3 - phase, blue = phase;
+            d[0] = quad[red];
+            d[2] = quad[blue];
+            // greens are the other diagonal
+            d[1] = (quad[red ^ 1] + quad[red ^ 2] + 1) >> 1;
+        }
+    }
+}
+
+} /* namespace */
+
+TEST_CASE("Common: Image processing resize variants")
+{
+    const struct { int srcWidth, srcHeight, dstWidth, dstHeight; } sizes[] = {
+        { CIMAGE_X, CIMAGE_Y, 96, 96 },
+        { CIMAGE_X, CIMAGE_Y, 160, 160 },
+        { CIMAGE_X, CIMAGE_Y, 224, 224 },
+        { CIMAGE_X, CIMAGE_Y, 320, 320 },
+        { CIMAGE_X, CIMAGE_Y, CIMAGE_OUT_MAX_X, CIMAGE_OUT_MAX_Y },
+        { CIMAGE_X, 315, 160, 90 },
+        { 101, 67, 33, 21 },
+    };
+
+    REQUIRE(resize_variant_count == 3);
+
+    for (uint32_t v = 0; v < resize_variant_count; v++) {
+        const resize_variant_t &variant = resize_variants[v];
+
+        for (const auto &size : sizes) {
+            DYNAMIC_SECTION("Variant " << variant.name << " " << size.srcWidth << "x" << size.srcHeight
+                            << " to " << size.dstWidth << "x" << size.dstHeight)
+            {
+                auto src = RandomImage((size.srcWidth * (size.srcHeight + 1) + 1) * RGB_BYTES, v + size.dstWidth);
+                const auto ref = ReferenceResize(src.data(), size.srcWidth, size.srcHeight, size.dstWidth, size.dstHeight);
+
+                // padded, to catch writes past the end
+                const size_t dstBytes = size.dstWidth * size.dstHeight * RGB_BYTES;
+                std::vector<uint8_t> dst(dstBytes + 64, 0xA5);
+
+                const auto start = std::chrono::steady_clock::now();
+                REQUIRE(0 == variant.resize(src.data(), size.srcWidth, size.srcHeight,
+                                            dst.data(), size.dstWidth, size.dstHeight, RGB_BYTES));
+                const auto end = std::chrono::steady_clock::now();
+
+                for (size_t i = dstBytes; i < dst.size(); i++) {
+                    REQUIRE(dst[i] == 0xA5);
+                }
+
+                const ErrorStats stats = CompareToReference(dst.data(), ref);
+                const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+                std::cout << "resize_image_" << variant.name << " " << size.srcWidth << "x" << size.srcHeight
+                          << " -> " << size.dstWidth << "x" << size.dstHeight
+                          << ": max error " << stats.max << ", mean error " << std::setprecision(3) << stats.mean
+                          << ", " << ns / (size.dstWidth * size.dstHeight) << " ns/pixel" << std::endl;
+
+                REQUIRE(stats.max <= variant.max_error);
+                REQUIRE(stats.mean < 1.5);
+            }
+        }
+    }
+}
+
+TEST_CASE("Common: Image processing resize in place")
+{
+    const int srcWidth = 200, srcHeight = 150, dstWidth = 64, dstHeight = 48;
+    const auto src = RandomImage((srcWidth * (srcHeight + 1) + 1) * RGB_BYTES, 1);
+
+    for (uint32_t v = 0; v < resize_variant_count; v++) {
+        const resize_variant_t &variant = resize_variants[v];
+        std::vector<uint8_t> expected(dstWidth * dstHeight * RGB_BYTES);
+        REQUIRE(0 == variant.resize(src.data(), srcWidth, srcHeight, expected.data(), dstWidth, dstHeight, RGB_BYTES));
+
+        auto buffer = src;
+        REQUIRE(0 == variant.resize(buffer.data(), srcWidth, srcHeight, buffer.data(), dstWidth, dstHeight, RGB_BYTES));
+        REQUIRE(0 == std::memcmp(buffer.data(), expected.data(), expected.size()));
+    }
+}
+
+TEST_CASE("Common: Image processing resize variant selection")
+{
+    SECTION("Fastest variant within the bound")
+    {
+        for (uint32_t bound = 0; bound < 4; bound++) {
+            const resize_variant_t *chosen = resize_variant_for_error(bound);
+            REQUIRE(chosen != nullptr);
+            if (chosen->max_error <= bound) {
+                for (const resize_variant_t *faster = resize_variants; faster < chosen; faster++) {
+                    REQUIRE(faster->max_error > bound);
+                }
+            }
+        }
+    }
+
+    SECTION("The default bound keeps resize_image_A")
+    {
+        REQUIRE(resize_variant_for_error(8)->resize == resize_image_A);
+#if RESIZE_MAX_ERROR >= 8
+        REQUIRE(resize_variant_for_error(RESIZE_MAX_ERROR)->resize == resize_image_A);
+#endif
+    }
+
+    SECTION("Most accurate variant when nothing meets the bound")
+    {
+        const resize_variant_t *chosen = resize_variant_for_error(0);
+        for (uint32_t v = 0; v < resize_variant_count; v++) {
+            REQUIRE(chosen->max_error <= resize_variants[v].max_error);
+        }
+    }
+
+    SECTION("crop_and_interpolate uses the selected variant")
+    {
+        const uint32_t dstWidth = 96, dstHeight = 64;
+        auto src = RandomImage(CIMAGE_X * CIMAGE_Y * RGB_BYTES, 2);
+        std::vector<uint8_t> dst(CIMAGE_X * CIMAGE_Y * RGB_BYTES);
+
+        uint32_t cropWidth, cropHeight;
+        calculate_crop_dims(CIMAGE_X, CIMAGE_Y, dstWidth, dstHeight, &cropWidth, &cropHeight);
+        REQUIRE(cropWidth == CIMAGE_X);
+        REQUIRE(cropHeight == CIMAGE_Y * dstHeight / dstWidth);
+
+        // same steps by hand: crop, then resize in place
+        std::vector<uint8_t> expected(dst.size());
+        REQUIRE(0 == frame_crop(src.data(), CIMAGE_X, CIMAGE_Y, 0, (CIMAGE_Y - cropHeight) / 2,
+                                expected.data(), cropWidth, cropHeight, RGB_BYTES * 8));
+        REQUIRE(0 == resize_variant_for_error(RESIZE_MAX_ERROR)->resize(expected.data(), cropWidth, cropHeight,
+                                                                       expected.data(), dstWidth, dstHeight, RGB_BYTES));
+
+        REQUIRE(0 == crop_and_interpolate(src.data(), CIMAGE_X, CIMAGE_Y, dst.data(), dstWidth, dstHeight, RGB_BYTES * 8));
+        REQUIRE(0 == std::memcmp(dst.data(), expected.data(), dstWidth * dstHeight * RGB_BYTES));
+    }
+}
+
+TEST_CASE("Common: Image processing frame_crop")
+{
+    const uint32_t width = 64, height = 40;
+    const uint32_t x = 8, y = 5, cropWidth = 32, cropHeight = 20;
+
+    for (uint32_t bpp : { 8u, 16u, 24u }) {
+        DYNAMIC_SECTION("bpp " << bpp)
+        {
+            const uint32_t bytes = bpp / 8;
+            const auto src = RandomImage(width * height * bytes, bpp);
+            // the 8 and 16 bit paths copy whole words, so may write up to 3 bytes past the crop
+            std::vector<uint8_t> dst(cropWidth * cropHeight * bytes + 4);
+
+            REQUIRE(0 == frame_crop(src.data(), width, height, x, y, dst.data(), cropWidth, cropHeight, bpp));
+            for (uint32_t row = 0; row < cropHeight; row++) {
+                REQUIRE(0 == std::memcmp(&dst[row * cropWidth * bytes],
+                                         &src[((y + row) * width + x) * bytes], cropWidth * bytes));
+            }
+
+            REQUIRE(FRAME_OUT_OF_RANGE == frame_crop(src.data(), width, height, width - cropWidth + 1, y,
+                                                     dst.data(), cropWidth, cropHeight, bpp));
+            REQUIRE(FRAME_OUT_OF_RANGE == frame_crop(src.data(), width, height, x, height - cropHeight + 1,
+                                                     dst.data(), cropWidth, cropHeight, bpp));
+        }
+    }
+}
+
+TEST_CASE("Common: Image processing bayer_to_RGB")
+{
+    auto bayer = RandomImage(CIMAGE_X * CIMAGE_Y, 3);
+    std::vector<uint8_t> rgb(CIMAGE_X * CIMAGE_Y * RGB_BYTES, 0xA5);
+    std::vector<uint8_t> expected(rgb.size());
+
+    ReferenceDemosaic(bayer.data(), expected.data());
+
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE(0 == bayer_to_RGB(bayer.data(), rgb.data()));
+    const auto end = std::chrono::steady_clock::now();
+
+    REQUIRE(0 == std::memcmp(rgb.data(), expected.data(), rgb.size()));
+
+    // exposure analysis counts pairs of raw pixels, starting on the red/blue one
+    uint32_t high = 0, notLow = 0;
+    for (uint32_t y = 0; y < CIMAGE_Y - 1; y++) {
+        for (uint32_t x = y & 1; x + 1 < CIMAGE_X - 1; x += 2) {
+            const uint8_t *p = &bayer[y * CIMAGE_X + x];
+            high += (p[0] >= THRESH_HIGH || p[1] >= THRESH_HIGH) ? 2 : 0;
+            notLow += (p[0] >= THRESH_LOW && p[1] >= THRESH_LOW) ? 2 : 0;
+        }
+    }
+    REQUIRE(exposure_high_count == high);
+    REQUIRE(exposure_low_count == (CIMAGE_X - 2) * (CIMAGE_Y - 1) - notLow);
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "bayer_to_RGB " << CIMAGE_X << "x" << CIMAGE_Y << ": "
+              << std::setprecision(3) << ns / (CIMAGE_X * CIMAGE_Y) << " ns/pixel" << std::endl;
+}
+
+TEST_CASE("Common: Image processing white_balance")
+{
+    const double ccm[3][3] = {
+        {  2.092, -0.369, -0.636 },
+        { -0.492,  1.315,  0.162 },
+        { -0.139, -0.664,  3.017 },
+    };
+    const int width = 96, height = 96;
+    const auto src = RandomImage(width * height * RGB_BYTES, 4);
+    std::vector<uint8_t> dst(src.size());
+
+    const auto start = std::chrono::steady_clock::now();
+    white_balance(width, height, src.data(), dst.data());
+    const auto end = std::chrono::steady_clock::now();
+
+    uint32_t maxError = 0;
+    for (int i = 0; i < width * height; i++) {
+        const uint8_t *s = &src[i * RGB_BYTES];
+        for (int c = 0; c < RGB_BYTES; c++) {
+            double ref = ccm[c][0] * s[0] + ccm[c][1] * s[1] + ccm[c][2] * s[2];
+            // the kernels truncate
+            ref = std::floor(std::min(std::max(ref, 0.0), 255.0));
+            maxError = std::max(maxError, uint32_t(std::fabs(dst[i * RGB_BYTES + c] - ref)));
+        }
+    }
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "white_balance " << width << "x" << height << ": max error " << maxError << ", "
+              << std::setprecision(3) << ns / (width * height) << " ns/pixel" << std::endl;
+    REQUIRE(maxError <= 1);
+}
+
+TEST_CASE("Common: Image processing fused bayer_to_RGB_scaled")
+{
+    // 280x277, 100x99 and 280x279 crop an odd number of rows off the top, so the
+    // crop starts on the other Bayer phase. 480x480 samples the last row and column.
+    const struct { uint32_t width, height; } sizes[] = {
+        { 96, 96 },
+        { 160, 90 },
+        { 280, 277 },
+        { 100, 99 },
+        { 280, 279 },
+        { CIMAGE_OUT_MAX_X, CIMAGE_OUT_MAX_Y },
+    };
+
+    auto bayer = RandomImage(CIMAGE_X * CIMAGE_Y, 5);
+
+    for (const auto &size : sizes) {
+        DYNAMIC_SECTION(size.width << "x" << size.height)
+        {
+            // the separate stages, as image_ensemble.c runs them without CAMERA_FUSED_DEMOSAIC
+            std::vector<uint8_t> rgb(CIMAGE_X * CIMAGE_Y * RGB_BYTES);
+            // the resize reads one row past the crop, which the fused path treats as black
+            std::vector<uint8_t> scratch(rgb.size() + (CIMAGE_X + 1) * RGB_BYTES, 0);
+            std::vector<uint8_t> expected(size.width * size.height * RGB_BYTES);
+            REQUIRE(0 == bayer_to_RGB(bayer.data(), rgb.data()));
+            const uint32_t high = exposure_high_count, low = exposure_low_count;
+            REQUIRE(0 == crop_and_interpolate(rgb.data(), CIMAGE_X, CIMAGE_Y, scratch.data(),
+                                              size.width, size.height, RGB_BYTES * 8));
+            white_balance(size.width, size.height, scratch.data(), expected.data());
+
+            // padded, to catch writes past the end
+            std::vector<uint8_t> fused(expected.size() + 64, 0xA5);
+            const auto start = std::chrono::steady_clock::now();
+            REQUIRE(0 == bayer_to_RGB_scaled(bayer.data(), fused.data(), size.width, size.height));
+            const auto end = std::chrono::steady_clock::now();
+
+            for (size_t i = expected.size(); i < fused.size(); i++) {
+                REQUIRE(fused[i] == 0xA5);
+            }
+
+            uint32_t maxError = 0;
+            for (size_t i = 0; i < expected.size(); i++) {
+                maxError = std::max(maxError, uint32_t(std::abs(fused[i] - expected[i])));
+            }
+
+            const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            std::cout << "bayer_to_RGB_scaled -> " << size.width << "x" << size.height << ": max error " << maxError
+                      << ", " << std::setprecision(3) << ns / (size.width * size.height) << " ns/pixel" << std::endl;
+
+            // the fixed point colour matrix may round differently from white_balance
+            REQUIRE(maxError <= 1);
+
+            // the exposure counts are estimated from the sampled pixels, random noise keeps them close
+            REQUIRE(std::abs(double(exposure_high_count) - high) <= 0.05 * CIMAGE_X * CIMAGE_Y);
+            REQUIRE(std::abs(double(exposure_low_count) - low) <= 0.05 * CIMAGE_X * CIMAGE_Y);
+        }
+    }
+}
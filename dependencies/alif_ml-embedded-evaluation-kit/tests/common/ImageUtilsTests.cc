@@ -0,0 +1,223 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Checks the array backed DetectionPool and CalculateNMS give exactly the
+ * detections, in exactly the order, of the std::forward_list versions they
+ * replaced, which are kept here as the reference.
+ */
+#include "ImageUtils.hpp"
+
+#include <catch.hpp>
+
+#include <forward_list>
+#include <random>
+#include <vector>
+
+using arm::app::image::Box;
+using arm::app::image::DetectionPool;
+
+namespace {
+
+struct RefDetection {
+    Box bbox;
+    std::vector<float> prob;
+    float objectness;
+};
+
+/* The list based CalculateNMS. That captured idxClass by value, so sorted by
+ * class 0 for every class; with one class, as all the use cases have, it's the
+ * same as this. */
+void RefCalculateNMS(std::forward_list<RefDetection>& detections, int classes, float iouThreshold)
+{
+    int idxClass{0};
+    auto CompareProbs = [&idxClass](RefDetection& prob1, RefDetection& prob2) {
+        return prob1.prob[idxClass] > prob2.prob[idxClass];
+    };
+
+    for (idxClass = 0; idxClass < classes; ++idxClass) {
+        detections.sort(CompareProbs);
+
+        for (auto it = detections.begin(); it != detections.end(); ++it) {
+            if (it->prob[idxClass] == 0) continue;
+            for (auto itc = std::next(it, 1); itc != detections.end(); ++itc) {
+                if (itc->prob[idxClass] == 0) {
+                    continue;
+                }
+                if (arm::app::image::CalculateBoxIOU(it->bbox, itc->bbox) > iouThreshold) {
+                    itc->prob[idxClass] = 0;
+                }
+            }
+        }
+    }
+}
+
+/* The list based top N selection from DetectorPostProcess::GetNetworkBoxes. */
+void RefInsertTopN(std::forward_list<RefDetection>& detections, RefDetection& det)
+{
+    std::forward_list<RefDetection>::iterator it;
+    std::forward_list<RefDetection>::iterator last_it;
+    for (it = detections.begin(); it != detections.end(); ++it) {
+        if (it->objectness > det.objectness)
+            break;
+        last_it = it;
+    }
+    if (it != detections.begin()) {
+        detections.emplace_after(last_it, det);
+        detections.pop_front();
+    }
+}
+
+void RefAdd(std::forward_list<RefDetection>& detections, RefDetection& det, int topN, int& num)
+{
+    if (num < topN || topN <= 0) {
+        detections.emplace_front(det);
+        num += 1;
+    } else if (num == topN) {
+        detections.sort([](RefDetection& pa, RefDetection& pb) {
+            return pa.objectness < pb.objectness;
+        });
+        RefInsertTopN(detections, det);
+        num += 1;
+    } else {
+        RefInsertTopN(detections, det);
+    }
+}
+
+/* Coarse grids for every value, so there are plenty of equal scores and
+ * identical or touching boxes to exercise the tie breaks. */
+std::vector<RefDetection> RandomDetections(std::mt19937& gen, size_t count, int classes)
+{
+    std::uniform_int_distribution<int> obj(8, 16);
+    std::uniform_int_distribution<int> prob(0, 8);
+    std::uniform_int_distribution<int> pos(0, 12);
+    std::uniform_int_distribution<int> size(0, 6);
+
+    std::vector<RefDetection> dets(count);
+    for (auto& det : dets) {
+        det.objectness = obj(gen) / 16.0f;
+        det.bbox = Box{pos(gen) * 8.0f, pos(gen) * 8.0f, size(gen) * 8.0f, size(gen) * 8.0f};
+        for (int c = 0; c < classes; ++c) {
+            int p = prob(gen);
+            det.prob.push_back(p < 3 ? 0 : p / 8.0f * det.objectness);
+        }
+    }
+    return dets;
+}
+
+void CheckSame(DetectionPool& pool, const std::forward_list<RefDetection>& ref, int classes)
+{
+    size_t index = 0;
+    for (auto& expected : ref) {
+        REQUIRE(index < pool.Size());
+        auto& det = pool[index++];
+        REQUIRE(det.objectness == expected.objectness);
+        REQUIRE(det.bbox.x == expected.bbox.x);
+        REQUIRE(det.bbox.y == expected.bbox.y);
+        REQUIRE(det.bbox.w == expected.bbox.w);
+        REQUIRE(det.bbox.h == expected.bbox.h);
+        for (int c = 0; c < classes; ++c) {
+            REQUIRE(det.prob[c] == expected.prob[c]);
+        }
+    }
+    REQUIRE(index == pool.Size());
+}
+
+} /* namespace */
+
+TEST_CASE("Common: DetectionPool top N")
+{
+    std::mt19937 gen(1234);
+    const int classes = 2;
+
+    for (int topN : {0, 1, 5, 20}) {
+        DYNAMIC_SECTION("topN " << topN)
+        {
+            DetectionPool pool(64, classes, topN);
+
+            for (int run = 0; run < 50; ++run) {
+                auto dets = RandomDetections(gen, run, classes);
+                std::forward_list<RefDetection> ref;
+                int num = 0;
+
+                pool.Clear();
+                for (auto& det : dets) {
+                    RefAdd(ref, det, topN, num);
+
+                    auto* added = pool.Add(det.objectness);
+                    if (added != nullptr) {
+                        added->bbox = det.bbox;
+                        std::copy(det.prob.begin(), det.prob.end(), added->prob);
+                    }
+                }
+                CheckSame(pool, ref, classes);
+            }
+        }
+    }
+}
+
+TEST_CASE("Common: DetectionPool full")
+{
+    DetectionPool pool(2, 1);
+    REQUIRE(pool.Add(0.5f) != nullptr);
+    REQUIRE(pool.Add(0.6f) != nullptr);
+    REQUIRE(pool.Add(0.7f) == nullptr);
+    REQUIRE(pool.Size() == 2);
+    REQUIRE(pool[0].objectness == 0.6f);
+    REQUIRE(pool[0].prob[0] == 0.0f);
+
+    pool.Clear();
+    REQUIRE(pool.Size() == 0);
+    REQUIRE(pool.Add(0.7f) != nullptr);
+    REQUIRE(pool.Size() == 1);
+}
+
+TEST_CASE("Common: CalculateNMS matches list version")
+{
+    std::mt19937 gen(5678);
+
+    for (int classes : {1, 3}) {
+        for (int topN : {0, 8}) {
+            for (float iouThreshold : {0.45f, 0.0f, 0.9f}) {
+                DYNAMIC_SECTION("classes " << classes << " topN " << topN << " iou " << iouThreshold)
+                {
+                    DetectionPool pool(100, classes, topN);
+
+                    for (int run = 0; run < 100; ++run) {
+                        auto dets = RandomDetections(gen, run, classes);
+                        std::forward_list<RefDetection> ref;
+                        int num = 0;
+
+                        pool.Clear();
+                        for (auto& det : dets) {
+                            RefAdd(ref, det, topN, num);
+
+                            auto* added = pool.Add(det.objectness);
+                            if (added != nullptr) {
+                                added->bbox = det.bbox;
+                                std::copy(det.prob.begin(), det.prob.end(), added->prob);
+                            }
+                        }
+
+                        RefCalculateNMS(ref, classes, iouThreshold);
+                        arm::app::image::CalculateNMS(pool, iouThreshold);
+                        CheckSame(pool, ref, classes);
+                    }
+                }
+            }
+        }
+    }
+}
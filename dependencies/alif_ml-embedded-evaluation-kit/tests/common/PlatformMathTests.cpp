@@ -16,8 +16,10 @@
  */
 #include "PlatformMath.hpp"
 #include <catch.hpp>
+#include <cmath>
 #include <limits>
 #include <numeric>
+#include <random>
 
 TEST_CASE("Test CosineF32")
 {
@@ -583,6 +585,116 @@ TEST_CASE("Test FFT32")
     }
 }
 
+/* DFT in double precision, for checking the FFTs: fftLen points of input,
+ * which is interleaved (real, imaginary) pairs if complex. */
+static void ReferenceDft(const std::vector<float>& input, size_t fftLen, bool complex,
+                         std::vector<double>& outReal, std::vector<double>& outImag)
+{
+    outReal.assign(fftLen, 0);
+    outImag.assign(fftLen, 0);
+    for (size_t k = 0; k < fftLen; ++k) {
+        for (size_t t = 0; t < fftLen; ++t) {
+            const double angle = 2 * M_PI * ((k * t) % fftLen) / fftLen;
+            const double re = complex ? input[2 * t] : input[t];
+            const double im = complex ? input[2 * t + 1] : 0;
+            outReal[k] += re * std::cos(angle) + im * std::sin(angle);
+            outImag[k] += im * std::cos(angle) - re * std::sin(angle);
+        }
+    }
+}
+
+TEST_CASE("Test FFT32 against DFT")
+{
+    std::mt19937 gen(2023);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<double> expectedReal;
+    std::vector<double> expectedImag;
+
+    /* Powers of 2 take the fast path, odd and even numbers of radix-2
+     * stages. 48 and 60 take the DFT. */
+    for (uint16_t fftLen : {2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 48}) {
+        DYNAMIC_SECTION("Real, length " << fftLen)
+        {
+            std::vector<float> input(fftLen);
+            for (auto& value : input) {
+                value = dist(gen);
+            }
+            std::vector<float> output(fftLen);
+
+            arm::app::math::FftInstance fftInstance;
+            arm::app::math::MathUtils::FftInitF32(fftLen, fftInstance);
+            arm::app::math::MathUtils::FftF32(input, output, fftInstance);
+            ReferenceDft(input, fftLen, false, expectedReal, expectedImag);
+
+            /* Values are stored as [real0, realN/2, real1, im1, real2, im2, ...] */
+            const float tolerance = 1e-5 * fftLen;
+            CHECK(output[0] == Approx(expectedReal[0]).margin(tolerance));
+            CHECK(output[1] == Approx(expectedReal[fftLen / 2]).margin(tolerance));
+            for (size_t k = 1; k < fftLen / 2u; ++k) {
+                CHECK(output[2 * k] == Approx(expectedReal[k]).margin(tolerance));
+                CHECK(output[2 * k + 1] == Approx(expectedImag[k]).margin(tolerance));
+            }
+        }
+    }
+
+    for (uint16_t fftLen : {2, 4, 8, 16, 32, 64, 128, 256, 512, 60}) {
+        DYNAMIC_SECTION("Complex, length " << fftLen)
+        {
+            std::vector<float> input(2 * fftLen);
+            for (auto& value : input) {
+                value = dist(gen);
+            }
+            std::vector<float> output(2 * fftLen);
+
+            arm::app::math::FftInstance fftInstance;
+            arm::app::math::MathUtils::FftInitF32(fftLen, fftInstance,
+                                                  arm::app::math::FftType::complex);
+            arm::app::math::MathUtils::FftF32(input, output, fftInstance);
+            ReferenceDft(input, fftLen, true, expectedReal, expectedImag);
+
+            const float tolerance = 1e-5 * fftLen;
+            for (size_t k = 0; k < fftLen; ++k) {
+                CHECK(output[2 * k] == Approx(expectedReal[k]).margin(tolerance));
+                CHECK(output[2 * k + 1] == Approx(expectedImag[k]).margin(tolerance));
+            }
+        }
+    }
+}
+
+TEST_CASE("Test FFTQ15 against DFT")
+{
+    std::mt19937 gen(2023);
+    std::uniform_int_distribution<int> dist(-32768, 32767);
+    std::vector<double> expectedReal;
+    std::vector<double> expectedImag;
+
+    for (uint16_t fftLen : {256, 512}) {
+        DYNAMIC_SECTION("Length " << fftLen)
+        {
+            std::vector<int16_t> input(fftLen);
+            std::vector<float> inputF32(fftLen);
+            for (size_t i = 0; i < fftLen; ++i) {
+                input[i] = dist(gen);
+                inputF32[i] = input[i];
+            }
+            std::vector<int16_t> output(2 * fftLen);
+
+            arm::app::math::FftInstanceQ15 fftInstance;
+            arm::app::math::MathUtils::FftInitQ15(fftLen, fftInstance);
+            arm::app::math::MathUtils::FftQ15(input.data(), output.data(), fftInstance);
+            ReferenceDft(inputF32, fftLen, false, expectedReal, expectedImag);
+
+            /* Bins 0 to N/2 scaled down by N. arm_rfft_q15 truncates at each
+             * stage, so allow a few LSBs. */
+            const double tolerance = 8;
+            for (size_t k = 0; k <= fftLen / 2u; ++k) {
+                CHECK(output[2 * k] == Approx(expectedReal[k] / fftLen).margin(tolerance));
+                CHECK(output[2 * k + 1] == Approx(expectedImag[k] / fftLen).margin(tolerance));
+            }
+        }
+    }
+}
+
 TEST_CASE("Test VecLogarithmF32")
 {
     /*Test  Constants: */
@@ -15,12 +15,15 @@
  * limitations under the License.
  */
 #include "Profiler.hpp"
+#include "SlotProfiler.hpp"
 
 #include "AppContext.hpp"
 #include "TensorFlowLiteMicro.hpp"
 
 #include <catch.hpp>
+#include <cstring>
 #include <iostream>
+#include <string>
 
 
 TEST_CASE("Common: Test Profiler")
@@ -95,4 +98,132 @@ TEST_CASE("Common: Test Profiler")
         REQUIRE(foundCPU_ACTIVE);
     }
 #endif /* defined (CPU_PROFILE_ENABLED) */
-}
\ No newline at end of file
+}
+
+namespace {
+
+constexpr uint32_t kSlotA = 0;
+constexpr uint32_t kSlotB = 1;
+constexpr const char* kSlotNames[] = {"a", "b"};
+
+/* One counter, "cycles", with the given value. */
+pmu_counters Counters(uint64_t value)
+{
+    pmu_counters counters{};
+    counters.counters[0] = {value, "cycles", "cycles"};
+    counters.num_counters = 1;
+    counters.initialised = true;
+    return counters;
+}
+
+void AppendToString(const void* data, size_t len, void* userData)
+{
+    static_cast<std::string*>(userData)->append(static_cast<const char*>(data), len);
+}
+
+} /* namespace */
+
+TEST_CASE("Common: Test SlotProfiler")
+{
+    hal_platform_init();
+
+    SECTION("Test start and stop") {
+        arm::app::SlotProfiler<2, 8> profiler{kSlotNames};
+        REQUIRE(false == profiler.Stop<kSlotA>()); /* We need to start it first */
+        REQUIRE(true == profiler.Start<kSlotA>());
+        REQUIRE(false == profiler.Start<kSlotA>()); /* Already started */
+        REQUIRE(true == profiler.Start<kSlotB>()); /* Slots are independent */
+        REQUIRE(true == profiler.Stop<kSlotA>());
+        REQUIRE(true == profiler.Stop<kSlotB>());
+        REQUIRE(profiler.NumCounters(kSlotA) > 0);
+
+        arm::app::SlotStatistics stats{};
+        REQUIRE(profiler.GetStatistics(kSlotA, 0, stats));
+        REQUIRE(stats.samplesNum == 1);
+
+        profiler.Reset();
+        REQUIRE(profiler.NumCounters(kSlotA) == 0);
+        REQUIRE(false == profiler.GetStatistics(kSlotA, 0, stats));
+    }
+
+    SECTION("Test percentiles") {
+        arm::app::SlotProfiler<2, 8> profiler{kSlotNames};
+
+        /* 1 to 20, so the ring keeps 13 to 20 */
+        for (uint64_t value = 1; value <= 20; ++value) {
+            REQUIRE(profiler.Record(kSlotA, Counters(100), Counters(100 + value)));
+        }
+        REQUIRE(false == profiler.Record(2, Counters(0), Counters(1)));
+
+        arm::app::SlotStatistics stats{};
+        REQUIRE(profiler.GetStatistics(kSlotA, 0, stats));
+        REQUIRE(std::string(stats.name) == "cycles");
+        REQUIRE(stats.samplesNum == 20);
+        REQUIRE(stats.storedNum == 8);
+        REQUIRE(stats.total == 210);
+        REQUIRE(stats.avrg == Approx(10.5));
+        REQUIRE(stats.min == 1);
+        REQUIRE(stats.max == 20);
+        REQUIRE(stats.p50 == 16);
+        REQUIRE(stats.p95 == 20);
+        REQUIRE(stats.p99 == 20);
+        REQUIRE(false == profiler.GetStatistics(kSlotB, 0, stats));
+    }
+
+    SECTION("Test tail percentiles") {
+        arm::app::SlotProfiler<2, 100> profiler{kSlotNames};
+
+        /* 95 fast, 4 slow and one very slow */
+        for (int i = 0; i < 100; ++i) {
+            const uint64_t value = i < 95 ? 10 : (i < 99 ? 50 : 1000);
+            REQUIRE(profiler.Record(kSlotB, Counters(0), Counters(value)));
+        }
+
+        arm::app::SlotStatistics stats{};
+        REQUIRE(profiler.GetStatistics(kSlotB, 0, stats));
+        REQUIRE(stats.p50 == 10);
+        REQUIRE(stats.p95 == 10);
+        REQUIRE(stats.p99 == 50);
+        REQUIRE(stats.max == 1000);
+    }
+
+    SECTION("Test 64 bit samples") {
+        arm::app::SlotProfiler<2, 4> profiler{kSlotNames};
+        const uint64_t large = 5000000000; /* Over 32 bits, eg. a long NPU run */
+        REQUIRE(profiler.Record(kSlotA, Counters(1), Counters(1 + large)));
+        REQUIRE(profiler.Record(kSlotA, Counters(0), Counters(2 * large)));
+
+        arm::app::SlotStatistics stats{};
+        REQUIRE(profiler.GetStatistics(kSlotA, 0, stats));
+        REQUIRE(stats.total == 3 * large);
+        REQUIRE(stats.min == large);
+        REQUIRE(stats.max == 2 * large);
+        REQUIRE(stats.p99 == 2 * large);
+    }
+
+    SECTION("Test export") {
+        arm::app::SlotProfiler<2, 4> profiler{kSlotNames};
+        for (uint64_t value = 1; value <= 6; ++value) {
+            REQUIRE(profiler.Record(kSlotB, Counters(0), Counters(value)));
+        }
+
+        std::string csv;
+        profiler.ExportCsv(AppendToString, &csv);
+        REQUIRE(csv == "slot,counter,unit,samples,total,avg,min,max,p50,p95,p99\n"
+                       "b,cycles,cycles,6,21,3.5,1,6,4,6,6\n");
+
+        std::string binary;
+        profiler.ExportBinary(AppendToString, &binary);
+        const uint8_t expected[] = {
+            'S', 'P', 'R', 'F', 1, 2,
+            1, 'a', 0, 0, 0, 0, 0, 0, 0,
+            1, 'b', 6, 0, 0, 0, 4, 0, 1,
+            6, 'c', 'y', 'c', 'l', 'e', 's', 6, 'c', 'y', 'c', 'l', 'e', 's',
+            21, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 6, 0, 0, 0, 0, 0, 0, 0,
+            3, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0,
+            5, 0, 0, 0, 0, 0, 0, 0, 6, 0, 0, 0, 0, 0, 0, 0
+        };
+        REQUIRE(binary.size() == sizeof(expected));
+        REQUIRE(0 == std::memcmp(binary.data(), expected, sizeof(expected)));
+    }
+}
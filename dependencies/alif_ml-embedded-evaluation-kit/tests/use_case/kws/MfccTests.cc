@@ -15,10 +15,15 @@
  * limitations under the License.
  */
 #include "MicroNetKwsMfcc.hpp"
+#include "PackedMfcc.hpp"
+#include "Profiler.hpp"
 
 #include <algorithm>
 #include <catch.hpp>
+#include <cmath>
+#include <cstdio>
 #include <limits>
+#include <random>
 
 /* First 640 samples from yes.wav. */
 const std::vector<int16_t> testWav = std::vector<int16_t>{
@@ -144,4 +149,120 @@ TEST_CASE("MFCC calculation test") {
     {
         TestQuantisedMFCC<int16_t>();
     }
-}
\ No newline at end of file
+}
+
+/* Frames of a tone over noise at a range of levels, for comparing MFCC
+ * implementations away from the one golden frame. */
+static std::vector<int16_t> TestFrame(size_t frameLen, int amplitude, uint32_t seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> noise(-amplitude / 8, amplitude / 8);
+    std::vector<int16_t> frame(frameLen);
+    for (size_t i = 0; i < frameLen; ++i) {
+        const double tone = amplitude * std::sin(2 * M_PI * (300 + 100 * seed) * i / 16000.0);
+        frame[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, tone + noise(gen))));
+    }
+    return frame;
+}
+
+static arm::app::audio::MfccParams GetMFCCParams()
+{
+    const int sampFreq = arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq;
+    const int frameLenSamples = sampFreq * 40 * 0.001;
+    return arm::app::audio::MicroNetKwsMFCC::GetParams(10, frameLenSamples);
+}
+
+TEST_CASE("Packed MFCC calculation test") {
+    using arm::app::audio::MfccPrecision;
+    const float quantScale = 1.1088106632232666;
+    const int quantOffset = 95;
+
+    SECTION("FP32")
+    {
+        arm::app::audio::PackedMfcc mfcc(GetMFCCParams(), MfccPrecision::F32);
+        REQUIRE_THAT( mfcc.MfccCompute(testWav), Catch::Approx(testWavMfcc).margin(0.0001) );
+
+        /* Quantised as MFCC::MfccComputeQuant, so exactly the same features. */
+        auto reference = GetMFCCInstance().MfccComputeQuant<int8_t>(testWav, quantScale, quantOffset);
+        std::vector<int8_t> quantised(testWavMfcc.size());
+        mfcc.MfccComputeQuant<int8_t>(testWav.data(), quantScale, quantOffset, quantised.data());
+        REQUIRE(quantised == reference);
+    }
+
+    SECTION("Q15")
+    {
+        arm::app::audio::PackedMfcc mfcc(GetMFCCParams(), MfccPrecision::Q15);
+        REQUIRE_THAT( mfcc.MfccCompute(testWav), Catch::Approx(testWavMfcc).margin(0.25) );
+
+        auto reference = GetMFCCInstance().MfccComputeQuant<int8_t>(testWav, quantScale, quantOffset);
+        auto quantised = mfcc.MfccComputeQuant<int8_t>(testWav, quantScale, quantOffset);
+        for (size_t i = 0; i < reference.size(); ++i) {
+            REQUIRE(std::abs(quantised[i] - reference[i]) <= 1);
+        }
+    }
+
+    SECTION("Matches MFCC")
+    {
+        auto params = GetMFCCParams();
+        arm::app::audio::MicroNetKwsMFCC reference(params.m_numMfccFeatures, params.m_frameLen);
+        arm::app::audio::PackedMfcc f32(params, MfccPrecision::F32);
+        arm::app::audio::PackedMfcc q15(params, MfccPrecision::Q15);
+
+        for (int amplitude : {100, 1000, 30000}) {
+            for (uint32_t seed = 0; seed < 4; ++seed) {
+                auto frame = TestFrame(params.m_frameLen, amplitude, seed);
+                auto expected = reference.MfccCompute(frame);
+                REQUIRE_THAT( f32.MfccCompute(frame), Catch::Approx(expected).margin(0.001) );
+                /* The Q15 FFT scales down by its length, which costs the
+                 * quietest bins most of their bits. */
+                REQUIRE_THAT( q15.MfccCompute(frame), Catch::Approx(expected).margin(1.0) );
+            }
+        }
+    }
+}
+
+TEST_CASE("MFCC cycles per frame") {
+    using arm::app::audio::MfccPrecision;
+    constexpr int numFrames = 10;
+
+    auto params = GetMFCCParams();
+    arm::app::audio::MicroNetKwsMFCC reference(params.m_numMfccFeatures, params.m_frameLen);
+    arm::app::audio::PackedMfcc f32(params, MfccPrecision::F32);
+    arm::app::audio::PackedMfcc q15(params, MfccPrecision::Q15);
+    std::vector<float> features(params.m_numMfccFeatures);
+
+    /* One series per implementation, each numFrames long. */
+    arm::app::Profiler profiler{"MFCC per frame"};
+    reference.Init();
+    for (int i = 0; i < numFrames; ++i) {
+        profiler.StartProfiling("MFCC");
+        features = reference.MfccCompute(testWav);
+        profiler.StopProfiling();
+    }
+    for (int i = 0; i < numFrames; ++i) {
+        profiler.StartProfiling("PackedMfcc F32");
+        f32.MfccCompute(testWav.data(), features.data());
+        profiler.StopProfiling();
+    }
+    for (int i = 0; i < numFrames; ++i) {
+        profiler.StartProfiling("PackedMfcc Q15");
+        q15.MfccCompute(testWav.data(), features.data());
+        profiler.StopProfiling();
+    }
+
+    /* Each counter's total over the frames, divided down to one frame:
+     * cycles on target, time on native. */
+    std::vector<arm::app::ProfileResult> results;
+    profiler.GetAllResultsAndReset(results);
+    REQUIRE(results.size() == 3);
+    for (const auto& result : results) {
+        REQUIRE(result.samplesNum == numFrames);
+        for (const auto& stat : result.data) {
+            printf("%s: %.0f %s per frame (%s)\n", result.name.c_str(),
+                   static_cast<double>(stat.total) / numFrames,
+                   stat.unit.c_str(), stat.name.c_str());
+        }
+    }
+
+    REQUIRE(f32.FilterBankSize() < params.m_numFbankBins * (params.m_frameLenPadded / 2));
+}
@@ -38,7 +38,6 @@
 #include "image_processing.h"
 #include "hal.h"
 #include "hal_image.h"
-#include "delay.h"
 #include <cstring>
 
 
@@ -78,6 +77,46 @@ class EiCameraAlif : public EiCamera
         return true;
     }
 
+    virtual bool start_pipelined_capture() override
+    {
+        return hal_image_pipeline_start() == 0;
+    }
+
+    virtual bool ei_camera_capture_rgb888_pipelined(
+        uint8_t **image,
+        uint32_t image_size) override
+    {
+        *image = (uint8_t *) hal_get_image_data_pipelined(this->current_resolution.width, this->current_resolution.height);
+        if (!*image) {
+            ei_printf("ERROR: hal_get_image_data_pipelined failed");
+            return false;
+        }
+        return true;
+    }
+
+    virtual void stop_pipelined_capture() override
+    {
+        hal_image_pipeline_stop();
+    }
+
+    virtual bool get_stage_cycles(ei_camera_stage_cycles_t *cycles) override
+    {
+        image_stage_cycles_t hal_cycles;
+
+        hal_get_image_stage_cycles(&hal_cycles);
+        cycles->capture_wait = hal_cycles.capture_wait;
+        cycles->demosaic = hal_cycles.demosaic;
+        cycles->crop = hal_cycles.crop;
+        cycles->resize = hal_cycles.resize;
+        cycles->color_correction = hal_cycles.white_balance;
+        return true;
+    }
+
+    virtual bool set_power(bool on) override
+    {
+        return hal_image_power(on) == 0;
+    }
+
     /**
      * @brief Get the list of supported resolutions, ie. not requiring
      * any software processing like crop or resize
@@ -0,0 +1,130 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Cascade transport on the board: the M55 to M55 MHU channel the platform
+ * sets up in init_trigger_rx. Messages arrive in the MHU interrupt and are
+ * queued until the cascade loop takes them.
+ */
+
+#include "firmware-sdk-alif/ei_cascade_lib.h"
+#include "hal.h"
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+extern "C" {
+#include "services_lib_api.h"
+#include "services_main.h"
+extern uint32_t m55_comms_handle;
+}
+
+#include CMSIS_device_header
+
+static_assert(offsetof(ei_cascade_msg_t, id) == offsetof(m55_data_payload_t, id),
+    "cascade messages must start like the platform's MHU payload");
+static_assert(sizeof(ei_cascade_msg_t) <= sizeof(m55_data_payload_t),
+    "cascade messages must fit the platform's MHU payload");
+
+#define RX_QUEUE_LEN 4 // power of 2
+
+// The other core reads the message through its global address, so it has
+// to be out of our cache before sending, on lines of its own
+static ei_cascade_msg_t tx_msg __attribute__((aligned(32)));
+
+static ei_cascade_msg_t rx_queue[RX_QUEUE_LEN];
+static std::atomic<uint32_t> rx_head(0);
+static std::atomic<uint32_t> rx_tail(0);
+
+static void mhu_msg_received(void *data)
+{
+    const ei_cascade_msg_t *msg = (const ei_cascade_msg_t *)data;
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    SCB_InvalidateDCache_by_Addr((void *)msg, sizeof(*msg));
+#endif
+
+    if (msg->id != EI_CASCADE_MSG_ID) {
+        return;
+    }
+
+    uint32_t head = rx_head.load(std::memory_order_relaxed);
+    if (head - rx_tail.load(std::memory_order_acquire) == RX_QUEUE_LEN) {
+        // full, the loop is not keeping up with the other core
+        return;
+    }
+    memcpy(&rx_queue[head % RX_QUEUE_LEN], msg, sizeof(*msg));
+    rx_head.store(head + 1, std::memory_order_release);
+}
+
+bool ei_cascade_transport_init(void)
+{
+    rx_tail.store(rx_head.load());
+    set_mhu_msg_handler(mhu_msg_received);
+    return true;
+}
+
+void ei_cascade_transport_deinit(void)
+{
+    set_mhu_msg_handler(nullptr);
+}
+
+bool ei_cascade_transport_send(const ei_cascade_msg_t *msg)
+{
+    // the previous message has been read, as the other core acknowledged it
+    memcpy(&tx_msg, msg, sizeof(tx_msg));
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    SCB_CleanDCache_by_Addr(&tx_msg, sizeof(tx_msg));
+#endif
+    __DMB();
+
+    return SERVICES_send_msg(m55_comms_handle, &tx_msg) == SERVICES_REQ_SUCCESS;
+}
+
+bool ei_cascade_transport_receive(ei_cascade_msg_t *msg)
+{
+    uint32_t tail = rx_tail.load(std::memory_order_relaxed);
+    if (tail == rx_head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    memcpy(msg, &rx_queue[tail % RX_QUEUE_LEN], sizeof(*msg));
+    rx_tail.store(tail + 1, std::memory_order_release);
+
+    return ei_cascade_msg_valid(msg);
+}
+
+void ei_cascade_transport_wait(uint32_t timeout_ms)
+{
+    // the MHU interrupt wakes us, as does the tick and UART input
+    __WFE();
+}
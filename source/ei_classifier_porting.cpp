@@ -50,7 +50,7 @@
 
 /* Extern function prototypes ---------------------------------------------- */
 extern "C" uint64_t Get_SysTick_Cycle_Count(void);
-extern "C" unsigned char UartGetcNoBlock(void);
+extern "C" int UartRead(uint8_t *buf, uint32_t len);
 
 EI_IMPULSE_ERROR ei_run_impulse_check_canceled()
 {
@@ -103,9 +103,9 @@ void ei_putchar(char c)
 
 char ei_getchar(void)
 {
-    auto c = UartGetcNoBlock();
-    if (c == 0xFF ) { return 0; } //weird ei convention
-    else { return c; ei_printf("ch: %c\r\n", c);}
+    uint8_t c;
+    if (UartRead(&c, 1) != 1) { return 0; } //weird ei convention
+    return c;
 }
 
 void *ei_malloc(size_t size)
@@ -38,6 +38,7 @@
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/dsp/ei_utils.h"
 #include "firmware-sdk-alif/at_base64_lib.h"
+#include "firmware-sdk-alif/at_frame_lib.h"
 
 #include "uart_tracelib.h"
 
@@ -93,7 +94,7 @@ bool EiDeviceAlif::get_sensor_list(const ei_device_sensor_t **p_sensor_list, siz
 bool EiDeviceAlif::read_encode_send_sample_buffer(size_t address, size_t length)
 {
     if(mic_sample_buffer) {
-        base64_encode((char *)mic_sample_buffer+address, length, ei_putchar);
+        ei_transport_send(EI_FRAME_SAMPLE_BUFFER, (uint8_t *)mic_sample_buffer + address, length);
         return true;
     } else {
         return false;
@@ -160,6 +161,20 @@ void EiDeviceAlif::set_default_data_output_baudrate(void)
     tracelib_init(NULL, DEFAULT_BAUD);
 }
 
+/**
+ * @brief      Binary transport hooks, blocks are queued straight on the UART
+ *             transmit ring instead of going through stdout
+ */
+void ei_transport_send_async(const uint8_t *data, size_t length)
+{
+    send_str((const char *)data, length);
+}
+
+void ei_transport_wait(void)
+{
+    send_wait();
+}
+
 /**
  * @brief get_device is a static method of EiDeviceInfo class
  * It is used to implement singleton paradigm, so we are returning
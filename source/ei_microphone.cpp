@@ -47,6 +47,9 @@ uint32_t wlen = 32;
 uint32_t sampling_rate = 16000;
 microphone_sample_t* mic_sample_buffer = nullptr;
 
+/* Slices held by the continuous ring: one being classified, the rest filling */
+#define INFERENCE_RING_SLICES 3
+
 /** Status and control struct for inferencing struct */
 typedef struct {
     int16_t *buffers[2];
@@ -54,6 +57,8 @@ typedef struct {
     uint8_t buf_ready;
     uint32_t buf_count;
     uint32_t n_samples;
+    int16_t *ring;          // continuous mode only
+    int16_t *ready_slice;   // continuous mode: slice returned to the classifier
 } inference_t;
 
 static inference_t inference;
@@ -151,21 +156,86 @@ bool ei_microphone_inference_start(uint32_t n_samples, float interval_ms)
     return true;
 }
 
-bool ei_microphone_inference_record_continuous(void)
+/**
+ * @brief Start gap-free capture of n_samples slices. The microphone keeps
+ * receiving into a ring buffer from the interrupt while slices are classified.
+ */
+bool ei_microphone_inference_start_continuous(uint32_t n_samples)
 {
-    inference.buf_ready = 0;
-    inference.buf_count = 0;
+    // free up the sampling buffer
+    if(mic_sample_buffer) {
+        ei_free(mic_sample_buffer);
+        mic_sample_buffer = nullptr;
+    }
 
-    micAlif.await_samples();
+    inference.ring = (int16_t *)ei_malloc(INFERENCE_RING_SLICES * n_samples * sizeof(microphone_sample_t));
+    if (inference.ring == NULL) {
+        return false;
+    }
 
-    inference.buf_select ^= 1;
-    inference.buf_ready = 0;
+    inference.n_samples = n_samples;
+    inference.ready_slice = nullptr;
 
-    micAlif.async_start(inference.buffers[inference.buf_select], inference.n_samples);
+    int err = hal_audio_stream_start(inference.ring, INFERENCE_RING_SLICES * n_samples, n_samples);
+    if (err) {
+        ei_printf("ERR: Failed to start audio stream (%d)\n", err);
+        ei_free(inference.ring);
+        inference.ring = nullptr;
+        return false;
+    }
 
     return true;
 }
 
+/**
+ * @brief Hand the previous slice back to the ring and wait for the next one
+ */
+bool ei_microphone_inference_record_continuous(void)
+{
+    if (inference.ready_slice) {
+        hal_audio_stream_release_slice();
+        inference.ready_slice = nullptr;
+    }
+
+    int16_t *slice = hal_audio_stream_get_slice();
+    if (!slice) {
+        return false;
+    }
+
+    hal_audio_preprocessing(slice, inference.n_samples);
+    inference.ready_slice = slice;
+
+    return true;
+}
+
+uint32_t ei_microphone_inference_get_overruns(void)
+{
+    return hal_get_audio_stream_overruns();
+}
+
+/**
+ * @brief Print the audio front end cost since the previous call, per slice,
+ * split between the receive interrupt and foreground preprocessing
+ */
+void ei_microphone_inference_print_frontend_cycles(void)
+{
+    audio_frontend_cycles_t cycles;
+
+    hal_get_audio_frontend_cycles(&cycles);
+    if (cycles.samples == 0) {
+        return;
+    }
+
+    uint64_t slices = (cycles.samples + inference.n_samples / 2) / inference.n_samples;
+    if (slices == 0) {
+        slices = 1;
+    }
+    ei_printf("Audio front end: %u cycles/slice (copy %u, preprocessing %u)\n",
+        (unsigned int)((cycles.copy + (uint64_t)cycles.preprocessing) / slices),
+        (unsigned int)(cycles.copy / slices),
+        (unsigned int)(cycles.preprocessing / slices));
+}
+
 bool ei_microphone_inference_record(void)
 {
     inference.buf_ready = 0;
@@ -194,7 +264,14 @@ void ei_microphone_inference_reset_buffers(void)
 
 bool ei_microphone_inference_end(void)
 {
-    int32_t status;
+    if (inference.ring) {
+        hal_audio_stream_stop();
+        ei_printf("Audio overruns: %u samples dropped\n", (unsigned int)hal_get_audio_stream_overruns());
+        ei_free(inference.ring);
+        inference.ring = nullptr;
+        inference.ready_slice = nullptr;
+        return true;
+    }
 
     ei_free(inference.buffers[0]);
     ei_free(inference.buffers[1]);
@@ -207,7 +284,11 @@ bool ei_microphone_inference_end(void)
  */
 int ei_microphone_audio_signal_get_data(size_t offset, size_t length, float *out_ptr)
 {
-    arm_q15_to_float(&inference.buffers[inference.buf_select ^ 1][offset], out_ptr, length);
+    const int16_t *buffer = inference.ring ?
+        inference.ready_slice :
+        inference.buffers[inference.buf_select ^ 1];
+
+    arm_q15_to_float(&buffer[offset], out_ptr, length);
 
     return 0;
 }
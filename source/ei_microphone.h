@@ -10,7 +10,10 @@ int ei_microphone_init(void);
 bool ei_microphone_sample_record(void);
 int ei_microphone_inference_get_data(size_t offset, size_t length, float *out_ptr);
 bool ei_microphone_inference_start(uint32_t n_samples, float interval_ms);
+bool ei_microphone_inference_start_continuous(uint32_t n_samples);
 bool ei_microphone_inference_record_continuous(void);
+uint32_t ei_microphone_inference_get_overruns(void);
+void ei_microphone_inference_print_frontend_cycles(void);
 bool ei_microphone_inference_record(void);
 bool ei_microphone_inference_is_recording(void);
 void ei_microphone_inference_reset_buffers(void);
@@ -37,12 +37,34 @@
 #include "edge-impulse-sdk/dsp/numpy.hpp"
 #include "ei_microphone.h"
 #include "ei_device_interface.h"
+#include "uart_tracelib.h"
+#include "firmware-sdk-alif/ei_perf_lib.h"
+#include "firmware-sdk-alif/ei_cascade_lib.h"
+#include "firmware-sdk-alif/ei_threshold_lib.h"
+#include "firmware-sdk-alif/at-server/ei_at_command_set.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+/* Log output and input are queued, report if either queue ever filled up */
+static void print_uart_tx_overflows(void)
+{
+    uint32_t overflows = get_uart_tx_overflows();
+    if (overflows != 0) {
+        ei_printf("UART TX overflows: %u\n", (unsigned int)overflows);
+    }
+    overflows = get_uart_rx_overflows();
+    if (overflows != 0) {
+        ei_printf("UART RX overflows: %u\n", (unsigned int)overflows);
+    }
+}
 
 #if defined(EI_CLASSIFIER_SENSOR) && EI_CLASSIFIER_SENSOR == EI_CLASSIFIER_SENSOR_CAMERA
 #include "firmware-sdk-alif/ei_image_nn.h"
 #include <memory>
 
-void run_nn(bool debug) {
+static void run_nn_camera(bool debug, int delay_ms, bool use_max_baudrate) {
 
     // size enough for packed RGB888
     const int IMAGE_SIZE = EI_CLASSIFIER_INPUT_WIDTH * EI_CLASSIFIER_INPUT_HEIGHT * 3;
@@ -63,7 +85,95 @@ void run_nn(bool debug) {
         EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE,
         EI_CLASSIFIER_LABEL_COUNT);
 
-    imageNN.run_nn(debug, debug? 0:1000, debug);
+    imageNN.run_nn(debug, delay_ms, use_max_baudrate);
+}
+
+void run_nn(bool debug) {
+    run_nn_camera(debug, debug? 0:1000, debug);
+}
+
+void run_nn_continuous(bool debug) {
+    // back to back frames, so capture is pipelined with inference
+    run_nn_camera(debug, 0, false);
+}
+
+/* RTSS-HP side of the cascade: sleep with the camera off until the other
+ * core wakes us, then classify one frame and send back the top result.
+ */
+static void run_nn_cascade(const char **argv, int argc) {
+
+    const int IMAGE_SIZE = EI_CLASSIFIER_INPUT_WIDTH * EI_CLASSIFIER_INPUT_HEIGHT * 3;
+
+    uint8* image_p;
+    EI_ALLOCATE_AUTO_POINTER(image_p, IMAGE_SIZE);
+
+    if( !image_p ) {
+        ei_printf("ERR: run_nn out of memory\n");
+        return;
+    }
+
+    EiImageNN imageNN(
+        image_p,
+        IMAGE_SIZE,
+        EI_CLASSIFIER_INPUT_WIDTH,
+        EI_CLASSIFIER_INPUT_HEIGHT,
+        EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE,
+        EI_CLASSIFIER_LABEL_COUNT);
+
+    auto camera = EiCamera::get_camera();
+    if (!camera->init(EI_CLASSIFIER_INPUT_WIDTH, EI_CLASSIFIER_INPUT_HEIGHT)) {
+        ei_printf("ERR: Failed to initialize image sensor\r\n");
+        return;
+    }
+
+    if (!ei_cascade_transport_init()) {
+        ei_printf("ERR: Failed to open the link to the other core\n");
+        camera->deinit();
+        return;
+    }
+
+    camera->set_power(false);
+
+    ei_cascade_worker_t worker;
+    ei_cascade_worker_init(&worker);
+
+    ei_printf("Waiting for the other core to wake us, press 'b' to break\n");
+
+    while (!ei_user_invoke_stop_lib()) {
+        ei_cascade_msg_t msg;
+        if (!ei_cascade_transport_receive(&msg)) {
+            ei_cascade_transport_wait(100);
+            continue;
+        }
+        if (!ei_cascade_worker_receive(&worker, &msg)) {
+            continue;
+        }
+
+        ei_printf("Woken by %s (%.2f)\n", msg.label, msg.confidence);
+
+        ei_impulse_result_t result = { 0 };
+        const char *label = nullptr;
+        float confidence = 0.0f;
+
+        bool ok = camera->set_power(true) && imageNN.run_once(&result);
+        camera->set_power(false);
+        if (ok) {
+            display_results(&result);
+            ei_cascade_top_result(&result, &label, &confidence);
+        }
+
+        ei_cascade_msg_t reply;
+        ei_cascade_worker_done(&worker, ok, label, confidence, &reply);
+        if (!ei_cascade_transport_send(&reply)) {
+            ei_printf("ERR: Failed to send the result to the other core\n");
+        }
+    }
+
+    ei_printf("Served %u wakes\n", (unsigned int)worker.runs);
+
+    ei_cascade_transport_deinit();
+    camera->set_power(true);
+    camera->deinit();
 }
 
 
@@ -108,7 +218,9 @@ void run_nn(bool debug) {
         signal.get_data = &ei_microphone_audio_signal_get_data;
         ei_impulse_result_t result = { 0 };
 
+        ei_perf_begin();
         EI_IMPULSE_ERROR r = run_classifier(&signal, &result, debug);
+        ei_perf_end(&result, nullptr);
         if (r != EI_IMPULSE_OK) {
             ei_printf("ERR: Failed to run classifier (%d)\n", r);
             break;
@@ -155,11 +267,15 @@ void run_nn_continuous(bool debug)
     ei_printf("Starting inferencing, press 'b' to break\n");
 
     run_classifier_init();
-    ei_microphone_inference_start(EI_CLASSIFIER_SLICE_SIZE, (float)EI_CLASSIFIER_INTERVAL_MS);
+    if (ei_microphone_inference_start_continuous(EI_CLASSIFIER_SLICE_SIZE) == false) {
+        ei_printf("ERR: Failed to setup audio sampling\r\n");
+        run_classifier_deinit();
+        return;
+    }
 
     while (stop_inferencing == false) {
 
-        bool m = ei_microphone_inference_record();
+        bool m = ei_microphone_inference_record_continuous();
         if (!m) {
             ei_printf("ERR: Failed to record audio...\n");
             break;
@@ -170,7 +286,9 @@ void run_nn_continuous(bool debug)
         signal.get_data = &ei_microphone_audio_signal_get_data;
         ei_impulse_result_t result = {0};
 
+        ei_perf_begin();
         EI_IMPULSE_ERROR r = run_classifier_continuous(&signal, &result, debug);
+        ei_perf_end(&result, nullptr);
         if (r != EI_IMPULSE_OK) {
             ei_printf("ERR: Failed to run classifier (%d)\n", r);
             break;
@@ -178,6 +296,8 @@ void run_nn_continuous(bool debug)
 
         if (++print_results >= (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW >> 1)) {
             display_results(&result);
+            ei_printf("Audio overruns: %u\n", (unsigned int)ei_microphone_inference_get_overruns());
+            ei_microphone_inference_print_frontend_cycles();
             print_results = 0;
         }
 
@@ -191,6 +311,154 @@ void run_nn_continuous(bool debug)
     run_classifier_deinit();
 }
 
+/* Root mean square of the current slice, 0 to 1 */
+static float slice_level(void)
+{
+    float chunk[256];
+    float sum = 0.0f;
+
+    for (size_t offset = 0; offset < EI_CLASSIFIER_SLICE_SIZE; offset += sizeof(chunk) / sizeof(chunk[0])) {
+        size_t length = std::min(sizeof(chunk) / sizeof(chunk[0]), (size_t)EI_CLASSIFIER_SLICE_SIZE - offset);
+        ei_microphone_audio_signal_get_data(offset, length, chunk);
+        for (size_t ix = 0; ix < length; ix++) {
+            sum += chunk[ix] * chunk[ix];
+        }
+    }
+
+    return sqrtf(sum / EI_CLASSIFIER_SLICE_SIZE);
+}
+
+/* RTSS-HE side of the cascade: listen continuously and wake the other core
+ * when the wake label (or with VAD, any sound over the level) is detected.
+ */
+static void run_nn_cascade(const char **argv, int argc)
+{
+    if (EI_CLASSIFIER_FREQUENCY != 16000) {
+        ei_printf("ERR: Frequency is %d but can only sample at 16000Hz\n", (int)EI_CLASSIFIER_FREQUENCY);
+        return;
+    }
+
+    if (argc < 1) {
+        ei_printf("Missing argument! Required: " AT_RUNCASCADE_ARGS "\n");
+        return;
+    }
+
+    // the AT server reuses argv for commands typed while we run
+    char wake_label[EI_CASCADE_LABEL_LEN] = { 0 };
+    strncpy(wake_label, argv[0], sizeof(wake_label) - 1);
+
+    const bool vad = strcmp(wake_label, "VAD") == 0;
+    const float threshold = argc >= 2 ? (float)atof(argv[1]) :
+        vad ? EI_CASCADE_VAD_THRESHOLD : EI_CASCADE_THRESHOLD;
+
+    ei_cascade_waker_t waker;
+    ei_cascade_waker_init(&waker, vad ? nullptr : wake_label, threshold, EI_CASCADE_TIMEOUT_MS);
+
+    if (!ei_cascade_transport_init()) {
+        ei_printf("ERR: Failed to open the link to the other core\n");
+        return;
+    }
+
+    if (vad) {
+        ei_printf("Waking the other core on sound over %.3f, press 'b' to break\n", threshold);
+    }
+    else {
+        ei_printf("Waking the other core on %s over %.2f, press 'b' to break\n", wake_label, threshold);
+        run_classifier_init();
+    }
+
+    if (ei_microphone_inference_start_continuous(EI_CLASSIFIER_SLICE_SIZE) == false) {
+        ei_printf("ERR: Failed to setup audio sampling\r\n");
+        if (!vad) {
+            run_classifier_deinit();
+        }
+        ei_cascade_transport_deinit();
+        return;
+    }
+
+    // the first windows are still partly empty
+    int warmup = vad ? 0 : EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW;
+
+    // AT+THRESHOLD while we run replaces the threshold we started with
+    uint32_t threshold_changes = ei_threshold_changes();
+
+    while (!ei_user_invoke_stop_lib()) {
+
+        bool m = ei_microphone_inference_record_continuous();
+        if (!m) {
+            ei_printf("ERR: Failed to record audio...\n");
+            break;
+        }
+
+        const char *label = nullptr;
+        float confidence = 0.0f;
+
+        if (vad) {
+            label = "sound";
+            confidence = slice_level();
+        }
+        else {
+            signal_t signal;
+            signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
+            signal.get_data = &ei_microphone_audio_signal_get_data;
+            ei_impulse_result_t result = {0};
+
+            EI_IMPULSE_ERROR r = run_classifier_continuous(&signal, &result, false);
+            if (r != EI_IMPULSE_OK) {
+                ei_printf("ERR: Failed to run classifier (%d)\n", r);
+                break;
+            }
+            ei_cascade_top_result(&result, &label, &confidence);
+        }
+
+        if (ei_threshold_changes() != threshold_changes) {
+            threshold_changes = ei_threshold_changes();
+            waker.threshold = ei_threshold_get();
+            ei_printf("Wake threshold now %.3f\n", waker.threshold);
+        }
+
+        uint64_t now_ms = ei_read_timer_ms();
+        ei_cascade_msg_t msg;
+
+        if (warmup > 0) {
+            warmup--;
+        }
+        else if (ei_cascade_waker_detect(&waker, label, confidence, now_ms, &msg)) {
+            ei_printf("Waking the other core: %s (%.2f)\n", label, confidence);
+            if (!ei_cascade_transport_send(&msg)) {
+                ei_printf("ERR: Failed to wake the other core\n");
+            }
+        }
+
+        while (ei_cascade_transport_receive(&msg)) {
+            if (!ei_cascade_waker_receive(&waker, &msg)) {
+                continue;
+            }
+            if (msg.type == EI_CASCADE_MSG_RESULT) {
+                ei_printf("Other core: %s (%.2f)\n", msg.label[0] ? msg.label : "nothing", msg.confidence);
+            }
+            else {
+                ei_printf("Other core failed to run its impulse\n");
+            }
+        }
+
+        if (ei_cascade_waker_poll(&waker, now_ms)) {
+            ei_printf("No answer from the other core\n");
+        }
+    }
+
+    ei_printf("Wakes: %u, results: %u, timeouts: %u\n",
+        (unsigned int)waker.wakes,
+        (unsigned int)waker.results,
+        (unsigned int)waker.timeouts);
+
+    ei_microphone_inference_end();
+    if (!vad) {
+        run_classifier_deinit();
+    }
+    ei_cascade_transport_deinit();
+}
+
 #else
 
 void run_nn(bool debug) {}
@@ -200,17 +468,32 @@ void run_nn(bool debug) {}
 
 bool run_nn_normal(void) {
     run_nn(false);
+    print_uart_tx_overflows();
     return true;
 }
 
 bool run_nn_debug(const char**, int) {
     run_nn(true);
+    print_uart_tx_overflows();
+    return true;
+}
+
+bool run_nn_cascade_normal(void) {
+    run_nn_cascade(nullptr, 0);
+    print_uart_tx_overflows();
+    return true;
+}
+
+bool run_nn_cascade_args(const char **argv, const int argc) {
+    run_nn_cascade(argv, argc);
+    print_uart_tx_overflows();
     return true;
 }
 
 bool run_nn_continuous_normal(void) {
-#if defined(EI_CLASSIFIER_SENSOR) && EI_CLASSIFIER_SENSOR == EI_CLASSIFIER_SENSOR_MICROPHONE
+#if defined(EI_CLASSIFIER_SENSOR) && (EI_CLASSIFIER_SENSOR == EI_CLASSIFIER_SENSOR_MICROPHONE || EI_CLASSIFIER_SENSOR == EI_CLASSIFIER_SENSOR_CAMERA)
     run_nn_continuous(false);
+    print_uart_tx_overflows();
 #else
     ei_printf("Error no continuous classification available for current model\r\n");
 #endif
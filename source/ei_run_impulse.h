@@ -39,5 +39,7 @@
 bool run_nn_normal(void);
 bool run_nn_debug(const char**, int);
 bool run_nn_continuous_normal(void);
+bool run_nn_cascade_normal(void);
+bool run_nn_cascade_args(const char **argv, const int argc);
 
 #endif
\ No newline at end of file
@@ -31,58 +31,57 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
-// #ifndef _EDGE_IMPULSE_SIGNING_MBEDTLS_HMAC_SHA256_H_
-// #define _EDGE_IMPULSE_SIGNING_MBEDTLS_HMAC_SHA256_H_
-
 /**
- * HMAC SHA256 implementation using Mbed TLS
+ * HMAC SHA256 signing for sensor_aq
  */
 
 #include <string.h>
-#include "sensor_aq.h"
-//#include "ei_mbedtls_md.h"
-
+#include "sensor_aq_mbedtls_hs256.h"
 
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 
-typedef struct {
-    // mbedtls_md_context_t md_ctx;
-    char hmac_key[33];
-} sensor_aq_mbedtls_hs256_ctx_t;
-
 static int sensor_aq_mbedtls_hs256_init(sensor_aq_signing_ctx_t *aq_ctx) {
     sensor_aq_mbedtls_hs256_ctx_t *hs_ctx = (sensor_aq_mbedtls_hs256_ctx_t*)aq_ctx->ctx;
 
+    // the key pads are hashed once, in sensor_aq_init_mbedtls_hs256_context
+    ei_hmac_sha256_reset(&hs_ctx->hmac_ctx);
+
     return 0;
 }
 
 static int sensor_aq_mbedtls_hs256_update(sensor_aq_signing_ctx_t *aq_ctx, const uint8_t *buffer, size_t buffer_size) {
     sensor_aq_mbedtls_hs256_ctx_t *hs_ctx = (sensor_aq_mbedtls_hs256_ctx_t*)aq_ctx->ctx;
 
+    ei_hmac_sha256_update(&hs_ctx->hmac_ctx, buffer, buffer_size);
+
     return 0;
 }
 
 static int sensor_aq_mbedtls_hs256_finish(sensor_aq_signing_ctx_t *aq_ctx, uint8_t *buffer) {
     sensor_aq_mbedtls_hs256_ctx_t *hs_ctx = (sensor_aq_mbedtls_hs256_ctx_t*)aq_ctx->ctx;
 
+    ei_hmac_sha256_finish(&hs_ctx->hmac_ctx, buffer);
+
     return 0;
 }
 
 /**
- * Construct a new signing context for HMAC SHA256 using Mbed TLS
+ * Construct a new signing context for HMAC SHA256
  *
  * @param aq_ctx An empty signing context (can declare it without arguments)
  * @param hs_ctx An empty sensor_aq_mbedtls_hs256_ctx_t context (can declare it on the stack without arguments)
  * @param hmac_key The secret key - **NOTE: this is limited to 32 characters, the rest will be truncated**
  */
 void sensor_aq_init_mbedtls_hs256_context(sensor_aq_signing_ctx_t *aq_ctx, sensor_aq_mbedtls_hs256_ctx_t *hs_ctx, const char *hmac_key) {
-    memcpy(hs_ctx->hmac_key, hmac_key, 32);
+    strncpy(hs_ctx->hmac_key, hmac_key, 32);
     hs_ctx->hmac_key[32] = 0;
 
     if (strlen(hmac_key) > 32) {
         ei_printf("!!! sensor_aq_init_mbedtls_hs256_context, HMAC key is longer than 32 characters - will be truncated !!!\n");
     }
 
+    ei_hmac_sha256_starts(&hs_ctx->hmac_ctx, (const uint8_t*)hs_ctx->hmac_key, strlen(hs_ctx->hmac_key));
+
     aq_ctx->alg = "HS256"; // JWS algorithm
     aq_ctx->signature_length = 32;
     aq_ctx->ctx = (void*)hs_ctx;
@@ -91,4 +90,3 @@ void sensor_aq_init_mbedtls_hs256_context(sensor_aq_signing_ctx_t *aq_ctx, senso
     aq_ctx->update = &sensor_aq_mbedtls_hs256_update;
     aq_ctx->finish = &sensor_aq_mbedtls_hs256_finish;
 }
-// _EDGE_IMPULSE_SIGNING_MBEDTLS_HMAC_SHA256_H_
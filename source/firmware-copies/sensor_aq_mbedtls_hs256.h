@@ -35,25 +35,20 @@
 #define _EDGE_IMPULSE_SIGNING_MBEDTLS_HMAC_SHA256_H_
 
 /**
- * HMAC SHA256 implementation using Mbed TLS
+ * HMAC SHA256 signing context for sensor_aq, backed by ei_hmac_sha256
+ * (the name is kept from the Mbed TLS based version)
  */
 
-//#include <string.h>
 #include "sensor_aq.h"
-#include "mbedtls/md.h"
-//#include "mbedtls/sha256.h"
-//#include "mbed_trace.h"
-//#include "ei_mbedtls_md.h"
-
-//#ifdef MBEDTLS_MD_C
+#include "ei_hmac_sha256.h"
 
 typedef struct {
-    mbedtls_md_context_t md_ctx;
+    ei_hmac_sha256_ctx_t hmac_ctx;
     char hmac_key[33];
 } sensor_aq_mbedtls_hs256_ctx_t;
 
 /**
- * Construct a new signing context for HMAC SHA256 using Mbed TLS
+ * Construct a new signing context for HMAC SHA256
  *
  * @param aq_ctx An empty signing context (can declare it without arguments)
  * @param hs_ctx An empty sensor_aq_mbedtls_hs256_ctx_t context (can declare it on the stack without arguments)
@@ -61,10 +56,4 @@ typedef struct {
  */
 void sensor_aq_init_mbedtls_hs256_context(sensor_aq_signing_ctx_t *aq_ctx, sensor_aq_mbedtls_hs256_ctx_t *hs_ctx, const char *hmac_key);
 
-// #else
-
-// #error "sensor_aq_mbedtls_hs256 loaded but Mbed TLS was not found, or MBEDTLS_MD_C was disabled"
-
-// #endif // MBEDTLS_MD_C
-
 #endif // _EDGE_IMPULSE_SIGNING_MBEDTLS_HMAC_SHA256_H_
@@ -48,6 +48,20 @@
 #define AT_RUNIMPULSEDEBUG_HELP_TEXT "Run the impulse with additional debug output or live preview"
 #define AT_RUNIMPULSECONT            "RUNIMPULSECONT"
 #define AT_RUNIMPULSECONT_HELP_TEXT  "Run the impulse continuously"
+#define AT_RUNCASCADE                "RUNCASCADE"
+#define AT_RUNCASCADE_ARGS           "WAKELABEL|VAD,[THRESHOLD]"
+#define AT_RUNCASCADE_HELP_TEXT      "Run the dual-core cascade: audio models wake the other core on WAKELABEL (or any sound with VAD), camera models classify when woken"
+#define AT_TRANSPORT                 "TRANSPORT"
+#define AT_TRANSPORT_ARGS            "MODE"
+#define AT_TRANSPORT_HELP_TEXT       "Lists or sets the bulk data transport (BASE64 or BINARY)"
+#define AT_JPEG                      "JPEG"
+#define AT_JPEG_ARGS                 "QUALITY,SUBSAMPLE"
+#define AT_JPEG_HELP_TEXT            "Lists or sets JPEG quality (BEST, HIGH, MED, LOW) and subsampling (444, 420)"
+#define AT_PERF                      "PERF"
+#define AT_PERF_HELP_TEXT            "Lists cycle, NPU and AXI counters of the last inference"
+#define AT_THRESHOLD                 "THRESHOLD"
+#define AT_THRESHOLD_ARGS            "VALUE"
+#define AT_THRESHOLD_HELP_TEXT       "Lists or sets the minimum confidence of reported objects and of cascade wakes (0 to 1)"
 
 /*************************************************************************************************/
 /* platform specific commands */
@@ -57,10 +71,10 @@
 #define AT_SCANWIFI                 "SCANWIFI"
 #define AT_SCANWIFI_HELP_TEXT       "Scans for WiFi networks"
 #define AT_SNAPSHOT                 "SNAPSHOT"
-#define AT_SNAPSHOT_ARGS            "WIDTH,HEIGHT,[USEMAXRATE]"
+#define AT_SNAPSHOT_ARGS            "WIDTH,HEIGHT,[USEMAXRATE],[FORMAT]"
 #define AT_SNAPSHOT_HELP_TEXT       "Take a snapshot"
 #define AT_SNAPSHOTSTREAM           "SNAPSHOTSTREAM"
-#define AT_SNAPSHOTSTREAM_ARGS      "WIDTH,HEIGHT,[USEMAXRATE]"
+#define AT_SNAPSHOTSTREAM_ARGS      "WIDTH,HEIGHT,[USEMAXRATE],[FORMAT]"
 #define AT_SNAPSHOTSTREAM_HELP_TEXT "Take a stream of snapshot stream"
 
 /*************************************************************************************************/
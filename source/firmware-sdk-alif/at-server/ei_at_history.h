@@ -1,46 +1,63 @@
 #ifndef AT_HISTORY_H
 #define AT_HISTORY_H
-#include <string>
-#include <vector>
+
+#include "ei_line_buffer.h"
+#include <cstddef>
+#include <cstring>
+
+/* Most history entries kept, regardless of the size asked for */
+#ifndef AT_HISTORY_MAX_SIZE
+#define AT_HISTORY_MAX_SIZE 10
+#endif
 
 class ATHistory {
 private:
-    std::vector<std::string> history;
+    // ring of entries, oldest at 'first'
+    char history[AT_HISTORY_MAX_SIZE][AT_LINE_BUFFER_SIZE + 1];
     const size_t history_max_size;
+    size_t first;
+    size_t count;
     size_t history_position;
 
+    const char *entry(size_t ix)
+    {
+        return history[(first + ix) % AT_HISTORY_MAX_SIZE];
+    }
+
 public:
     ATHistory(size_t max_size = 10)
-        : history_max_size(max_size)
+        : history_max_size(max_size > AT_HISTORY_MAX_SIZE ? AT_HISTORY_MAX_SIZE : max_size)
+        , first(0)
+        , count(0)
         , history_position(0) {};
 
-    std::string go_back(void)
+    const char *go_back(void)
     {
         if (!is_at_begin()) {
             history_position--;
         }
 
-        if (history.size() == 0) {
-            return std::string("");
+        if (count == 0) {
+            return "";
         }
         else {
-            return history[history_position];
+            return entry(history_position);
         }
     }
 
-    std::string go_next(void)
+    const char *go_next(void)
     {
-        if (++history_position >= history.size()) {
-            history_position = history.size();
-            return std::string("");
+        if (++history_position >= count) {
+            history_position = count;
+            return "";
         }
 
-        return history[history_position];
+        return entry(history_position);
     }
 
     bool is_at_end(void)
     {
-        return history_position == history.size();
+        return history_position == count;
     }
 
     bool is_at_begin(void)
@@ -48,21 +65,26 @@ public:
         return history_position == 0;
     }
 
-    void add(std::string &entry)
+    void add(const char *line)
     {
         // don't add empty entries
-        if (entry == "") {
+        if (line[0] == '\0' || history_max_size == 0) {
             return;
         }
 
-        history.push_back(entry);
-
-        if (history.size() > history_max_size) {
-            history.erase(history.begin());
+        if (count == history_max_size) {
+            // drop the oldest
+            first = (first + 1) % AT_HISTORY_MAX_SIZE;
+            count--;
         }
 
-        history_position = history.size();
+        char *slot = history[(first + count) % AT_HISTORY_MAX_SIZE];
+        strncpy(slot, line, AT_LINE_BUFFER_SIZE);
+        slot[AT_LINE_BUFFER_SIZE] = '\0';
+        count++;
+
+        history_position = count;
     }
 };
 
-#endif /* AT_HISTORY_H */
\ No newline at end of file
+#endif /* AT_HISTORY_H */
@@ -1,80 +1,75 @@
 #include "ei_at_parser.h"
-
-using namespace std;
+#include <cstring>
 
 void ATParser::init_result(void)
 {
     last_result.type = AT_UNKNOWN;
-    last_result.command.clear();
-    last_result.arguments.clear();
-    last_result.max_arg_len = 0;
+    last_result.command = "";
+    last_result.argument_count = 0;
 }
 
-const ATParseResult_t &ATParser::parse(string input)
+const ATParseResult_t &ATParser::parse(char *input)
 {
-    string tmp;
-    size_t pos = string::npos;
-    size_t delim1 = string::npos;
-    size_t delim2 = string::npos;
-
     this->init_result();
 
-    if (input.size() == 0) {
-        last_result.type = AT_UNKNOWN;
-        return last_result;
-    }
-
     // trim leading whitespaces
-    input = input.substr(input.find_first_not_of(" \t"));
+    input += strspn(input, " \t");
 
-    if (input.rfind("AT+", 0) != 0) {
-        last_result.type = AT_UNKNOWN;
+    if (strncmp(input, "AT+", 3) != 0) {
         return last_result;
     }
 
     //remove "AT+"
-    input = input.substr(3);
+    input += 3;
 
     // trim spaces, newline and CR at the end
-    input = input.erase(input.find_last_not_of(" \r\n") + 1);
+    size_t len = strlen(input);
+    while (len > 0 && strchr(" \r\n", input[len - 1]) != nullptr) {
+        input[--len] = '\0';
+    }
 
     // extract command itself
-    pos = input.find_first_of("?=");
-    last_result.command = input.substr(0, pos);
+    char *delim = strpbrk(input, "?=");
+    last_result.command = input;
 
-    if (pos == string::npos) {
+    if (delim == nullptr) {
         last_result.type = AT_RUN;
-    }
-    else if (input.at(pos) == '=') {
-        last_result.type = AT_WRITE;
-    }
-    else if (input.at(pos) == '?') {
-        last_result.type = AT_READ;
-    }
-    else {
-        last_result.type = AT_UNKNOWN;
+        return last_result;
     }
 
+    last_result.type = (*delim == '=') ? AT_WRITE : AT_READ;
+    char sep = *delim;
+    *delim = '\0';
+
     // check if command has arguments and extract them
-    if (pos != string::npos && input.at(pos) == '=') {
-        delim1 = pos;
-        delim2 = input.find_first_of(",", pos);
-        // we have arguments, let's extract them
-        while (delim2 != string::npos) {
-            //TODO: support args in a quote
-            tmp = string(input, delim1 + 1, delim2 - delim1 - 1);
-            last_result.arguments.push_back(tmp);
-            if (tmp.size() > last_result.max_arg_len) {
-                last_result.max_arg_len = tmp.size();
+    if (sep == '=') {
+        char *arg = delim + 1;
+        while (true) {
+            if (last_result.argument_count == AT_MAX_ARGUMENTS) {
+                last_result.type = AT_UNKNOWN;
+                return last_result;
             }
-            delim1 = delim2;
-            delim2 = input.find_first_of(",", delim1 + 1);
-        }
-        //there is one more argument, behind last comma so, get it until end of command
-        tmp = string(input, delim1 + 1);
-        last_result.arguments.push_back(tmp);
-        if (tmp.size() > last_result.max_arg_len) {
-            last_result.max_arg_len = tmp.size();
+
+            // a quoted argument runs to the closing quote, commas included
+            char *end = arg;
+            if (*arg == '"') {
+                arg++;
+                char *quote = strchr(arg, '"');
+                if (quote == nullptr || (quote[1] != ',' && quote[1] != '\0')) {
+                    last_result.type = AT_UNKNOWN;
+                    return last_result;
+                }
+                *quote = '\0';
+                end = quote + 1;
+            }
+            last_result.arguments[last_result.argument_count++] = arg;
+
+            char *comma = strchr(end, ',');
+            if (comma == nullptr) {
+                break;
+            }
+            *comma = '\0';
+            arg = comma + 1;
         }
     }
 
@@ -1,7 +1,12 @@
 #ifndef AT_PARSER_H
 #define AT_PARSER_H
-#include <string>
-#include <vector>
+
+#include <cstddef>
+
+/* Most comma separated arguments a write command can take */
+#ifndef AT_MAX_ARGUMENTS
+#define AT_MAX_ARGUMENTS 16
+#endif
 
 enum ATCommandType_t
 {
@@ -11,11 +16,12 @@ enum ATCommandType_t
     AT_UNKNOWN
 };
 
+/* All strings point into the parsed line */
 typedef struct {
     ATCommandType_t type;
-    std::string command;
-    std::vector<std::string> arguments;
-    unsigned int max_arg_len;
+    const char *command;
+    const char *arguments[AT_MAX_ARGUMENTS];
+    int argument_count;
 } ATParseResult_t;
 
 class ATParser {
@@ -26,7 +32,15 @@ private:
 public:
     ATParser() {};
     ~ATParser() {};
-    const ATParseResult_t &parse(std::string command);
+
+    /**
+     * @brief Split a command line in place: the separators in input are
+     * overwritten with NULs, so the result is only valid while input is.
+     * An argument in double quotes may contain commas; the quotes are removed.
+ * Lines with more than AT_MAX_ARGUMENTS arguments, or a quote that isn't
+ * closed at the end of its argument, are AT_UNKNOWN.
+     */
+    const ATParseResult_t &parse(char *input);
 };
 
-#endif /* AT_PARSER_H */
\ No newline at end of file
+#endif /* AT_PARSER_H */
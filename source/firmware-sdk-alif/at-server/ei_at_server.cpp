@@ -5,10 +5,6 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <functional>
-#include <vector>
-
-using namespace std;
 
 // fake handler (will never be called) just to make it
 // possible to register HELP command
@@ -19,12 +15,18 @@ static bool print_help_handler(void)
 
 ATServer::ATServer()
     : history(default_history_size)
+    , command_count(0)
+    , executing(false)
+    , stop_pending(false)
 {
     register_help_command();
 }
 
 ATServer::ATServer(ATCommand_t *commands, size_t length, size_t max_history_size)
     : history(max_history_size)
+    , command_count(0)
+    , executing(false)
+    , stop_pending(false)
 {
     if (length == 0 || commands == nullptr) {
         register_help_command();
@@ -52,9 +54,39 @@ void ATServer::register_help_command(void)
     tmp.run_handler = print_help_handler;
     tmp.read_handler = nullptr;
     tmp.write_handler = nullptr;
-    tmp.write_handler_args_list = string("");
+    tmp.write_handler_args_list = "";
+    tmp.async = false;
+
+    // bypasses the AT+HELP check in register_command
+    insert_command(tmp);
+}
+
+/**
+ * @brief Binary search the command table
+ *
+ * @param cmd command name, without "AT+"
+ * @return the entry, or nullptr if not registered
+ */
+ATCommand_t *ATServer::find_command(const char *cmd)
+{
+    size_t lo = 0;
+    size_t hi = command_count;
+
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int cmp = strcmp(cmd, registered_commands[mid].command);
+        if (cmp == 0) {
+            return &registered_commands[mid];
+        }
+        if (cmp < 0) {
+            hi = mid;
+        }
+        else {
+            lo = mid + 1;
+        }
+    }
 
-    this->registered_commands.push_back(tmp);
+    return nullptr;
 }
 
 /**
@@ -63,26 +95,42 @@ void ATServer::register_help_command(void)
  * 
  * @param command 
  * @return true if the command has been registered
- * @return false if some sanity checks failed
+ * @return false if some sanity checks failed, or the table is full
  */
 bool ATServer::register_command(ATCommand_t &command)
 {
     // we can't register user version of the AT+HELP command
-    if (command.command == AT_HELP) {
+    if (command.command == nullptr || strcmp(command.command, AT_HELP) == 0) {
         return false;
     }
 
-    // check if command exists
-    for (auto it = this->registered_commands.begin(); it != this->registered_commands.end(); ++it) {
-        if (it->command == command.command) {
-            // remove command that is already exist
-            this->registered_commands.erase(it);
-            // there shouldn't be another handler for same command
-            break;
-        }
+    return insert_command(command);
+}
+
+/**
+ * @brief Add or replace an entry, keeping the table sorted. Registration only
+ * happens at boot, so the insertion sort is cheap enough.
+ */
+bool ATServer::insert_command(const ATCommand_t &command)
+{
+    ATCommand_t *existing = find_command(command.command);
+    if (existing) {
+        *existing = command;
+        return true;
+    }
+
+    if (command_count == AT_MAX_COMMANDS) {
+        ei_printf("ERR: AT command table full, can't register AT+%s\n", command.command);
+        return false;
     }
 
-    this->registered_commands.push_back(command);
+    size_t ix = command_count;
+    while (ix > 0 && strcmp(registered_commands[ix - 1].command, command.command) > 0) {
+        registered_commands[ix] = registered_commands[ix - 1];
+        ix--;
+    }
+    registered_commands[ix] = command;
+    command_count++;
 
     return true;
 }
@@ -102,13 +150,44 @@ bool ATServer::register_command(
     temp_cmd.run_handler = run_handler;
     temp_cmd.read_handler = read_handler;
     temp_cmd.write_handler = write_handler;
-    if (write_handler_args_list != nullptr) {
-        temp_cmd.write_handler_args_list = string(write_handler_args_list);
-    }
+    temp_cmd.write_handler_args_list = write_handler_args_list ? write_handler_args_list : "";
+    temp_cmd.async = false;
 
     return this->register_command(temp_cmd);
 }
 
+/**
+ * @brief Allow the read and write handlers of a registered command to run
+ * while another command is executing, see \ref handle. Only for handlers
+ * that return quickly and don't disturb the running command, eg. changing a
+ * parameter it reads on every iteration.
+ *
+ * @return false if the command is not registered
+ */
+bool ATServer::set_async(const char *cmd, bool async)
+{
+    ATCommand_t *it = find_command(cmd);
+
+    if (it == nullptr) {
+        return false;
+    }
+
+    it->async = async;
+    return true;
+}
+
+/**
+ * @brief Check (and clear) a stop request, ie. a 'b' received while a
+ * command is executing. Long running commands poll this through
+ * \ref handle, see ei_user_invoke_stop_lib.
+ */
+bool ATServer::take_stop_request(void)
+{
+    bool ret = stop_pending;
+    stop_pending = false;
+    return ret;
+}
+
 bool ATServer::register_handlers(
     const char *cmd,
     bool (*run_handler)(void),
@@ -116,21 +195,22 @@ bool ATServer::register_handlers(
     bool (*write_handler)(const char **, const int),
     const char *write_handler_args_list)
 {
-    for (auto it = registered_commands.begin(); it != registered_commands.end(); ++it) {
-        if (it->command.compare(cmd) == 0) {
-            //TODO: add sanity checks?
-            it->run_handler = run_handler;
-            it->read_handler = read_handler;
-            it->write_handler = write_handler;
-            //TODO: parse write_handler_args_list and update write_handler_arg_count
-            if (write_handler_args_list != nullptr) {
-                it->write_handler_args_list = string(write_handler_args_list);
-            }
-            return true;
-        }
+    ATCommand_t *it = find_command(cmd);
+
+    if (it == nullptr) {
+        return false;
     }
 
-    return false;
+    //TODO: add sanity checks?
+    it->run_handler = run_handler;
+    it->read_handler = read_handler;
+    it->write_handler = write_handler;
+    //TODO: parse write_handler_args_list and update write_handler_arg_count
+    if (write_handler_args_list != nullptr) {
+        it->write_handler_args_list = write_handler_args_list;
+    }
+
+    return true;
 }
 
 bool ATServer::print_help(void)
@@ -147,30 +227,31 @@ bool ATServer::print_help(void)
      */
     ei_printf("AT Server\nCommand set version: " AT_COMMAND_VERSION "\n");
     ei_printf("Arguments in square brackets are optional, eg.:\nAT+CMD=arg1,[arg2]\n\n");
-    for (auto it = this->registered_commands.begin(); it != this->registered_commands.end(); ++it) {
+    for (size_t ix = 0; ix < command_count; ix++) {
+        const ATCommand_t *it = &registered_commands[ix];
         if (!it->run_handler && !it->read_handler && !it->write_handler) {
             continue;
         }
         /* print main command () */
         if (it->run_handler) {
-            ei_printf("AT+%s\n", it->command.c_str());
+            ei_printf("AT+%s\n", it->command);
             new_line_required = true;
         }
 
         if (it->read_handler) {
-            ei_printf("AT+%s?\n", it->command.c_str());
+            ei_printf("AT+%s?\n", it->command);
             new_line_required = true;
         }
 
-        if (it->write_handler && it->write_handler_args_list != "") {
-            ei_printf("AT+%s=%s\n", it->command.c_str(), it->write_handler_args_list.c_str());
+        if (it->write_handler && it->write_handler_args_list && it->write_handler_args_list[0] != '\0') {
+            ei_printf("AT+%s=%s\n", it->command, it->write_handler_args_list);
             new_line_required = true;
         }
 
         if (new_line_required) {
             // if new_line_required is true, it means at least one handler is active
-            if (!it->help_text.empty()) {
-                ei_printf("\t%s\n\n", it->help_text.c_str());
+            if (it->help_text && it->help_text[0] != '\0') {
+                ei_printf("\t%s\n\n", it->help_text);
             }
         }
     }
@@ -183,48 +264,65 @@ void ATServer::print_prompt(void)
     ei_printf("> ");
 }
 
+/**
+ * @brief Feed one received character. While a command is executing (ie. the
+ * running command feeds input from its stop polling) the character goes to
+ * \ref handle_async instead of the line editor.
+ */
 void ATServer::handle(char c)
 {
-    string tmp;
+    const char *tmp;
     bool print_new_prompt = true;
     static bool in_ctrl_char = false;
-    static vector<char> control_sequence;
+    static char control_sequence[AT_MAX_CONTROL_SEQUENCE];
+    static size_t control_sequence_len = 0;
+
+    if (executing) {
+        handle_async(c);
+        return;
+    }
 
     // control characters start with 0x1b and end with a-zA-Z
     // typically \x1b[<LETTER> eg. \x1b[A
     if (in_ctrl_char) {
-        control_sequence.push_back(c);
+        if (control_sequence_len == AT_MAX_CONTROL_SEQUENCE) {
+            // not a sequence we know, drop it
+            in_ctrl_char = false;
+            control_sequence_len = 0;
+            return;
+        }
+        control_sequence[control_sequence_len++] = c;
         // if a-zA-Z then it's the last one in the control char...
         if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c == 0x7e)) {
             in_ctrl_char = false;
             // up: \x1b[A
-            if (control_sequence.size() == 2 && control_sequence.at(0) == 0x5b &&
-                control_sequence.at(1) == 0x41) {
+            if (control_sequence_len == 2 && control_sequence[0] == 0x5b &&
+                control_sequence[1] == 0x41) {
 
                 ei_printf("\x1b[u"); // restore current position
                 tmp = history.go_back();
                 // ei_printf("\r\x1b[K> %s", tmp.c_str());
-                ei_printf("\x1b[2K\r> %s", tmp.c_str());
+                ei_printf("\x1b[2K\r> %s", tmp);
                 buffer.clear();
                 buffer.add(tmp);
             }
             // down: \x1b[B
             else if (
-                control_sequence.size() == 2 && control_sequence.at(0) == 0x5b &&
-                control_sequence.at(1) == 0x42) {
+                control_sequence_len == 2 && control_sequence[0] == 0x5b &&
+                control_sequence[1] == 0x42) {
 
                 ei_printf("\x1b[u"); // restore current position
                 tmp = history.go_next();
                 // reset cursor to 0, do \r, then write the new command...
                 // ei_printf("\r\x1b[K> %s", tmp.c_str());
-                ei_printf("\x1b[2K\r> %s", tmp.c_str());
+                ei_printf("\x1b[2K\r> %s", tmp);
                 buffer.clear();
                 buffer.add(tmp);
             }
             // left: \x1b[D
             else if (
-                control_sequence.size() == 2 && control_sequence.at(0) == 0x5b &&
-                control_sequence.at(1) == 0x44) {
+                control_sequence_len == 2 && control_sequence[0] == 0x5b &&
+                control_sequence[1] == 0x44) {
 
                 size_t curr = buffer.get_position();
 
@@ -236,15 +334,15 @@ void ATServer::handle(char c)
                 else {
                     buffer.set_position(curr - 1);
                     ei_putchar('\x1b');
-                    for (size_t ix = 0; ix < control_sequence.size(); ix++) {
+                    for (size_t ix = 0; ix < control_sequence_len; ix++) {
                         ei_putchar(control_sequence[ix]);
                     }
                 }
             }
             // right: \x1b[C
             else if (
-                control_sequence.size() == 2 && control_sequence.at(0) == 0x5b &&
-                control_sequence.at(1) == 0x43) {
+                control_sequence_len == 2 && control_sequence[0] == 0x5b &&
+                control_sequence[1] == 0x43) {
 
                 size_t curr = buffer.get_position();
 
@@ -255,55 +353,55 @@ void ATServer::handle(char c)
                 else {
                     buffer.set_position(curr + 1);
                     ei_putchar('\x1b');
-                    for (size_t ix = 0; ix < control_sequence.size(); ix++) {
+                    for (size_t ix = 0; ix < control_sequence_len; ix++) {
                         ei_putchar(control_sequence[ix]);
                     }
                 }
             }
             // HOME key: \x1b[H
             else if (
-                control_sequence.size() == 2 && control_sequence.at(0) == 0x5b &&
-                control_sequence.at(1) == 0x48) {
+                control_sequence_len == 2 && control_sequence[0] == 0x5b &&
+                control_sequence[1] == 0x48) {
                 // move to begining of the buffer...
                 buffer.set_position(0);
                 // ...and the line
                 ei_printf(
                     "\r\x1b[K> %s\x1b[%uG",
-                    buffer.get_string().c_str(),
+                    buffer.get_string(),
                     buffer.get_position() + 3);
             }
             // END key: \x1b[F
             else if (
-                control_sequence.size() == 2 && control_sequence.at(0) == 0x5b &&
-                control_sequence.at(1) == 0x46) {
+                control_sequence_len == 2 && control_sequence[0] == 0x5b &&
+                control_sequence[1] == 0x46) {
                 // move to end of the buffer...
                 buffer.set_position(buffer.size());
                 // ...and the line
                 ei_printf(
                     "\r\x1b[K> %s\x1b[%uG",
-                    buffer.get_string().c_str(),
+                    buffer.get_string(),
                     buffer.get_position() + 3);
             }
             // DELETE key: \x1b[3\x7e
             else if (
-                control_sequence.size() == 3 && control_sequence.at(0) == 0x5b &&
-                control_sequence.at(1) == 0x33 && control_sequence.at(2) == 0x7e) {
+                control_sequence_len == 3 && control_sequence[0] == 0x5b &&
+                control_sequence[1] == 0x33 && control_sequence[2] == 0x7e) {
                 if (buffer.do_delete()) {
                     ei_printf(
                         "\r\x1b[K> %s\x1b[%uG",
-                        buffer.get_string().c_str(),
+                        buffer.get_string(),
                         buffer.get_position() + 3);
                 }
             }
             else {
                 // not up/down? execute original control sequence
                 ei_putchar('\x1b');
-                for (size_t ix = 0; ix < control_sequence.size(); ix++) {
+                for (size_t ix = 0; ix < control_sequence_len; ix++) {
                     ei_putchar(control_sequence[ix]);
                 }
             }
 
-            control_sequence.clear();
+            control_sequence_len = 0;
         }
         return;
     }
@@ -314,11 +412,14 @@ void ATServer::handle(char c)
     case '\r': /* want to run the buffer */
         ei_putchar(c);
         ei_putchar('\n');
-        tmp = buffer.get_string();
 
-        history.add(tmp);
+        history.add(buffer.get_string());
 
-        print_new_prompt = execute(tmp);
+        stop_pending = false;
+        async_buffer.clear();
+        executing = true;
+        print_new_prompt = execute(buffer.get_string());
+        executing = false;
 
         buffer.clear();
 
@@ -331,7 +432,7 @@ void ATServer::handle(char c)
         if (buffer.do_backspace() == false) {
             break;
         }
-        ei_printf("\r\x1b[K> %s\x1b[%uG", buffer.get_string().c_str(), buffer.get_position() + 3);
+        ei_printf("\r\x1b[K> %s\x1b[%uG", buffer.get_string(), buffer.get_position() + 3);
         break;
     case 0x1b: /* control character */
         // start processing characters as they are control sequence
@@ -340,74 +441,140 @@ void ATServer::handle(char c)
         break;
     default:
         if (c >= 0x20 && c <= 0x7e) {
-            buffer.add(c);
+            if (!buffer.add(c)) {
+                // line full, ignore until enter or backspace
+                break;
+            }
             if (buffer.is_at_end()) {
                 ei_putchar(c);
             }
             else {
-                ei_printf("\r> %s\x1b[%uG", buffer.get_string().c_str(), buffer.get_position() + 3);
+                ei_printf("\r> %s\x1b[%uG", buffer.get_string(), buffer.get_position() + 3);
             }
         }
         break;
     }
 }
 
-bool ATServer::execute(string &input)
+bool ATServer::execute(char *input)
 {
     bool new_prompt_required = false;
-    char **args = nullptr;
-    ATParseResult_t res;
 
-    res = parser.parse(input);
+    if (strncmp(input + strspn(input, " \t"), "AT+", 3) != 0) {
+        ei_printf("Not a valid AT command (%s)\n", input);
+        return true;
+    }
+
+    const ATParseResult_t &res = parser.parse(input);
     if (res.type == AT_UNKNOWN) {
-        ei_printf("Not a valid AT command (%s)\n", input.c_str());
+        ei_printf("Invalid arguments for AT+%s (max %d, quotes must be closed)\n", res.command, AT_MAX_ARGUMENTS);
         return true;
     }
 
     // exception for HELP command which is built-in
-    if (res.command == AT_HELP && res.type == AT_RUN) {
+    if (strcmp(res.command, AT_HELP) == 0 && res.type == AT_RUN) {
         return this->print_help();
     }
 
     // find a command to execute
-    for (auto it = this->registered_commands.begin(); it != this->registered_commands.end(); ++it) {
-        if (it->command == res.command) {
-            // we've got a hit!
-            if (res.type == AT_RUN && it->run_handler) {
-                // simple command like AT+HELP
-                new_prompt_required = it->run_handler();
-            }
-            else if (res.type == AT_READ && it->read_handler) {
-                // read command like AT+CONFIG?
-                new_prompt_required = it->read_handler();
-            }
-            else if (res.type == AT_WRITE && it->write_handler) {
-                // write command like AT+DEVICEID=abcde
-                args = (char **)ei_malloc(res.arguments.size() * sizeof(char *));
-                for (unsigned int i = 0; i < res.arguments.size(); i++) {
-                    // one more byte for null terminator (in case of zero-length = empty argument eg. AT+RUN=123,,5)
-                    args[i] = (char *)ei_malloc(res.max_arg_len + 1);
-                    strncpy(args[i], res.arguments.at(i).c_str(), res.max_arg_len + 1);
-                }
+    ATCommand_t *it = find_command(res.command);
+    if (it == nullptr) {
+        ei_printf("Command not found! (AT+%s)\n", res.command);
+        return true;
+    }
 
-                new_prompt_required =
-                    it->write_handler((const char **)args, (int)res.arguments.size());
+    if (res.type == AT_RUN && it->run_handler) {
+        // simple command like AT+HELP
+        new_prompt_required = it->run_handler();
+    }
+    else if (res.type == AT_READ && it->read_handler) {
+        // read command like AT+CONFIG?
+        new_prompt_required = it->read_handler();
+    }
+    else if (res.type == AT_WRITE && it->write_handler) {
+        // write command like AT+DEVICEID=abcde, arguments point into the line buffer
+        new_prompt_required = it->write_handler(
+            const_cast<const char **>(res.arguments),
+            res.argument_count);
+    }
+    else {
+        ei_printf("No handler for command! (AT+%s)\n", res.command);
+        return true;
+    }
 
-                // now we are freeing the memory
-                for (unsigned int i = 0; i < res.arguments.size(); i++) {
-                    ei_free(args[i]);
-                }
-                ei_free(args);
-            }
-            else {
-                ei_printf("No handler for command! (%s)\n", input.c_str());
-                return true;
-            }
-            return new_prompt_required;
+    return new_prompt_required;
+}
+
+/**
+ * @brief Input while a command is executing. There is no echo or line
+ * editing (output belongs to the running command): a 'b' at the start of a
+ * line requests a stop, other lines run as commands on CR or LF.
+ */
+void ATServer::handle_async(char c)
+{
+    switch (c) {
+    case '\r':
+    case '\n':
+        if (!async_buffer.is_empty()) {
+            execute_async(async_buffer.get_string());
+            async_buffer.clear();
+        }
+        break;
+    case 0x08:
+    case 0x7f:
+        async_buffer.do_backspace();
+        break;
+    case 'b':
+        if (async_buffer.is_empty()) {
+            stop_pending = true;
+            break;
         }
+        async_buffer.add(c);
+        break;
+    default:
+        if (c >= 0x20 && c <= 0x7e) {
+            async_buffer.add(c);
+        }
+        break;
+    }
+}
+
+/**
+ * @brief Run a command received while another one is executing. Uses its own
+ * parser, the running command's arguments still point into the first one.
+ * Only read and write handlers of commands marked with \ref set_async run.
+ */
+void ATServer::execute_async(char *input)
+{
+    if (strncmp(input + strspn(input, " \t"), "AT+", 3) != 0) {
+        ei_printf("Not a valid AT command (%s)\n", input);
+        return;
     }
 
-    // we shouldn't be here!
-    ei_printf("Command not found! (AT+%s)\n", res.command.c_str());
-    return true;
+    const ATParseResult_t &res = async_parser.parse(input);
+    if (res.type == AT_UNKNOWN) {
+        ei_printf("Invalid arguments for AT+%s (max %d, quotes must be closed)\n", res.command, AT_MAX_ARGUMENTS);
+        return;
+    }
+
+    ATCommand_t *it = find_command(res.command);
+    if (it == nullptr) {
+        ei_printf("Command not found! (AT+%s)\n", res.command);
+        return;
+    }
+
+    if (!it->async || res.type == AT_RUN) {
+        ei_printf("ERR: AT+%s can't run while a command is executing\n", res.command);
+        return;
+    }
+
+    if (res.type == AT_READ && it->read_handler) {
+        it->read_handler();
+    }
+    else if (res.type == AT_WRITE && it->write_handler) {
+        it->write_handler(const_cast<const char **>(res.arguments), res.argument_count);
+    }
+    else {
+        ei_printf("No handler for command! (AT+%s)\n", res.command);
+    }
 }
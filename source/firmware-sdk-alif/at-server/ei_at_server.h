@@ -3,39 +3,59 @@
 #include "ei_at_history.h"
 #include "ei_at_parser.h"
 #include "ei_line_buffer.h"
-#include <functional>
-#include <string>
-#include <vector>
+#include <cstddef>
 
-typedef std::function<bool(void)> ATRunHandler_t;
-typedef std::function<bool(void)> ATReadHandler_t;
-typedef std::function<bool(const char **, const int)> ATWriteHandler_t;
+typedef bool (*ATRunHandler_t)(void);
+typedef bool (*ATReadHandler_t)(void);
+typedef bool (*ATWriteHandler_t)(const char **, const int);
 
 const size_t default_history_size = 10;
 
+/* Size of the command table, including AT+HELP */
+#ifndef AT_MAX_COMMANDS
+#define AT_MAX_COMMANDS 48
+#endif
+
+/* Longest escape sequence (after the 0x1b) the line editor collects */
+#define AT_MAX_CONTROL_SEQUENCE 8
+
+/* The strings are not copied, they must outlive the server (string literals) */
 typedef struct {
-    std::string command;
-    std::string help_text;
+    const char *command;
+    const char *help_text;
     ATRunHandler_t run_handler;
     ATReadHandler_t read_handler;
     ATWriteHandler_t write_handler;
-    std::string write_handler_args_list;
+    const char *write_handler_args_list;
+    // read/write handlers may run while another command is executing
+    bool async;
 } ATCommand_t;
 
 class ATServer {
 private:
     ATHistory history;
-    std::vector<ATCommand_t> registered_commands;
+    // sorted by command, for binary search
+    ATCommand_t registered_commands[AT_MAX_COMMANDS];
+    size_t command_count;
     LineBuffer buffer;
     ATParser parser;
+    // input that arrives while a command is executing
+    bool executing;
+    bool stop_pending;
+    LineBuffer async_buffer;
+    ATParser async_parser;
     void register_help_command(void);
+    ATCommand_t *find_command(const char *cmd);
+    bool insert_command(const ATCommand_t &command);
+    void handle_async(char c);
+    void execute_async(char *command);
 
 protected:
     ATServer();
     ATServer(ATCommand_t *commands, size_t length, size_t max_history_size = default_history_size);
     ~ATServer();
     bool print_help(void);
-    bool execute(std::string &command);
+    bool execute(char *command);
 
 public:
     ATServer(ATServer &other) = delete;
@@ -61,6 +81,8 @@ public:
         bool (*read_handler)(void),
         bool (*write_handler)(const char **, const int),
         const char *write_handler_args_list);
+    bool set_async(const char *cmd, bool async);
+    bool take_stop_request(void);
     bool register_handlers(
         const char *cmd,
         bool (*run_handler)(void),
@@ -69,4 +91,4 @@ public:
         const char *write_handler_args_list);
 };
 
-#endif /* AT_SERVER_H */
\ No newline at end of file
+#endif /* AT_SERVER_H */
@@ -1,44 +1,61 @@
 #ifndef LINEBUFFER_H
 #define LINEBUFFER_H
 
-#include <string>
+#include <cstddef>
+#include <cstring>
+
+/* Longest command line accepted, excluding the terminator */
+#ifndef AT_LINE_BUFFER_SIZE
+#define AT_LINE_BUFFER_SIZE 256
+#endif
 
 class LineBuffer {
 private:
-    std::string buffer;
+    char buffer[AT_LINE_BUFFER_SIZE + 1];
+    size_t length;
     size_t position;
 
 public:
     LineBuffer()
-        : buffer("")
-        , position(0) {};
+        : length(0)
+        , position(0)
+    {
+        buffer[0] = '\0';
+    }
 
     void clear()
     {
-        buffer.clear();
+        length = 0;
         position = 0;
+        buffer[0] = '\0';
     }
 
-    void add(std::string &s)
+    /**
+     * @brief Insert a string at the cursor, truncated to what fits
+     */
+    void add(const char *s)
     {
-        if (position == buffer.size()) {
-            buffer.append(s);
+        while (*s && add(*s)) {
+            s++;
         }
-        else {
-            buffer.insert(position, s);
-        }
-        position += s.size();
     }
 
-    void add(const char c)
+    /**
+     * @brief Insert a character at the cursor
+     * @return false if the line is full
+     */
+    bool add(const char c)
     {
-        if (position == buffer.size()) {
-            buffer.append(&c, 1);
-        }
-        else {
-            buffer.insert(position, &c, 1);
+        if (length == AT_LINE_BUFFER_SIZE) {
+            return false;
         }
+
+        memmove(&buffer[position + 1], &buffer[position], length - position + 1);
+        buffer[position] = c;
+        length++;
         position++;
+
+        return true;
     }
 
     bool do_backspace(void)
@@ -47,7 +64,8 @@ public:
             return false;
         }
 
-        buffer.erase(position - 1, 1);
+        memmove(&buffer[position - 1], &buffer[position], length - position + 1);
+        length--;
         position--;
 
         return true;
@@ -59,7 +77,8 @@ public:
             return false;
         }
 
-        buffer.erase(position, 1);
+        memmove(&buffer[position], &buffer[position + 1], length - position);
+        length--;
 
         return true;
     }
@@ -71,15 +90,24 @@ public:
 
     bool is_at_end(void)
     {
-        return position == buffer.size();
+        return position == length;
     }
 
     bool is_empty(void)
     {
-        return buffer.size() == 0;
+        return length == 0;
+    }
+
+    bool is_full(void)
+    {
+        return length == AT_LINE_BUFFER_SIZE;
     }
 
-    std::string get_string()
+    /**
+     * @brief The line, always NUL terminated. Stays valid (and writable, for
+     * in place parsing) until the next change to the buffer.
+     */
+    char *get_string()
     {
         return buffer;
     }
@@ -91,8 +119,8 @@ public:
 
     void set_position(int pos)
     {
-        if (pos > (int)buffer.size()) {
-            position = buffer.size();
+        if (pos > (int)length) {
+            position = length;
         }
         else if (pos < 0) {
             position = 0;
@@ -104,8 +132,8 @@ public:
 
     size_t size()
     {
-        return buffer.size();
+        return length;
     }
 };
 
-#endif /* LINEBUFFER_H */
\ No newline at end of file
+#endif /* LINEBUFFER_H */
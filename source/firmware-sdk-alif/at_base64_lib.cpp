@@ -27,121 +27,178 @@
 
 /* Include ----------------------------------------------------------------- */
 #include "at_base64_lib.h"
-#include <cmath>
 
-static const char *base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-                                  "abcdefghijklmnopqrstuvwxyz"
-                                  "0123456789+/";
+// the scalar code below stays as the reference for the MVE version
+#ifndef BASE64_USE_MVE
+#if __ARM_FEATURE_MVE & 1
+#define BASE64_USE_MVE 1
+#else
+#define BASE64_USE_MVE 0
+#endif
+#endif
+
+#if BASE64_USE_MVE
+#include <arm_mve.h>
+#endif
+
+/* Output characters per block write, a multiple of 64 (one vector step) */
+#define BASE64_CHUNK_SIZE 256
+#define BASE64_CHUNK_INPUT (BASE64_CHUNK_SIZE / 4 * 3)
+
+static const char base64_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                   "abcdefghijklmnopqrstuvwxyz"
+                                   "0123456789+/";
 
 /**
- * @brief Base64 encode and write to a putc function
+ * @brief Encode whole 3 byte groups, 48 bytes per step with MVE
  *
  * @param input
- * @param input_size
- * @param output
- * @param output_size
- * @return int number of bytes in output buffer, negative if error occured
+ * @param input_size multiple of 3
+ * @param output room for input_size / 3 * 4 characters
+ * @return size_t number of characters written
  */
-void base64_encode(const char *input, size_t input_size, void (*putc_f)(char))
+static size_t base64_encode_groups(const uint8_t *input, size_t input_size, char *output)
 {
-    int i = 0;
-    int j = 0;
-    unsigned char char_array_3[3];
-    unsigned char char_array_4[4];
-
-    while (input_size--) {
-        char_array_3[i++] = *(input++);
-        if (i == 3) {
-            char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-            char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-            char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-            char_array_4[3] = char_array_3[2] & 0x3f;
-
-            for (i = 0; (i < 4); i++) {
-                putc_f(base64_chars[char_array_4[i]]);
-            }
-            i = 0;
-        }
+    char *out = output;
+
+#if BASE64_USE_MVE
+    const uint8x16_t offsets = vmulq_n_u8(vidupq_n_u8(0, 1), 3);
+    const uint8_t *table = reinterpret_cast<const uint8_t *>(base64_chars);
+
+    while (input_size >= 48) {
+        uint8x16_t b0 = vldrbq_gather_offset_u8(input, offsets);
+        uint8x16_t b1 = vldrbq_gather_offset_u8(input + 1, offsets);
+        uint8x16_t b2 = vldrbq_gather_offset_u8(input + 2, offsets);
+
+        uint8x16x4_t c;
+        c.val[0] = vshrq_n_u8(b0, 2);
+        c.val[1] = vorrq_u8(vshlq_n_u8(vandq_u8(b0, vdupq_n_u8(0x03)), 4), vshrq_n_u8(b1, 4));
+        c.val[2] = vorrq_u8(vshlq_n_u8(vandq_u8(b1, vdupq_n_u8(0x0f)), 2), vshrq_n_u8(b2, 6));
+        c.val[3] = vandq_u8(b2, vdupq_n_u8(0x3f));
+
+        c.val[0] = vldrbq_gather_offset_u8(table, c.val[0]);
+        c.val[1] = vldrbq_gather_offset_u8(table, c.val[1]);
+        c.val[2] = vldrbq_gather_offset_u8(table, c.val[2]);
+        c.val[3] = vldrbq_gather_offset_u8(table, c.val[3]);
+
+        // interleave back to c0 c1 c2 c3 per group
+        vst4q_u8(reinterpret_cast<uint8_t *>(out), c);
+
+        input += 48;
+        input_size -= 48;
+        out += 64;
+    }
+#endif
+
+    while (input_size >= 3) {
+        out[0] = base64_chars[input[0] >> 2];
+        out[1] = base64_chars[((input[0] & 0x03) << 4) | (input[1] >> 4)];
+        out[2] = base64_chars[((input[1] & 0x0f) << 2) | (input[2] >> 6)];
+        out[3] = base64_chars[input[2] & 0x3f];
+        input += 3;
+        input_size -= 3;
+        out += 4;
     }
 
-    if (i) {
-        for (j = i; j < 3; j++) {
-            char_array_3[j] = '\0';
-        }
+    return out - output;
+}
 
-        char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-        char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-        char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-        char_array_4[3] = char_array_3[2] & 0x3f;
+/**
+ * @brief Encode the last 1 or 2 bytes with padding
+ *
+ * @return size_t number of characters written, 0 or 4
+ */
+static size_t base64_encode_tail(const uint8_t *input, size_t input_size, char *output)
+{
+    if (input_size == 0) {
+        return 0;
+    }
 
-        for (j = 0; (j < i + 1); j++) {
-            putc_f(base64_chars[char_array_4[j]]);
-        }
+    uint8_t b1 = input_size > 1 ? input[1] : 0;
 
-        while ((i++ < 3)) {
-            putc_f('=');
-        }
-    }
+    output[0] = base64_chars[input[0] >> 2];
+    output[1] = base64_chars[((input[0] & 0x03) << 4) | (b1 >> 4)];
+    output[2] = input_size > 1 ? base64_chars[(b1 & 0x0f) << 2] : '=';
+    output[3] = '=';
+
+    return 4;
 }
 
 /**
- * @brief Base64 encode and write to output buffer, errors on buffer overflow
+ * @brief Base64 encode in chunks of BASE64_CHUNK_SIZE characters
  *
  * @param input
  * @param input_size
- * @param output
- * @param output_size
- * @return int number of bytes in output buffer, negative if error occured
+ * @param emit called with each encoded chunk
  */
-int base64_encode_buffer(const char *input, size_t input_size, char *output, size_t output_size)
+template <typename F>
+static void base64_encode_chunks(const char *input, size_t input_size, F emit)
 {
-    size_t output_size_check = floor(input_size / 3 * 4);
-    size_t mod = input_size % 3;
-    output_size_check += mod;
+    const uint8_t *in = reinterpret_cast<const uint8_t *>(input);
+    char chunk[BASE64_CHUNK_SIZE] __attribute__((aligned(16)));
 
-    if (output_size < output_size_check) {
-        return -10;
+    while (input_size >= BASE64_CHUNK_INPUT) {
+        emit(chunk, base64_encode_groups(in, BASE64_CHUNK_INPUT, chunk));
+        in += BASE64_CHUNK_INPUT;
+        input_size -= BASE64_CHUNK_INPUT;
     }
 
-    int i = 0;
-    int j = 0;
-    unsigned char char_array_3[3];
-    unsigned char char_array_4[4];
-    size_t output_ix = 0;
-
-    while (input_size--) {
-        char_array_3[i++] = *(input++);
-        if (i == 3) {
-            char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-            char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-            char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-            char_array_4[3] = char_array_3[2] & 0x3f;
-
-            for(i = 0; (i < 4) ; i++) {
-                output[output_ix++] = base64_chars[char_array_4[i]];
-            }
-            i = 0;
-        }
+    size_t groups = input_size - input_size % 3;
+    size_t n = base64_encode_groups(in, groups, chunk);
+    n += base64_encode_tail(in + groups, input_size - groups, chunk + n);
+    if (n) {
+        emit(chunk, n);
     }
+}
 
-    if (i) {
-        for(j = i; j < 3; j++) {
-            char_array_3[j] = '\0';
+/**
+ * @brief Base64 encode and write to a putc function
+ *
+ * @param input
+ * @param input_size
+ * @param putc_f called for every output character
+ */
+void base64_encode(const char *input, size_t input_size, void (*putc_f)(char))
+{
+    base64_encode_chunks(input, input_size, [putc_f](const char *chunk, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            putc_f(chunk[i]);
         }
+    });
+}
 
-        char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-        char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-        char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-        char_array_4[3] = char_array_3[2] & 0x3f;
+/**
+ * @brief Base64 encode and write out in blocks of up to BASE64_CHUNK_SIZE characters
+ *
+ * @param input
+ * @param input_size
+ * @param write_f called with each block of output characters
+ */
+void base64_encode_blocks(const char *input, size_t input_size, void (*write_f)(const char *, size_t))
+{
+    base64_encode_chunks(input, input_size, write_f);
+}
 
-        for (j = 0; (j < i + 1); j++) {
-            output[output_ix++] = base64_chars[char_array_4[j]];
-        }
+/**
+ * @brief Base64 encode and write to output buffer, errors on buffer overflow
+ *
+ * @param input
+ * @param input_size
+ * @param output
+ * @param output_size
+ * @return int number of bytes in output buffer, negative if error occured
+ */
+int base64_encode_buffer(const char *input, size_t input_size, char *output, size_t output_size)
+{
+    const uint8_t *in = reinterpret_cast<const uint8_t *>(input);
 
-        while((i++ < 3)) {
-            output[output_ix++] = '=';
-        }
+    if (output_size < base64_encoded_length(input_size)) {
+        return -10;
     }
 
+    size_t groups = input_size - input_size % 3;
+    size_t output_ix = base64_encode_groups(in, groups, output);
+    output_ix += base64_encode_tail(in + groups, input_size - groups, output + output_ix);
+
     return output_ix;
 }
@@ -29,9 +29,17 @@
 */
 
 #include <cstdlib>
+#include <cstdint>
 
 /* Function prototypes ----------------------------------------------------- */
 void base64_encode(const char *input, size_t input_size, void (*putc_f)(char));
+void base64_encode_blocks(const char *input, size_t input_size, void (*write_f)(const char *, size_t));
 int base64_encode_buffer(const char *input, size_t input_size, char *output, size_t output_size);
 
+/* Number of characters base64 encoding input_size bytes produces, with padding */
+static inline size_t base64_encoded_length(size_t input_size)
+{
+    return (input_size + 2) / 3 * 4;
+}
+
 #endif /* EI_AT_BASE64_LIB_H */
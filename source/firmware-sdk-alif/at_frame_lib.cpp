@@ -0,0 +1,245 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "at_frame_lib.h"
+#include "at_base64_lib.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+#include <cstdio>
+#include <cstring>
+
+/* Gathers headers, payload pieces and trailers into fewer, larger writes. The
+ * port copies each block out (into the UART TX ring) before it returns, so one
+ * block is enough.
+ */
+#define EI_FRAME_STAGING_SIZE 512
+
+static uint8_t staging[EI_FRAME_STAGING_SIZE];
+static size_t staging_fill = 0;
+
+static uint32_t frame_crc;
+static ei_transport_mode_t transport_mode = EI_TRANSPORT_BASE64;
+
+/* State of ei_transport_stream_*: bytes held back so base64 stays in 3 byte groups */
+static ei_frame_type_t stream_type;
+static uint8_t stream_carry[3];
+static size_t stream_carry_len = 0;
+
+/* CRC-32 (reflected, polynomial 0xEDB88320), 4 bits at a time */
+static const uint32_t crc32_nibble[16] = {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+    0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+    0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+};
+
+uint32_t ei_crc32_update(uint32_t crc, const uint8_t *data, size_t length)
+{
+    crc = ~crc;
+    while (length--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ crc32_nibble[crc & 0x0f];
+        crc = (crc >> 4) ^ crc32_nibble[crc & 0x0f];
+    }
+    return ~crc;
+}
+
+static void stdout_write(const char *data, size_t length)
+{
+    fwrite(data, 1, length, stdout);
+}
+
+__attribute__((weak)) void ei_transport_send_async(const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        ei_putchar(data[i]);
+    }
+}
+
+__attribute__((weak)) void ei_transport_wait(void)
+{
+}
+
+static void staging_flush(void)
+{
+    if (staging_fill == 0) {
+        return;
+    }
+
+    ei_transport_send_async(staging, staging_fill);
+    staging_fill = 0;
+}
+
+static void staging_write(const uint8_t *data, size_t length)
+{
+    while (length) {
+        size_t n = EI_FRAME_STAGING_SIZE - staging_fill;
+        if (n > length) {
+            n = length;
+        }
+        memcpy(&staging[staging_fill], data, n);
+        staging_fill += n;
+        data += n;
+        length -= n;
+
+        if (staging_fill == EI_FRAME_STAGING_SIZE) {
+            staging_flush();
+        }
+    }
+}
+
+void ei_frame_begin(ei_frame_type_t type, uint32_t length, uint8_t flags)
+{
+    uint8_t header[EI_FRAME_HEADER_SIZE] = {
+        EI_FRAME_MAGIC_0,
+        EI_FRAME_MAGIC_1,
+        (uint8_t)type,
+        flags,
+        (uint8_t)length,
+        (uint8_t)(length >> 8),
+        (uint8_t)(length >> 16),
+        (uint8_t)(length >> 24),
+    };
+
+    // text printed before the frame must not end up behind it
+    fflush(stdout);
+
+    frame_crc = ei_crc32_update(0, &header[2], EI_FRAME_HEADER_SIZE - 2);
+    staging_write(header, EI_FRAME_HEADER_SIZE);
+}
+
+void ei_frame_write(const uint8_t *data, size_t length)
+{
+    frame_crc = ei_crc32_update(frame_crc, data, length);
+    staging_write(data, length);
+}
+
+void ei_frame_end(void)
+{
+    uint8_t trailer[EI_FRAME_TRAILER_SIZE] = {
+        (uint8_t)frame_crc,
+        (uint8_t)(frame_crc >> 8),
+        (uint8_t)(frame_crc >> 16),
+        (uint8_t)(frame_crc >> 24),
+    };
+
+    staging_write(trailer, EI_FRAME_TRAILER_SIZE);
+    staging_flush();
+}
+
+void ei_frame_send(ei_frame_type_t type, const uint8_t *data, size_t length)
+{
+    ei_frame_begin(type, length);
+    ei_frame_write(data, length);
+    ei_frame_end();
+}
+
+void ei_transport_send(ei_frame_type_t type, const uint8_t *data, size_t length)
+{
+    if (transport_mode == EI_TRANSPORT_BINARY) {
+        ei_frame_send(type, data, length);
+    }
+    else {
+        base64_encode_blocks((const char *)data, length, stdout_write);
+        fflush(stdout);
+    }
+}
+
+void ei_transport_stream_begin(ei_frame_type_t type)
+{
+    stream_type = type;
+    stream_carry_len = 0;
+}
+
+void ei_transport_stream_write(const uint8_t *data, size_t length)
+{
+    if (length == 0) {
+        return;
+    }
+
+    if (transport_mode == EI_TRANSPORT_BINARY) {
+        ei_frame_begin(stream_type, length, EI_FRAME_FLAG_MORE);
+        ei_frame_write(data, length);
+        ei_frame_end();
+        return;
+    }
+
+    // complete the group started by the previous write
+    if (stream_carry_len) {
+        while (stream_carry_len < 3 && length) {
+            stream_carry[stream_carry_len++] = *data++;
+            length--;
+        }
+        if (stream_carry_len < 3) {
+            return;
+        }
+        base64_encode_blocks((const char *)stream_carry, 3, stdout_write);
+        stream_carry_len = 0;
+    }
+
+    size_t whole = length - (length % 3);
+    base64_encode_blocks((const char *)data, whole, stdout_write);
+
+    stream_carry_len = length - whole;
+    memcpy(stream_carry, data + whole, stream_carry_len);
+}
+
+void ei_transport_stream_end(void)
+{
+    if (transport_mode == EI_TRANSPORT_BINARY) {
+        ei_frame_send(stream_type, NULL, 0);
+        return;
+    }
+
+    // the only place padding may appear
+    base64_encode_blocks((const char *)stream_carry, stream_carry_len, stdout_write);
+    stream_carry_len = 0;
+    fflush(stdout);
+}
+
+void ei_transport_set_mode(ei_transport_mode_t mode)
+{
+    ei_transport_wait();
+    transport_mode = mode;
+}
+
+ei_transport_mode_t ei_transport_get_mode(void)
+{
+    return transport_mode;
+}
+
+const char *ei_transport_mode_name(ei_transport_mode_t mode)
+{
+    return mode == EI_TRANSPORT_BINARY ? "BINARY" : "BASE64";
+}
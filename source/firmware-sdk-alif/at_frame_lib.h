@@ -0,0 +1,133 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_AT_FRAME_LIB_H
+#define EI_AT_FRAME_LIB_H
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Binary transport for bulk data (snapshots, sample buffers, debug frames).
+ *
+ * Each block of data is sent as one frame:
+ *
+ *   magic   2 bytes  0xA5 0x5A
+ *   type    1 byte   ei_frame_type_t
+ *   flags   1 byte   EI_FRAME_FLAG_*, other bits reserved as 0
+ *   length  4 bytes  payload length, little endian
+ *   payload length bytes
+ *   crc32   4 bytes  CRC-32 (IEEE 802.3) of type..payload, little endian
+ *
+ * Data of unknown length (e.g. a JPEG being encoded) is streamed as a run of
+ * frames of the same type with EI_FRAME_FLAG_MORE set, closed by a frame
+ * without it (possibly empty). The host concatenates the payloads.
+ *
+ * The host selects the transport with AT+TRANSPORT=BINARY; the default stays
+ * base64 so existing tools keep working.
+ */
+
+#define EI_FRAME_MAGIC_0       0xA5
+#define EI_FRAME_MAGIC_1       0x5A
+#define EI_FRAME_HEADER_SIZE   8
+#define EI_FRAME_TRAILER_SIZE  4
+
+/* payload continues in the next frame */
+#define EI_FRAME_FLAG_MORE     0x01
+
+typedef enum {
+    EI_TRANSPORT_BASE64 = 0,
+    EI_TRANSPORT_BINARY = 1,
+} ei_transport_mode_t;
+
+typedef enum {
+    EI_FRAME_SNAPSHOT_RGB888 = 1,
+    EI_FRAME_SAMPLE_BUFFER = 2,
+    EI_FRAME_JPEG = 3,
+    EI_FRAME_SNAPSHOT_JPEG = 4, // header (see ei_image_lib.cpp) followed by a JPEG
+} ei_frame_type_t;
+
+void ei_transport_set_mode(ei_transport_mode_t mode);
+ei_transport_mode_t ei_transport_get_mode(void);
+const char *ei_transport_mode_name(ei_transport_mode_t mode);
+
+/**
+ * @brief Send bulk data in the selected transport, either as base64 text
+ * through stdout or as a single binary frame.
+ *
+ * @param type frame type, ignored for base64
+ * @param data data to send
+ * @param length number of bytes
+ */
+void ei_transport_send(ei_frame_type_t type, const uint8_t *data, size_t length);
+
+/**
+ * @brief Send a complete binary frame, regardless of the selected transport
+ */
+void ei_frame_send(ei_frame_type_t type, const uint8_t *data, size_t length);
+
+/**
+ * @brief Stream a frame in pieces: begin with the total payload length, write
+ * exactly that many bytes in any number of calls, then end.
+ */
+void ei_frame_begin(ei_frame_type_t type, uint32_t length, uint8_t flags = 0);
+void ei_frame_write(const uint8_t *data, size_t length);
+void ei_frame_end(void);
+
+/**
+ * @brief Stream data of unknown total length in the selected transport.
+ * Base64 output is identical to encoding the concatenated data in one go;
+ * binary output is one EI_FRAME_FLAG_MORE frame per write plus a closing frame.
+ */
+void ei_transport_stream_begin(ei_frame_type_t type);
+void ei_transport_stream_write(const uint8_t *data, size_t length);
+void ei_transport_stream_end(void);
+
+uint32_t ei_crc32_update(uint32_t crc, const uint8_t *data, size_t length);
+
+/* Port hooks -------------------------------------------------------------- */
+
+/**
+ * @brief Queue a block for transmission. The block is reused as soon as this
+ * returns, so the port must have copied it out (the Alif port copies it into
+ * the UART TX ring). The default implementation writes it with ei_putchar.
+ */
+void ei_transport_send_async(const uint8_t *data, size_t length);
+
+/**
+ * @brief Block until everything queued with ei_transport_send_async is out
+ */
+void ei_transport_wait(void);
+
+#endif /* EI_AT_FRAME_LIB_H */
@@ -3,9 +3,14 @@
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 // #include "ei_run_impulse.h"
 #include "at-server/ei_at_command_set.h"
+#include "at_frame_lib.h"
+#include "ei_jpeg_lib.h"
+#include "ei_perf_lib.h"
+#include "ei_threshold_lib.h"
 #include "model-parameters/model_metadata.h"
 #include "../ei_device_alif_e7.h"
 
+#include <cstdlib>
 #include <string>
 
 using namespace std;
@@ -369,4 +374,109 @@ bool at_get_config(void)
     ei_printf("Model type:       %s\r\n", model_type);
 
     return true;
-}
\ No newline at end of file
+}
+bool at_get_transport(void)
+{
+    ei_printf("%s\n", ei_transport_mode_name(ei_transport_get_mode()));
+
+    return true;
+}
+
+bool at_set_transport(const char **argv, const int argc)
+{
+    if(argc < 1) {
+        ei_printf("Missing argument! Required: " AT_TRANSPORT_ARGS "\n");
+        return true;
+    }
+
+    if (strcmp(argv[0], "BINARY") == 0) {
+        ei_transport_set_mode(EI_TRANSPORT_BINARY);
+    }
+    else if (strcmp(argv[0], "BASE64") == 0) {
+        ei_transport_set_mode(EI_TRANSPORT_BASE64);
+    }
+    else {
+        ei_printf("Unknown transport %s, expected BASE64 or BINARY\n", argv[0]);
+        return true;
+    }
+
+    ei_printf("OK\n");
+
+    return true;
+}
+
+bool at_get_jpeg(void)
+{
+    ei_printf("%s,%s\n",
+        ei_jpeg_quality_name(ei_jpeg_get_quality()),
+        ei_jpeg_subsample_name(ei_jpeg_get_subsample()));
+
+    return true;
+}
+
+bool at_set_jpeg(const char **argv, const int argc)
+{
+    if(argc < 2) {
+        ei_printf("Missing argument! Required: " AT_JPEG_ARGS "\n");
+        return true;
+    }
+
+    uint8_t quality = 0;
+    while (ei_jpeg_quality_name(quality) && strcmp(argv[0], ei_jpeg_quality_name(quality)) != 0) {
+        quality++;
+    }
+
+    uint8_t subsample = 0;
+    while (ei_jpeg_subsample_name(subsample) && strcmp(argv[1], ei_jpeg_subsample_name(subsample)) != 0) {
+        subsample++;
+    }
+
+    if (!ei_jpeg_set_settings(quality, subsample)) {
+        ei_printf("Invalid JPEG settings %s,%s, expected BEST|HIGH|MED|LOW,444|420\n", argv[0], argv[1]);
+        return true;
+    }
+
+    ei_printf("OK\n");
+
+    return true;
+}
+
+bool at_get_perf(void)
+{
+    const ei_perf_record_t *record = ei_perf_get_last();
+
+    if (record->sequence == 0) {
+        ei_printf("No inference has run yet\n");
+        return true;
+    }
+
+    ei_perf_print(record);
+
+    return true;
+}
+
+bool at_get_threshold(void)
+{
+    ei_printf("%.3f\n", ei_threshold_get());
+
+    return true;
+}
+
+bool at_set_threshold(const char **argv, const int argc)
+{
+    if(argc < 1) {
+        ei_printf("Missing argument! Required: " AT_THRESHOLD_ARGS "\n");
+        return true;
+    }
+
+    char *end;
+    float threshold = strtof(argv[0], &end);
+    if (end == argv[0] || *end != '\0' || !ei_threshold_set(threshold)) {
+        ei_printf("Invalid threshold %s, expected 0 to 1\n", argv[0]);
+        return true;
+    }
+
+    ei_printf("OK\n");
+
+    return true;
+}
@@ -67,4 +67,18 @@ bool at_get_snapshot(void);
 
 bool at_get_config(void);
 
+bool at_get_transport(void);
+
+bool at_set_transport(const char **argv, const int argc);
+
+bool at_get_jpeg(void);
+
+bool at_set_jpeg(const char **argv, const int argc);
+
+bool at_get_perf(void);
+
+bool at_get_threshold(void);
+
+bool at_set_threshold(const char **argv, const int argc);
+
 #endif  //!__EI_AT_HANDLERS_LIB__H__
\ No newline at end of file
@@ -42,6 +42,17 @@ typedef struct {
     uint16_t height;
 } ei_device_snapshot_resolutions_t;
 
+/**
+ * @brief Per-stage cycle counts of the most recent captured frame
+ */
+typedef struct {
+    uint32_t capture_wait;
+    uint32_t demosaic;
+    uint32_t crop;
+    uint32_t resize;
+    uint32_t color_correction;
+} ei_camera_stage_cycles_t;
+
 class EiCamera {
 public:
     /**
@@ -59,6 +70,66 @@ public:
         uint8_t **image,
         uint32_t image_size) = 0; //pure virtual.  You must provide an implementation
 
+    /**
+     * @brief Start pipelined capture, where the sensor fills the next frame
+     * into a second buffer while the current one is being processed
+     * 
+     * @return true if pipelined capture is supported and started
+     * @return false if not supported (default), use ei_camera_capture_rgb888_packed_big_endian
+     */
+    virtual bool start_pipelined_capture()
+    {
+        return false;
+    }
+
+    /**
+     * @brief Get the next frame from the capture pipeline, same format as
+     * ei_camera_capture_rgb888_packed_big_endian. The returned buffer is owned by
+     * the caller until the next capture call
+     * 
+     * @param image Point to output buffer for image
+     * @param image_size Size of buffer allocated ( should be 3 * width * height ) 
+     * @return true If successful 
+     * @return false If not successful 
+     */
+    virtual bool ei_camera_capture_rgb888_pipelined(
+        uint8_t **image,
+        uint32_t image_size)
+    {
+        return ei_camera_capture_rgb888_packed_big_endian(image, image_size);
+    }
+
+    /**
+     * @brief Stop pipelined capture, waits for any frame in flight
+     */
+    virtual void stop_pipelined_capture()
+    {
+    }
+
+    /**
+     * @brief Get the cycle counts of the capture and image processing
+     * stages for the last frame
+     * 
+     * @param cycles struct to fill
+     * @return true if supported
+     * @return false if not supported (default)
+     */
+    virtual bool get_stage_cycles(ei_camera_stage_cycles_t *cycles)
+    {
+        return false;
+    }
+
+    /**
+     * @brief Power the sensor down while it's not needed, and back up
+     * before capturing again. Only valid after init.
+     * 
+     * @return true if successful, or if not supported (default)
+     */
+    virtual bool set_power(bool on)
+    {
+        return true;
+    }
+
     /**
      * @brief Get the min resolution supported by camera
      * 
@@ -0,0 +1,198 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ei_cascade_lib.h"
+#include "model-parameters/model_metadata.h"
+#include <cstring>
+
+void ei_cascade_msg_init(
+    ei_cascade_msg_t *msg,
+    ei_cascade_msg_type_t type,
+    uint8_t seq,
+    const char *label,
+    float confidence)
+{
+    memset(msg, 0, sizeof(*msg));
+    msg->id = EI_CASCADE_MSG_ID;
+    msg->type = type;
+    msg->seq = seq;
+    msg->confidence = confidence;
+    if (label) {
+        strncpy(msg->label, label, sizeof(msg->label) - 1);
+    }
+}
+
+bool ei_cascade_msg_valid(const ei_cascade_msg_t *msg)
+{
+    if (msg->id != EI_CASCADE_MSG_ID) {
+        return false;
+    }
+    if (msg->type < EI_CASCADE_MSG_WAKE || msg->type > EI_CASCADE_MSG_ERROR) {
+        return false;
+    }
+    if (memchr(msg->label, '\0', sizeof(msg->label)) == nullptr) {
+        return false;
+    }
+    // also rejects NaN
+    return msg->confidence >= 0.0f && msg->confidence <= 1.0f;
+}
+
+void ei_cascade_waker_init(ei_cascade_waker_t *waker, const char *wake_label, float threshold, uint32_t timeout_ms)
+{
+    memset(waker, 0, sizeof(*waker));
+    waker->state = EI_CASCADE_LISTENING;
+    waker->wake_label = wake_label;
+    waker->threshold = threshold;
+    waker->timeout_ms = timeout_ms;
+}
+
+bool ei_cascade_waker_detect(
+    ei_cascade_waker_t *waker,
+    const char *label,
+    float confidence,
+    uint64_t now_ms,
+    ei_cascade_msg_t *msg)
+{
+    bool detected = label != nullptr &&
+        confidence >= waker->threshold &&
+        (waker->wake_label == nullptr || strcmp(label, waker->wake_label) == 0);
+
+    switch (waker->state) {
+    case EI_CASCADE_LISTENING:
+        if (!detected) {
+            return false;
+        }
+        waker->seq++;
+        waker->wakes++;
+        waker->wake_ms = now_ms;
+        waker->state = EI_CASCADE_WAITING;
+        ei_cascade_msg_init(msg, EI_CASCADE_MSG_WAKE, waker->seq, label, confidence);
+        return true;
+
+    case EI_CASCADE_REARMING:
+        // overlapping windows see the same word several times, wake once per word
+        if (!detected) {
+            waker->state = EI_CASCADE_LISTENING;
+        }
+        return false;
+
+    default:
+        return false;
+    }
+}
+
+bool ei_cascade_waker_receive(ei_cascade_waker_t *waker, const ei_cascade_msg_t *msg)
+{
+    if (waker->state != EI_CASCADE_WAITING ||
+        msg->type == EI_CASCADE_MSG_WAKE ||
+        msg->seq != waker->seq) {
+        // stale answer to a wake that already timed out
+        return false;
+    }
+
+    waker->results++;
+    waker->state = EI_CASCADE_REARMING;
+    return true;
+}
+
+bool ei_cascade_waker_poll(ei_cascade_waker_t *waker, uint64_t now_ms)
+{
+    if (waker->state != EI_CASCADE_WAITING || now_ms - waker->wake_ms < waker->timeout_ms) {
+        return false;
+    }
+
+    waker->timeouts++;
+    waker->state = EI_CASCADE_REARMING;
+    return true;
+}
+
+void ei_cascade_worker_init(ei_cascade_worker_t *worker)
+{
+    memset(worker, 0, sizeof(*worker));
+}
+
+bool ei_cascade_worker_receive(ei_cascade_worker_t *worker, const ei_cascade_msg_t *msg)
+{
+    // one run at a time, HE does not wake us again before the result anyway
+    if (worker->running || msg->type != EI_CASCADE_MSG_WAKE) {
+        return false;
+    }
+
+    worker->running = true;
+    worker->seq = msg->seq;
+    return true;
+}
+
+void ei_cascade_worker_done(
+    ei_cascade_worker_t *worker,
+    bool ok,
+    const char *label,
+    float confidence,
+    ei_cascade_msg_t *reply)
+{
+    if (ok) {
+        ei_cascade_msg_init(reply, EI_CASCADE_MSG_RESULT, worker->seq, label, confidence);
+    }
+    else {
+        ei_cascade_msg_init(reply, EI_CASCADE_MSG_ERROR, worker->seq, nullptr, 0.0f);
+    }
+
+    worker->runs++;
+    worker->running = false;
+}
+
+bool ei_cascade_top_result(const ei_impulse_result_t *result, const char **label, float *confidence)
+{
+    *label = nullptr;
+    *confidence = 0.0f;
+
+#if EI_CLASSIFIER_OBJECT_DETECTION == 1
+    for (uint32_t ix = 0; ix < result->bounding_boxes_count; ix++) {
+        const ei_impulse_result_bounding_box_t *bb = &result->bounding_boxes[ix];
+        if (bb->value > *confidence) {
+            *label = bb->label;
+            *confidence = bb->value;
+        }
+    }
+#else
+    for (uint32_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        if (*label == nullptr || result->classification[ix].value > *confidence) {
+            *label = result->classification[ix].label;
+            *confidence = result->classification[ix].value;
+        }
+    }
+#endif
+
+    return *label != nullptr;
+}
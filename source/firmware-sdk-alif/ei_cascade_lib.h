@@ -0,0 +1,193 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_CASCADE_LIB_H
+#define EI_CASCADE_LIB_H
+
+#include <cstdint>
+#include "edge-impulse-sdk/classifier/ei_classifier_types.h"
+
+/*
+ * Dual-core cascade: the always-on RTSS-HE core runs a small audio impulse (or
+ * a voice activity gate) and wakes RTSS-HP over the MHU. HP keeps its camera
+ * off and sleeps until woken, then classifies one frame and sends the top
+ * result back.
+ *
+ * Messages travel in the MHU payload the platform already uses for "go" and
+ * "stop" (a 16 bit id followed by 64 bytes), with an id of their own.
+ */
+
+#define EI_CASCADE_MSG_ID    0xE1CA
+#define EI_CASCADE_LABEL_LEN 32
+
+// defaults for AT+RUNCASCADE
+#ifndef EI_CASCADE_THRESHOLD
+#define EI_CASCADE_THRESHOLD 0.8f       // wake label confidence
+#endif
+#ifndef EI_CASCADE_VAD_THRESHOLD
+#define EI_CASCADE_VAD_THRESHOLD 0.05f  // RMS level, full scale is 1
+#endif
+#ifndef EI_CASCADE_TIMEOUT_MS
+#define EI_CASCADE_TIMEOUT_MS 3000      // power up, capture and classify on HP
+#endif
+
+typedef enum {
+    EI_CASCADE_MSG_WAKE = 1,    // HE -> HP: what woke us
+    EI_CASCADE_MSG_RESULT = 2,  // HP -> HE: top result of the camera impulse
+    EI_CASCADE_MSG_ERROR = 3,   // HP -> HE: the camera impulse failed
+} ei_cascade_msg_type_t;
+
+typedef struct {
+    uint16_t id;                // EI_CASCADE_MSG_ID
+    uint8_t type;               // ei_cascade_msg_type_t
+    uint8_t seq;                // a result carries the seq of its wake
+    float confidence;
+    char label[EI_CASCADE_LABEL_LEN];
+} ei_cascade_msg_t;
+
+/**
+ * @brief Fill in a message, truncating the label if needed
+ */
+void ei_cascade_msg_init(
+    ei_cascade_msg_t *msg,
+    ei_cascade_msg_type_t type,
+    uint8_t seq,
+    const char *label,
+    float confidence);
+
+/**
+ * @brief Check a received message: our id, a known type, a terminated label
+ * and a confidence between 0 and 1
+ */
+bool ei_cascade_msg_valid(const ei_cascade_msg_t *msg);
+
+/* HE side: decides when to wake HP, and matches the answers to the wakes */
+
+typedef enum {
+    EI_CASCADE_LISTENING,       // next detection over the threshold wakes HP
+    EI_CASCADE_WAITING,         // HP is running, detections are ignored
+    EI_CASCADE_REARMING,        // waiting for the detection to drop below the threshold
+} ei_cascade_waker_state_t;
+
+typedef struct {
+    ei_cascade_waker_state_t state;
+    const char *wake_label;     // nullptr wakes on any label
+    float threshold;
+    uint32_t timeout_ms;        // give up on HP after this long
+    uint8_t seq;
+    uint64_t wake_ms;
+    uint32_t wakes;
+    uint32_t results;
+    uint32_t timeouts;
+} ei_cascade_waker_t;
+
+void ei_cascade_waker_init(ei_cascade_waker_t *waker, const char *wake_label, float threshold, uint32_t timeout_ms);
+
+/**
+ * @brief Feed the latest detection
+ * @return true if HP should be woken, msg then holds the wake to send
+ */
+bool ei_cascade_waker_detect(
+    ei_cascade_waker_t *waker,
+    const char *label,
+    float confidence,
+    uint64_t now_ms,
+    ei_cascade_msg_t *msg);
+
+/**
+ * @brief Feed a message from HP
+ * @return true if it answers the outstanding wake
+ */
+bool ei_cascade_waker_receive(ei_cascade_waker_t *waker, const ei_cascade_msg_t *msg);
+
+/**
+ * @brief Give up on a wake HP has not answered in time
+ * @return true if the wake timed out
+ */
+bool ei_cascade_waker_poll(ei_cascade_waker_t *waker, uint64_t now_ms);
+
+/* HP side: runs the camera impulse once per wake */
+
+typedef struct {
+    bool running;
+    uint8_t seq;                // of the wake being served
+    uint32_t runs;
+} ei_cascade_worker_t;
+
+void ei_cascade_worker_init(ei_cascade_worker_t *worker);
+
+/**
+ * @brief Feed a message from HE
+ * @return true if the camera impulse should run now
+ */
+bool ei_cascade_worker_receive(ei_cascade_worker_t *worker, const ei_cascade_msg_t *msg);
+
+/**
+ * @brief Finish the current run
+ * @param ok false if the impulse failed, the reply is then an error
+ * @param reply the result to send back to HE
+ */
+void ei_cascade_worker_done(
+    ei_cascade_worker_t *worker,
+    bool ok,
+    const char *label,
+    float confidence,
+    ei_cascade_msg_t *reply);
+
+/**
+ * @brief Highest scoring label of a result, classification or object detection
+ * @return false if there is none (eg. no objects found)
+ */
+bool ei_cascade_top_result(const ei_impulse_result_t *result, const char **label, float *confidence);
+
+/*
+ * Transport to the other core, one implementation per platform: the MHU on the
+ * board, a pair of FIFOs on the native build.
+ */
+bool ei_cascade_transport_init(void);
+void ei_cascade_transport_deinit(void);
+bool ei_cascade_transport_send(const ei_cascade_msg_t *msg);
+
+/**
+ * @brief Take the next received message, without blocking
+ * @return false if there is none
+ */
+bool ei_cascade_transport_receive(ei_cascade_msg_t *msg);
+
+/**
+ * @brief Sleep until a message may have arrived, or timeout_ms at the most
+ */
+void ei_cascade_transport_wait(uint32_t timeout_ms);
+
+#endif /* EI_CASCADE_LIB_H */
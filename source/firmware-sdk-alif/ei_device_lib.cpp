@@ -37,21 +37,34 @@
 #include "ei_device_info_lib.h"
 #include "ei_device_memory.h"
 #include "ei_device_interface.h"
+#include "firmware-sdk-alif/at-server/ei_at_server.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 
+/**
+ * @brief      The board's UART never closes, see ei_device_lib.h
+ */
+__attribute__((weak)) bool ei_user_input_closed(void)
+{
+    return false;
+}
+
 /**
  * @brief      Call this function periocally during inference to 
- *             detect a user stop command
+ *             detect a user stop command. Also hands any other input to
+ *             the AT server, which runs async commands (eg. parameter
+ *             changes) from here.
  *
  * @return     true if user requested stop
  */
 extern bool ei_user_invoke_stop_lib(void)
 {
+    ATServer *at = ATServer::get_instance();
     char ch;
-    // while(1) { 
-        ch = ei_getchar();
-        // if(ch == 0) { return false; }
-        if(ch == 'b') { return true; }
-        else { return false; }
-    // }
+
+    while ((ch = ei_getchar()) != 0) {
+        at->handle(ch);
+    }
+
+    // no 'b' can come after the end of the input
+    return at->take_stop_request() || ei_user_input_closed();
 }
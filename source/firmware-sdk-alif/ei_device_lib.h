@@ -45,6 +45,13 @@
  */
 bool ei_user_invoke_stop_lib(void);
 
+/**
+ * @brief      Whether the console input has ended for good (the native
+ *             build at the end of stdin), which stops a running command
+ *             like a 'b' would. Weak, the default never ends.
+ */
+bool ei_user_input_closed(void);
+
 /**
  * @brief Helper function for sending a data from memory over the
  * serial port. Data are encoded into base64 on the fly.
@@ -50,8 +50,25 @@
 #include "edge-impulse-sdk/dsp/image/image.hpp"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "firmware-sdk-alif/at_base64_lib.h"
+#include "firmware-sdk-alif/at_frame_lib.h"
 #include "firmware-sdk-alif/ei_device_interface.h"
 #include "firmware-sdk-alif/ei_image_lib.h"
+#include "firmware-sdk-alif/ei_jpeg_lib.h"
+
+#include <cstring>
+
+// JPEG snapshots are encoded here whole, then sent with their header
+#ifndef EI_SNAPSHOT_JPEG_BUF_SIZE
+#define EI_SNAPSHOT_JPEG_BUF_SIZE (32 * 1024)
+#endif
+#define EI_SNAPSHOT_JPEG_HEADER_SIZE 20
+
+static uint8_t snapshot_jpeg_buf[EI_SNAPSHOT_JPEG_BUF_SIZE] __attribute__((aligned(32)));
+static size_t snapshot_jpeg_len;
+static bool snapshot_jpeg_overflow;
+
+// counts every frame captured in JPEG mode, so the host can spot drops
+static uint32_t snapshot_sequence;
 
 // *********************************** AT cmd functions ***************
 
@@ -76,7 +93,79 @@ static void change_to_normal_baud()
     ei_sleep(100);
 }
 
-static bool ei_camera_take_snapshot_encode_and_output_no_init(size_t width, size_t height)
+static void snapshot_jpeg_write(const uint8_t *data, size_t length)
+{
+    if (snapshot_jpeg_len + length > EI_SNAPSHOT_JPEG_BUF_SIZE) {
+        snapshot_jpeg_overflow = true;
+        return;
+    }
+    memcpy(&snapshot_jpeg_buf[snapshot_jpeg_len], data, length);
+    snapshot_jpeg_len += length;
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief Encode a snapshot as JPEG and send it with a header, as a single
+ * EI_FRAME_SNAPSHOT_JPEG frame (or one base64 string):
+ *
+ *   sequence    4 bytes  frame counter, gaps mean dropped frames
+ *   capture_us  8 bytes  timer value when the frame was captured
+ *   encode_us   4 bytes  JPEG encode time
+ *   length      4 bytes  JPEG size that follows the header
+ *
+ * All fields little endian.
+ */
+static bool snapshot_send_jpeg(const uint8_t *image, size_t width, size_t height, uint64_t capture_us)
+{
+    uint32_t sequence = snapshot_sequence++;
+    ei_jpeg_stats_t stats;
+
+    snapshot_jpeg_len = 0;
+    snapshot_jpeg_overflow = false;
+
+    int rc = ei_jpeg_encode_rgb888(image, width, height, snapshot_jpeg_write, &stats);
+    if (rc != 0) {
+        ei_printf("ERR: Failed to encode snapshot as JPEG (%d)\n", rc);
+        return false;
+    }
+    if (snapshot_jpeg_overflow) {
+        ei_printf("ERR: JPEG snapshot larger than %u bytes, lower the quality with AT+" AT_JPEG "\n",
+            (unsigned int)EI_SNAPSHOT_JPEG_BUF_SIZE);
+        return false;
+    }
+
+    uint8_t header[EI_SNAPSHOT_JPEG_HEADER_SIZE];
+    put_le32(&header[0], sequence);
+    put_le32(&header[4], (uint32_t)capture_us);
+    put_le32(&header[8], (uint32_t)(capture_us >> 32));
+    put_le32(&header[12], stats.encode_us);
+    put_le32(&header[16], snapshot_jpeg_len);
+
+    // the total is known by now, so binary is one frame rather than a stream
+    if (ei_transport_get_mode() == EI_TRANSPORT_BINARY) {
+        ei_frame_begin(EI_FRAME_SNAPSHOT_JPEG, sizeof(header) + snapshot_jpeg_len);
+        ei_frame_write(header, sizeof(header));
+        ei_frame_write(snapshot_jpeg_buf, snapshot_jpeg_len);
+        ei_frame_end();
+    }
+    else {
+        ei_transport_stream_begin(EI_FRAME_SNAPSHOT_JPEG);
+        ei_transport_stream_write(header, sizeof(header));
+        ei_transport_stream_write(snapshot_jpeg_buf, snapshot_jpeg_len);
+        ei_transport_stream_end();
+    }
+
+    return true;
+}
+
+static bool ei_camera_take_snapshot_encode_and_output_no_init(size_t width, size_t height, bool jpeg)
 {
     using namespace ei::image::processing;
 
@@ -128,6 +217,7 @@ static bool ei_camera_take_snapshot_encode_and_output_no_init(size_t width, size
         counter += 100;
     }
     (void)needs_a_resize; //suppress warning
+    uint64_t capture_us = ei_read_timer_us();
 #else
 
     camera->set_resolution(fb_resolution);
@@ -136,6 +226,7 @@ static bool ei_camera_take_snapshot_encode_and_output_no_init(size_t width, size
     if (!isOK) {
         return false;
     }
+    uint64_t capture_us = ei_read_timer_us();
 
     if (needs_a_resize) {
         // interpolate in place
@@ -150,17 +241,20 @@ static bool ei_camera_take_snapshot_encode_and_output_no_init(size_t width, size
 
 #endif
 
+    if (jpeg) {
+        return snapshot_send_jpeg(image, final_width, final_height, capture_us);
+    }
+
     // recalculate size b/c now we want to send just the interpolated bytes
-    base64_encode(
-        reinterpret_cast<char *>(image),
-        final_height * final_width * RGB888_B_SIZE,
-        ei_putchar);
+    ei_transport_send(
+        EI_FRAME_SNAPSHOT_RGB888,
+        image,
+        final_height * final_width * RGB888_B_SIZE);
 
     return true;
 }
 
-extern bool
-ei_camera_take_snapshot_output_on_serial(size_t width, size_t height, bool use_max_baudrate)
+static bool take_snapshot_output_on_serial(size_t width, size_t height, bool use_max_baudrate, bool jpeg)
 {
     auto camera = EiCamera::get_camera();
 
@@ -180,7 +274,8 @@ ei_camera_take_snapshot_output_on_serial(size_t width, size_t height, bool use_m
     // here we pass desired snapshot resolution 
     // if it is different from camera sensor resolution
     // we will resize before sending out the image
-    bool isOK = ei_camera_take_snapshot_encode_and_output_no_init(width, height);
+    snapshot_sequence = 0;
+    bool isOK = ei_camera_take_snapshot_encode_and_output_no_init(width, height, jpeg);
     camera->deinit();
 
     if (use_max_baudrate) {
@@ -193,7 +288,7 @@ ei_camera_take_snapshot_output_on_serial(size_t width, size_t height, bool use_m
     return isOK;
 }
 
-extern bool ei_camera_start_snapshot_stream(size_t width, size_t height, bool use_max_baudrate)
+static bool start_snapshot_stream(size_t width, size_t height, bool use_max_baudrate, bool jpeg)
 {
     bool isOK = true;
     ei_printf("Starting snapshot stream...\n");
@@ -208,8 +303,9 @@ extern bool ei_camera_start_snapshot_stream(size_t width, size_t height, bool us
         respond_and_change_to_max_baud();
     }
 
+    snapshot_sequence = 0;
     while (!ei_user_invoke_stop_lib()) {
-        isOK &= ei_camera_take_snapshot_encode_and_output_no_init(width, height);
+        isOK &= ei_camera_take_snapshot_encode_and_output_no_init(width, height, jpeg);
         ei_printf("\r\n");
     }
     camera->deinit();
@@ -222,10 +318,40 @@ extern bool ei_camera_start_snapshot_stream(size_t width, size_t height, bool us
     return isOK;
 }
 
+extern bool
+ei_camera_take_snapshot_output_on_serial(size_t width, size_t height, bool use_max_baudrate)
+{
+    return take_snapshot_output_on_serial(width, height, use_max_baudrate, false);
+}
+
+extern bool ei_camera_start_snapshot_stream(size_t width, size_t height, bool use_max_baudrate)
+{
+    return start_snapshot_stream(width, height, use_max_baudrate, false);
+}
+
+/**
+ * @brief Optional 4th argument of AT+SNAPSHOT / AT+SNAPSHOTSTREAM: RGB (default) or JPEG
+ */
+static bool parse_snapshot_format(const int argc, const char **argv, bool *jpeg)
+{
+    if (argc < 4 || strcmp(argv[3], "RGB") == 0) {
+        *jpeg = false;
+    }
+    else if (strcmp(argv[3], "JPEG") == 0) {
+        *jpeg = true;
+    }
+    else {
+        ei_printf("Unknown format %s, expected RGB or JPEG\n", argv[3]);
+        return false;
+    }
+    return true;
+}
+
 bool at_take_snapshot(const char **argv, const int argc)
 {
     uint32_t width, height;
     bool use_max_baudrate = false;
+    bool jpeg = false;
 
     if(argc < 2) {
         ei_printf("Width and height arguments missing!\n");
@@ -238,7 +364,11 @@ bool at_take_snapshot(const char **argv, const int argc)
         use_max_baudrate = true;
     }
 
-    if (!ei_camera_take_snapshot_output_on_serial(width, height, use_max_baudrate)) {
+    if (!parse_snapshot_format(argc, argv, &jpeg)) {
+        return true;
+    }
+
+    if (!take_snapshot_output_on_serial(width, height, use_max_baudrate, jpeg)) {
         ei_printf("ERR: Snapshot failed\n");
         return true;
     }
@@ -250,6 +380,7 @@ bool at_snapshot_stream(const char **argv, const int argc)
 {
     uint32_t width, height;
     bool use_max_baudrate = false;
+    bool jpeg = false;
 
     width = atoi(argv[0]);
     height = atoi(argv[1]);
@@ -258,7 +389,11 @@ bool at_snapshot_stream(const char **argv, const int argc)
         use_max_baudrate = true;
     }
 
-    if(!ei_camera_start_snapshot_stream(width, height, use_max_baudrate)) {
+    if (!parse_snapshot_format(argc, argv, &jpeg)) {
+        return true;
+    }
+
+    if(!start_snapshot_stream(width, height, use_max_baudrate, jpeg)) {
         return true;
     }
 
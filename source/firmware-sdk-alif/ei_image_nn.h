@@ -39,9 +39,30 @@
 #include "firmware-sdk-alif/ei_device_interface.h"
 #include "edge-impulse-sdk/classifier/ei_run_classifier.h"
 #include "firmware-sdk-alif/at_base64_lib.h"
-#include "firmware-sdk-alif/jpeg/encode_as_jpg.h"
+#include "firmware-sdk-alif/at_frame_lib.h"
+#include "firmware-sdk-alif/ei_jpeg_lib.h"
+#include "firmware-sdk-alif/ei_perf_lib.h"
+#include "firmware-sdk-alif/ei_threshold_lib.h"
+#include "firmware-sdk-alif/jpeg/JPEGENC.h"
 #include "firmware-sdk-alif/ei_device_info_lib.h"
 
+#if __ARM_FEATURE_MVE & 1
+#include <arm_mve.h>
+#endif
+
+/* A single RGB image block feeding a quantized EON graph lets the camera frame
+ * be quantized straight into the model's input tensor, skipping the packed
+ * float signal and the image DSP block.
+ */
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && \
+    (EI_CLASSIFIER_COMPILED == 1) && \
+    (EI_CLASSIFIER_TFLITE_INPUT_DATATYPE == EI_CLASSIFIER_DATATYPE_INT8) && \
+    (EI_CLASSIFIER_HAS_ANOMALY == EI_ANOMALY_TYPE_UNKNOWN)
+#define EI_IMAGE_NN_DIRECT_INPUT 1
+#else
+#define EI_IMAGE_NN_DIRECT_INPUT 0
+#endif
+
 static void respond_and_change_to_max_baud()
 {
     auto device = EiDeviceInfo::get_device();
@@ -82,15 +103,34 @@ public:
     }
 
     void run_nn(bool debug, int delay_ms, bool use_max_baudrate);
+    bool run_once(ei_impulse_result_t *result);
     int cutout_get_data(uint32_t offset, uint32_t length, float *out_ptr);
 
 private:
+    void print_pipeline_timing(EiCamera *camera, uint64_t frame_time_us);
+#if EI_IMAGE_NN_DIRECT_INPUT
+    bool can_run_direct();
+    void quantize_to_tensor(int8_t *out, float scale, int zero_point);
+    bool open_session();
+    void close_session();
+    EI_IMPULSE_ERROR run_session(ei_impulse_result_t *result, bool debug);
+#endif
+
     uint8_t *image;
     uint32_t image_size;
     uint32_t image_width;
     uint32_t image_height;
     uint32_t dsp_input_frame_size;
     int classifier_label_count;
+
+#if EI_IMAGE_NN_DIRECT_INPUT
+    // persistent EON session, see open_session()
+    const ei_config_tflite_eon_graph_t *graph_config = nullptr;
+    TfLiteTensor input;
+    TfLiteTensor output;
+    bool session_open = false;
+    uint64_t session_init_us = 0;
+#endif
 };
 
 int EiImageNN::cutout_get_data(uint32_t offset, uint32_t length, float *out_ptr)
@@ -119,6 +159,211 @@ int EiImageNN::cutout_get_data(uint32_t offset, uint32_t length, float *out_ptr)
     return 0;
 }
 
+void EiImageNN::print_pipeline_timing(EiCamera *camera, uint64_t frame_time_us)
+{
+    ei_camera_stage_cycles_t cycles;
+
+#if EI_IMAGE_NN_DIRECT_INPUT
+    if (session_open) {
+        // run_classifier would pay for this on every frame
+        ei_printf("Model session: saved %u us per frame (init and prepare)\n",
+            (unsigned int)session_init_us);
+    }
+#endif
+
+    if (!camera->get_stage_cycles(&cycles)) {
+        return;
+    }
+
+    ei_printf("Capture stages (cycles): wait %u, demosaic %u, crop %u, resize %u, color %u\n",
+        (unsigned int)cycles.capture_wait,
+        (unsigned int)cycles.demosaic,
+        (unsigned int)cycles.crop,
+        (unsigned int)cycles.resize,
+        (unsigned int)cycles.color_correction);
+
+    if (frame_time_us != 0) {
+        ei_printf("Frame time: %u us (%.2f fps)\n",
+            (unsigned int)frame_time_us,
+            1000000.0f / frame_time_us);
+    }
+}
+
+#if EI_IMAGE_NN_DIRECT_INPUT
+/**
+ * @brief Check the impulse is a single RGB image block straight into one
+ * unscaled quantized graph, so the tensor can be filled from the frame
+ */
+bool EiImageNN::can_run_direct()
+{
+    const ei_impulse_t *impulse = ei_default_impulse.impulse;
+
+    if (impulse->dsp_blocks_size != 1 || impulse->learning_blocks_size != 1) {
+        return false;
+    }
+
+    const ei_model_dsp_t *dsp = &impulse->dsp_blocks[0];
+    if (dsp->extract_fn != &extract_image_features ||
+        strcmp(((ei_dsp_config_image_t *)dsp->config)->channels, "RGB") != 0) {
+        return false;
+    }
+
+    const ei_learning_block_t *block = &impulse->learning_blocks[0];
+    if (block->infer_fn != &run_nn_inference ||
+        block->image_scaling != EI_CLASSIFIER_IMAGE_SCALING_NONE) {
+        return false;
+    }
+
+    const ei_learning_block_config_tflite_graph_t *config =
+        (const ei_learning_block_config_tflite_graph_t *)block->config;
+    if (!config->quantized || !config->compiled ||
+        config->object_detection_last_layer == EI_CLASSIFIER_LAST_LAYER_SSD) {
+        return false;
+    }
+
+    return dsp->n_output_features == image_width * image_height * 3;
+}
+
+/**
+ * @brief Quantize the RGB888 frame into the int8 input tensor, as the image
+ * DSP block would: each channel is normalized to 0..1 then quantized.
+ */
+void EiImageNN::quantize_to_tensor(int8_t *out, float scale, int zero_point)
+{
+    const uint32_t length = image_width * image_height * 3;
+
+    // the usual 1/255 scale and -128 zero point is just a sign flip. Within
+    // 1e-6 of 1/255 every v / 255 / scale still rounds to v, so exports that
+    // store the scale with slightly different rounding take this path too.
+    if (fabsf(scale - 1.0f / 255.0f) < 1e-6f && zero_point == -128) {
+        uint32_t ix = 0;
+#if __ARM_FEATURE_MVE & 1
+        for (; ix + 16 <= length; ix += 16) {
+            uint8x16_t v = vldrbq_u8(&image[ix]);
+            vstrbq_u8((uint8_t *)&out[ix], veorq(v, vdupq_n_u8(0x80)));
+        }
+#endif
+        for (; ix < length; ix++) {
+            out[ix] = (int8_t)(image[ix] ^ 0x80);
+        }
+        return;
+    }
+
+    int8_t lut[256];
+    for (int v = 0; v < 256; v++) {
+        int32_t q = (int32_t)roundf((v / 255.0f) / scale) + zero_point;
+        lut[v] = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+    }
+
+    for (uint32_t ix = 0; ix < length; ix++) {
+        out[ix] = lut[image[ix]];
+    }
+}
+
+/**
+ * @brief Initialise the quantized graph once for a whole run, so frames only
+ * pay for invoke rather than the init, prepare and reset run_classifier does
+ */
+bool EiImageNN::open_session()
+{
+    const ei_impulse_t *impulse = ei_default_impulse.impulse;
+    const ei_learning_block_config_tflite_graph_t *block_config =
+        (const ei_learning_block_config_tflite_graph_t *)impulse->learning_blocks[0].config;
+    graph_config = (const ei_config_tflite_eon_graph_t *)block_config->graph_config;
+
+    uint64_t init_start_us = ei_read_timer_us();
+
+    if (graph_config->model_init(ei_aligned_calloc) != kTfLiteOk) {
+        ei_printf("ERR: Failed to allocate TFLite arena\n");
+        return false;
+    }
+
+    if (graph_config->model_input(0, &input) != kTfLiteOk ||
+        input.type != kTfLiteInt8 ||
+        input.bytes != image_width * image_height * 3 ||
+        graph_config->model_output(block_config->output_data_tensor, &output) != kTfLiteOk) {
+        ei_printf("ERR: Unexpected input or output tensor\n");
+        graph_config->model_reset(ei_aligned_free);
+        return false;
+    }
+
+    session_init_us = ei_read_timer_us() - init_start_us;
+    session_open = true;
+    return true;
+}
+
+void EiImageNN::close_session()
+{
+    if (session_open) {
+        graph_config->model_reset(ei_aligned_free);
+        session_open = false;
+    }
+}
+
+/**
+ * @brief Run the open session on the current frame without going through
+ * signal_t, the same way run_nn_inference does for an EON model
+ */
+EI_IMPULSE_ERROR EiImageNN::run_session(ei_impulse_result_t *result, bool debug)
+{
+    const ei_impulse_t *impulse = ei_default_impulse.impulse;
+    const ei_learning_block_config_tflite_graph_t *block_config =
+        (const ei_learning_block_config_tflite_graph_t *)impulse->learning_blocks[0].config;
+
+    uint64_t dsp_start_us = ei_read_timer_us();
+
+    quantize_to_tensor(input.data.int8, input.params.scale, input.params.zero_point);
+
+    result->timing.dsp_us = ei_read_timer_us() - dsp_start_us;
+    result->timing.dsp = (int)(result->timing.dsp_us / 1000);
+
+    uint64_t ctx_start_us = ei_read_timer_us();
+
+    if (graph_config->model_invoke() != kTfLiteOk) {
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+
+    result->timing.classification_us = ei_read_timer_us() - ctx_start_us;
+    result->timing.classification = (int)(result->timing.classification_us / 1000);
+
+    return fill_result_struct_from_output_tensor_tflite(
+        impulse, block_config, &output, nullptr, nullptr, result, debug);
+}
+#endif
+
+/**
+ * @brief Capture and classify a single frame, for callers that only need a
+ * result now and then. The camera must be initialised and powered.
+ */
+bool EiImageNN::run_once(ei_impulse_result_t *result)
+{
+    auto camera = EiCamera::get_camera();
+
+    if (!camera->ei_camera_capture_rgb888_packed_big_endian(&image, image_size)) {
+        ei_printf("Failed to capture image\r\n");
+        return false;
+    }
+
+    ei::signal_t signal;
+    signal.total_length = image_height * image_width;
+    signal.get_data = [this](size_t offset, size_t length, float *out_ptr) {
+        return this->cutout_get_data(offset, length, out_ptr);
+    };
+
+    ei_perf_begin();
+    EI_IMPULSE_ERROR ei_error = run_classifier(&signal, result, false);
+    ei_camera_stage_cycles_t capture_cycles;
+    ei_perf_end(result, camera->get_stage_cycles(&capture_cycles) ? &capture_cycles : nullptr);
+    if (ei_error != EI_IMPULSE_OK) {
+        ei_printf("Failed to run impulse (%d)\n", ei_error);
+        return false;
+    }
+
+    ei_threshold_apply(result);
+
+    return true;
+}
+
 void EiImageNN::run_nn(bool debug, int delay_ms, bool use_max_baudrate)
 {
     // summary of inferencing settings (from model_metadata.h)
@@ -137,6 +382,22 @@ void EiImageNN::run_nn(bool debug, int delay_ms, bool use_max_baudrate)
         respond_and_change_to_max_baud();
     }
 
+    // With no delay between frames, let the sensor capture the next frame
+    // while this one goes through DSP and inference. With a delay the
+    // prefetched frame would be stale, so capture on demand instead.
+    bool pipelined = (delay_ms == 0) && camera->start_pipelined_capture();
+    uint64_t last_frame_us = 0;
+
+#if EI_IMAGE_NN_DIRECT_INPUT
+    // keep the graph initialised for the whole run, only invoking it per frame
+    bool direct = can_run_direct() && open_session();
+#else
+    bool direct = false;
+#endif
+    if (debug) {
+        ei_printf("\tInput: %s\n", direct ? "direct to tensor" : "signal");
+    }
+
     while (!ei_user_invoke_stop_lib()) {
     // while (1) {
         ei::signal_t signal;
@@ -147,9 +408,10 @@ void EiImageNN::run_nn(bool debug, int delay_ms, bool use_max_baudrate)
 
         ei_printf("Taking photo...\n");
 
-        if (!camera->ei_camera_capture_rgb888_packed_big_endian(
-                &image,
-                image_size)) {
+        bool captured = pipelined ?
+            camera->ei_camera_capture_rgb888_pipelined(&image, image_size) :
+            camera->ei_camera_capture_rgb888_packed_big_endian(&image, image_size);
+        if (!captured) {
             ei_printf("Failed to capture image\r\n");
             break;
         }
@@ -157,45 +419,59 @@ void EiImageNN::run_nn(bool debug, int delay_ms, bool use_max_baudrate)
         // run the impulse: DSP, neural network and the Anomaly algorithm
         ei_impulse_result_t result = { 0 };
 
-        EI_IMPULSE_ERROR ei_error = run_classifier(&signal, &result, false);
+        EI_IMPULSE_ERROR ei_error;
+        ei_perf_begin();
+#if EI_IMAGE_NN_DIRECT_INPUT
+        if (direct) {
+            ei_error = run_session(&result, false);
+        }
+        else
+#endif
+        {
+            ei_error = run_classifier(&signal, &result, false);
+        }
+        ei_camera_stage_cycles_t capture_cycles;
+        ei_perf_end(&result, camera->get_stage_cycles(&capture_cycles) ? &capture_cycles : nullptr);
         if (ei_error != EI_IMPULSE_OK) {
             ei_printf("Failed to run impulse (%d)\n", ei_error);
             break;
         }
 
+        // read each frame, AT+THRESHOLD may have changed it since the last one
+        ei_threshold_apply(&result);
+
 
         // Print framebuffer as JPG during debugging
         if(debug) {
             ei_printf("Begin output\n");
 
-            size_t jpeg_buffer_size = EI_CLASSIFIER_INPUT_WIDTH * EI_CLASSIFIER_INPUT_HEIGHT >= 128 * 128 ?
-                8192 * 3 :
-                4096 * 4;
-            uint8_t *jpeg_buffer = NULL;
-            jpeg_buffer = (uint8_t*)ei_malloc(jpeg_buffer_size);
-            if (!jpeg_buffer) {
-                ei_printf("ERR: Failed to allocate JPG buffer\r\n");
-                return;
-            }
-
-            size_t out_size;
-            int x = encode_rgb888_signal_as_jpg(&signal, EI_CLASSIFIER_INPUT_WIDTH, EI_CLASSIFIER_INPUT_HEIGHT, jpeg_buffer, jpeg_buffer_size, &out_size);
+            // stream straight from the frame buffer, one JPEG chunk at a time
+            ei_jpeg_stats_t jpeg_stats;
+            ei_printf("Framebuffer: ");
+            ei_transport_stream_begin(EI_FRAME_JPEG);
+            int x = ei_jpeg_encode_rgb888(image, image_width, image_height, ei_transport_stream_write, &jpeg_stats);
+            ei_transport_stream_end();
+            ei_printf("\r\n");
             if (x != 0) {
                 ei_printf("Failed to encode frame as JPEG (%d)\n", x);
                 break;
             }
 
-            ei_printf("Framebuffer: ");
-            base64_encode((char*)jpeg_buffer, out_size, ei_putchar);
-            ei_printf("\r\n");
+            uint32_t mcu_size = ei_jpeg_get_subsample() == JPEG_SUBSAMPLE_420 ? 16 : 8;
+            uint32_t jpeg_mcus = ((image_width + mcu_size - 1) / mcu_size) * ((image_height + mcu_size - 1) / mcu_size);
 
-            if (jpeg_buffer) {
-                ei_free(jpeg_buffer);
-            }
+            ei_printf("JPEG encode: %u us (%u ns per MCU, %u bytes)\n",
+                (unsigned int)jpeg_stats.encode_us,
+                (unsigned int)((uint64_t)jpeg_stats.encode_us * 1000 / jpeg_mcus),
+                (unsigned int)jpeg_stats.size);
         }
 
         display_results(&result);
 
+        uint64_t now_us = ei_read_timer_us();
+        print_pipeline_timing(camera, last_frame_us ? now_us - last_frame_us : 0);
+        last_frame_us = now_us;
+
         if (debug) {
             ei_printf("End output\n");
         }
@@ -216,6 +492,14 @@ void EiImageNN::run_nn(bool debug, int delay_ms, bool use_max_baudrate)
     }
 CLOSE_AND_EXIT:
 
+#if EI_IMAGE_NN_DIRECT_INPUT
+    close_session();
+#endif
+
+    if (pipelined) {
+        camera->stop_pipelined_capture();
+    }
+
     if (use_max_baudrate) {
         change_to_normal_baud();
     }
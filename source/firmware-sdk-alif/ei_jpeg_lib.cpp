@@ -0,0 +1,163 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "firmware-sdk-alif/ei_jpeg_lib.h"
+#include "firmware-sdk-alif/jpeg/JPEGENC.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+/* Largest MCU is 16x16 (4:2:0) */
+#define EI_JPEG_MCU_MAX 16
+
+static JPEGClass jpg;
+static uint8_t mcu_bgr[EI_JPEG_MCU_MAX * EI_JPEG_MCU_MAX * 3] __attribute__((aligned(16)));
+
+static uint8_t jpeg_quality = JPEG_Q_BEST;
+static uint8_t jpeg_subsample = JPEG_SUBSAMPLE_444;
+
+static const char *quality_names[] = { "BEST", "HIGH", "MED", "LOW" };
+static const char *subsample_names[] = { "444", "420" };
+
+/* Output of the current encode, the library only hands back a file handle */
+static ei_jpeg_write_t stream_write;
+static uint64_t stream_write_us;
+
+static void *stream_open(const char *filename)
+{
+    (void)filename;
+    return &stream_write;
+}
+
+static int32_t stream_chunk(JPEGFILE *file, uint8_t *data, int32_t length)
+{
+    (void)file;
+    uint64_t start_us = ei_read_timer_us();
+    stream_write(data, length);
+    stream_write_us += ei_read_timer_us() - start_us;
+    return length;
+}
+
+/**
+ * @brief Copy one MCU into mcu_bgr in the byte order the library expects
+ * (B, G, R), repeating the last row and column where the MCU overhangs the
+ * image so the encoder never reads past the frame buffer.
+ */
+static void load_mcu(const uint8_t *rgb888, int width, int height, int x, int y, int cx, int cy)
+{
+    uint8_t *d = mcu_bgr;
+
+    for (int row = 0; row < cy; row++) {
+        int sy = (y + row < height) ? y + row : height - 1;
+        const uint8_t *line = rgb888 + (size_t)sy * width * 3;
+
+        for (int col = 0; col < cx; col++) {
+            int sx = (x + col < width) ? x + col : width - 1;
+            const uint8_t *s = line + sx * 3;
+            d[0] = s[2];
+            d[1] = s[1];
+            d[2] = s[0];
+            d += 3;
+        }
+    }
+}
+
+int ei_jpeg_encode_rgb888(const uint8_t *rgb888, int width, int height, ei_jpeg_write_t write, ei_jpeg_stats_t *stats)
+{
+    JPEGENCODE jpe;
+    uint64_t start_us = ei_read_timer_us();
+
+    stream_write = write;
+    stream_write_us = 0;
+
+    int rc = jpg.open("", stream_open, nullptr, nullptr, stream_chunk, nullptr);
+    if (rc != JPEG_SUCCESS) {
+        return rc;
+    }
+
+    rc = jpg.encodeBegin(&jpe, width, height, JPEG_PIXEL_RGB888, jpeg_subsample, jpeg_quality);
+    if (rc != JPEG_SUCCESS) {
+        return rc;
+    }
+
+    int mcu_count = ((width + jpe.cx - 1) / jpe.cx) * ((height + jpe.cy - 1) / jpe.cy);
+
+    for (int i = 0; i < mcu_count; i++) {
+        // addMCU advances jpe.x / jpe.y to the next MCU
+        load_mcu(rgb888, width, height, jpe.x, jpe.y, jpe.cx, jpe.cy);
+        rc = jpg.addMCU(&jpe, mcu_bgr, jpe.cx * 3);
+        if (rc != JPEG_SUCCESS) {
+            return rc;
+        }
+    }
+
+    uint32_t size = jpg.close();
+
+    if (stats) {
+        stats->size = size;
+        stats->encode_us = (uint32_t)(ei_read_timer_us() - start_us - stream_write_us);
+    }
+
+    return 0;
+}
+
+bool ei_jpeg_set_settings(uint8_t quality, uint8_t subsample)
+{
+    if (quality > JPEG_Q_LOW || subsample > JPEG_SUBSAMPLE_420) {
+        return false;
+    }
+
+    jpeg_quality = quality;
+    jpeg_subsample = subsample;
+
+    return true;
+}
+
+uint8_t ei_jpeg_get_quality(void)
+{
+    return jpeg_quality;
+}
+
+uint8_t ei_jpeg_get_subsample(void)
+{
+    return jpeg_subsample;
+}
+
+const char *ei_jpeg_quality_name(uint8_t quality)
+{
+    return quality <= JPEG_Q_LOW ? quality_names[quality] : nullptr;
+}
+
+const char *ei_jpeg_subsample_name(uint8_t subsample)
+{
+    return subsample <= JPEG_SUBSAMPLE_420 ? subsample_names[subsample] : nullptr;
+}
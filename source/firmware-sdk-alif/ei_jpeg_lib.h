@@ -0,0 +1,89 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_JPEG_LIB_H
+#define EI_JPEG_LIB_H
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Streaming JPEG encoder for RGB888 frame buffers.
+ *
+ * Pixels are read straight from the frame buffer one MCU at a time, and the
+ * compressed data goes out through a callback in chunks of at most
+ * JPEG_FILE_BUF_SIZE bytes, so no output buffer is needed. Quality and chroma
+ * subsampling are runtime settings (AT+JPEG).
+ */
+
+/**
+ * @brief Called with each chunk of compressed data, in order
+ */
+typedef void (*ei_jpeg_write_t)(const uint8_t *data, size_t length);
+
+typedef struct {
+    uint32_t size;      // compressed size in bytes
+    uint32_t encode_us; // time spent encoding, excluding the write callback
+} ei_jpeg_stats_t;
+
+/**
+ * @brief Encode an RGB888 (R, G, B byte order) image and stream it out
+ *
+ * @param rgb888 frame buffer, width * height * 3 bytes
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param write called with each chunk of output
+ * @param stats filled in on success, may be NULL
+ * @return 0 on success, JPEG_* error code otherwise
+ */
+int ei_jpeg_encode_rgb888(const uint8_t *rgb888, int width, int height, ei_jpeg_write_t write, ei_jpeg_stats_t *stats);
+
+/**
+ * @brief Settings used by ei_jpeg_encode_rgb888
+ *
+ * @param quality JPEG_Q_BEST, JPEG_Q_HIGH, JPEG_Q_MED or JPEG_Q_LOW
+ * @param subsample JPEG_SUBSAMPLE_444 or JPEG_SUBSAMPLE_420
+ * @return false if either value is out of range, settings unchanged
+ */
+bool ei_jpeg_set_settings(uint8_t quality, uint8_t subsample);
+uint8_t ei_jpeg_get_quality(void);
+uint8_t ei_jpeg_get_subsample(void);
+
+/**
+ * @brief Names used by AT+JPEG, NULL when out of range
+ */
+const char *ei_jpeg_quality_name(uint8_t quality);
+const char *ei_jpeg_subsample_name(uint8_t subsample);
+
+#endif /* EI_JPEG_LIB_H */
@@ -0,0 +1,168 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ei_perf_lib.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+#if defined(ARM_NPU)
+extern "C" {
+#include "ethosu_profiler.h"
+}
+#endif
+
+#if defined(__arm__)
+#include "RTE_Components.h"
+#include CMSIS_device_header
+#endif
+
+// Ethos-U55 AXI data beats are 64 bits
+#define NPU_AXI_BEAT_BYTES 8
+
+static ei_perf_record_t last_record;
+static uint32_t start_cycles;
+
+static uint32_t perf_cycles(void)
+{
+#if defined(__arm__)
+    return ARM_PMU_Get_CCNTR();
+#else
+    return (uint32_t)ei_read_timer_us();
+#endif
+}
+
+static uint32_t perf_cpu_hz(void)
+{
+#if defined(__arm__)
+    return GetSystemCoreClock();
+#else
+    return 1000000;
+#endif
+}
+
+/* The SDK's microsecond timings in CPU cycles, saturated to the record's 32 bits */
+static uint32_t perf_us_to_cycles(int64_t us, uint32_t cpu_hz)
+{
+    if (us <= 0) {
+        return 0;
+    }
+    const uint64_t cycles = (uint64_t)us * (cpu_hz / 1000000);
+    return cycles > UINT32_MAX ? UINT32_MAX : (uint32_t)cycles;
+}
+
+void ei_perf_begin(void)
+{
+#if defined(ARM_NPU)
+    static bool npu_pmu_ready = false;
+    if (!npu_pmu_ready) {
+        ethosu_pmu_init();
+        npu_pmu_ready = true;
+    }
+    ethosu_pmu_reset_counters();
+#endif
+#if defined(__arm__)
+    ARM_PMU_Enable();
+    ARM_PMU_CNTR_Enable(PMU_CNTENSET_CCNTR_ENABLE_Msk);
+#endif
+    start_cycles = perf_cycles();
+}
+
+void ei_perf_end(const ei_impulse_result_t *result, const ei_camera_stage_cycles_t *capture)
+{
+    ei_perf_record_t record = {};
+
+    record.total = perf_cycles() - start_cycles;
+    record.sequence = last_record.sequence + 1;
+    record.cpu_hz = perf_cpu_hz();
+
+    if (capture) {
+        record.capture = capture->capture_wait;
+        record.demosaic = capture->demosaic;
+        record.resize = capture->crop + capture->resize + capture->color_correction;
+    }
+
+    // the SDK times DSP and classification in microseconds
+    record.dsp = perf_us_to_cycles(result->timing.dsp_us, record.cpu_hz);
+    uint32_t classification = perf_us_to_cycles(result->timing.classification_us, record.cpu_hz);
+
+#if defined(ARM_NPU)
+    ethosu_pmu_counters npu = ethosu_get_pmu_counters();
+    record.npu_idle = npu.npu_evt_counters[0].counter_value;
+    record.axi0_rd_beats = npu.npu_evt_counters[1].counter_value;
+    record.axi0_wr_beats = npu.npu_evt_counters[2].counter_value;
+    record.axi1_rd_beats = npu.npu_evt_counters[3].counter_value;
+#if ETHOSU_DERIVED_NCOUNTERS >= 1
+    record.npu_active = npu.npu_derived_counters[0].counter_value;
+#endif
+    record.npu_wait = (uint32_t)npu.cpu_wait_ccnt;
+#endif
+
+    // what's left of classification ran on the CPU, and what's left of the run is post-processing.
+    // The SDK's timers and the cycle counter are read at different points, so the stages
+    // can add up to more than the total: post is then 0 rather than wrapping
+    record.npu_wait = record.npu_wait < classification ? record.npu_wait : classification;
+    record.cpu_ops = classification - record.npu_wait;
+    const uint64_t accounted = (uint64_t)record.dsp + classification;
+    record.post = record.total > accounted ? (uint32_t)(record.total - accounted) : 0;
+
+    last_record = record;
+}
+
+const ei_perf_record_t *ei_perf_get_last(void)
+{
+    return &last_record;
+}
+
+void ei_perf_print(const ei_perf_record_t *record)
+{
+    const uint32_t npu_cycles = record->npu_active + record->npu_idle;
+    const uint64_t axi_bytes = (uint64_t)(record->axi0_rd_beats + record->axi0_wr_beats + record->axi1_rd_beats)
+        * NPU_AXI_BEAT_BYTES;
+
+    ei_printf("{\"seq\":%u,\"cpu_hz\":%u,"
+        "\"capture\":%u,\"demosaic\":%u,\"resize\":%u,\"dsp\":%u,"
+        "\"npu_wait\":%u,\"cpu_ops\":%u,\"post\":%u,\"total\":%u,"
+        "\"npu_active\":%u,\"npu_idle\":%u,"
+        "\"axi0_rd_bytes\":%u,\"axi0_wr_bytes\":%u,\"axi1_rd_bytes\":%u,"
+        "\"axi_bytes_per_npu_cycle\":%.2f}\n",
+        (unsigned int)record->sequence, (unsigned int)record->cpu_hz,
+        (unsigned int)record->capture, (unsigned int)record->demosaic,
+        (unsigned int)record->resize, (unsigned int)record->dsp,
+        (unsigned int)record->npu_wait, (unsigned int)record->cpu_ops,
+        (unsigned int)record->post, (unsigned int)record->total,
+        (unsigned int)record->npu_active, (unsigned int)record->npu_idle,
+        (unsigned int)(record->axi0_rd_beats * NPU_AXI_BEAT_BYTES),
+        (unsigned int)(record->axi0_wr_beats * NPU_AXI_BEAT_BYTES),
+        (unsigned int)(record->axi1_rd_beats * NPU_AXI_BEAT_BYTES),
+        npu_cycles ? (float)axi_bytes / npu_cycles : 0.0f);
+}
@@ -0,0 +1,96 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_PERF_LIB_H
+#define EI_PERF_LIB_H
+
+#include <cstdint>
+#include "firmware-sdk-alif/ei_camera_interface.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_types.h"
+
+/*
+ * Per-inference performance counters, read back with AT+PERF.
+ *
+ * Wrap each run of the impulse in ei_perf_begin() / ei_perf_end(). CPU stages
+ * are in core clock cycles (M55 PMU cycle counter); the NPU counters come
+ * from the Ethos-U PMU. Builds without a cycle counter (native) count
+ * microseconds instead, and report cpu_hz as 1000000.
+ */
+
+typedef struct {
+    uint32_t sequence;        // increments with each recorded inference, 0 = none yet
+    uint32_t cpu_hz;          // cycles per second of the CPU counts below
+
+    // CPU cycles per stage
+    uint32_t capture;         // waiting for the camera frame
+    uint32_t demosaic;
+    uint32_t resize;          // crop, resize and color correction
+    uint32_t dsp;
+    uint32_t npu_wait;        // classification, waiting for the NPU
+    uint32_t cpu_ops;         // classification, operators run on the CPU
+    uint32_t post;            // anomaly and result processing
+    uint32_t total;           // whole run of the impulse (not including capture)
+
+    // Ethos-U PMU, in NPU cycles and AXI beats
+    uint32_t npu_active;
+    uint32_t npu_idle;
+    uint32_t axi0_rd_beats;
+    uint32_t axi0_wr_beats;
+    uint32_t axi1_rd_beats;
+} ei_perf_record_t;
+
+/**
+ * @brief Reset the counters, call just before run_classifier
+ */
+void ei_perf_begin(void);
+
+/**
+ * @brief Read the counters into the record AT+PERF returns
+ *
+ * @param result timings of the run that just finished
+ * @param capture camera stage cycles for the frame, or NULL
+ */
+void ei_perf_end(const ei_impulse_result_t *result, const ei_camera_stage_cycles_t *capture);
+
+/**
+ * @brief The most recent record
+ */
+const ei_perf_record_t *ei_perf_get_last(void);
+
+/**
+ * @brief Print a record as one line of JSON
+ */
+void ei_perf_print(const ei_perf_record_t *record);
+
+#endif /* EI_PERF_LIB_H */
@@ -0,0 +1,78 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ei_threshold_lib.h"
+#include "model-parameters/model_metadata.h"
+
+static float result_threshold = EI_RESULT_THRESHOLD;
+static uint32_t threshold_changes = 0;
+
+bool ei_threshold_set(float threshold)
+{
+    // also rejects NaN
+    if (!(threshold >= 0.0f && threshold <= 1.0f)) {
+        return false;
+    }
+
+    result_threshold = threshold;
+    threshold_changes++;
+
+    return true;
+}
+
+float ei_threshold_get(void)
+{
+    return result_threshold;
+}
+
+uint32_t ei_threshold_changes(void)
+{
+    return threshold_changes;
+}
+
+void ei_threshold_apply(ei_impulse_result_t *result)
+{
+#if EI_CLASSIFIER_OBJECT_DETECTION == 1
+    uint32_t kept = 0;
+
+    for (uint32_t ix = 0; ix < result->bounding_boxes_count; ix++) {
+        if (result->bounding_boxes[ix].value >= result_threshold) {
+            result->bounding_boxes[kept++] = result->bounding_boxes[ix];
+        }
+    }
+    result->bounding_boxes_count = kept;
+#else
+    (void)result;
+#endif
+}
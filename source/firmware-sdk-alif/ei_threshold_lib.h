@@ -0,0 +1,74 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_THRESHOLD_LIB_H
+#define EI_THRESHOLD_LIB_H
+
+#include <cstdint>
+#include "edge-impulse-sdk/classifier/ei_classifier_types.h"
+
+/*
+ * Result threshold, a runtime setting (AT+THRESHOLD) that may be changed
+ * while inference is running.
+ *
+ * Objects under the threshold are dropped from the results, on top of the
+ * threshold the model was trained with (which the SDK applies first, so the
+ * setting can only raise it). A running cascade also takes it as its wake
+ * threshold: a confidence for a wake label, a level for VAD.
+ */
+
+#ifndef EI_RESULT_THRESHOLD
+#define EI_RESULT_THRESHOLD 0.0f    // everything the SDK reports
+#endif
+
+/**
+ * @brief Change the threshold
+ * @return false if it is not between 0 and 1, threshold unchanged
+ */
+bool ei_threshold_set(float threshold);
+float ei_threshold_get(void);
+
+/**
+ * @brief Count of ei_threshold_set calls, so a running use case can tell a
+ * new setting from the one it started with
+ */
+uint32_t ei_threshold_changes(void);
+
+/**
+ * @brief Drop the objects under the threshold from a result, keeping the
+ * order of the others. Classification results are left as they are.
+ */
+void ei_threshold_apply(ei_impulse_result_t *result);
+
+#endif /* EI_THRESHOLD_LIB_H */
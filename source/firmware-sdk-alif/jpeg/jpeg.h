@@ -3,6 +3,20 @@
 
 #include "JPEGENC.h"
 
+// Helium versions of the colour conversion, DCT and quantisation below give
+// the same output as the scalar code, which stays as the reference
+#ifndef JPEG_USE_MVE
+#if __ARM_FEATURE_MVE & 1
+#define JPEG_USE_MVE 1
+#else
+#define JPEG_USE_MVE 0
+#endif
+#endif
+
+#if JPEG_USE_MVE
+#include <arm_mve.h>
+#endif
+
 // Returns the magnitude and fixes negative values for JPEG encoding
 // Upper 16 bits is the new delta value, lower 16 is the magnitude
 const uint32_t ulMagnitudeFix[2048] PROGMEM = {
@@ -1286,6 +1300,67 @@ void JPEGSubSample24(unsigned char *pSrc, signed char *pLUM, signed char *pCb, s
     } // for y
 
 } /* JPEGSubSample24() */
+
+#if JPEG_USE_MVE
+// Y value of 4 pixels, and their unscaled Cb and Cr sums (see JPEGSubSample24)
+static inline int32x4_t JPEGRGB2YCC_MVE(const unsigned char *pSrc, uint32x4_t offsets, int32x4_t *pCb, int32x4_t *pCr)
+{
+    int32x4_t b = vreinterpretq_s32_u32(vldrbq_gather_offset_u32(pSrc, offsets));
+    int32x4_t g = vreinterpretq_s32_u32(vldrbq_gather_offset_u32(pSrc + 1, offsets));
+    int32x4_t r = vreinterpretq_s32_u32(vldrbq_gather_offset_u32(pSrc + 2, offsets));
+
+    int32x4_t y = vmulq_n_s32(r, 1225);
+    y = vmlaq_n_s32(y, g, 2404);
+    y = vmlaq_n_s32(y, b, 467);
+    y = vsubq_n_s32(vshrq_n_s32(y, 12), 0x80);
+
+    int32x4_t cb = vshlq_n_s32(b, 11);
+    cb = vmlaq_n_s32(cb, r, -691);
+    *pCb = vmlaq_n_s32(cb, g, -1357);
+
+    int32x4_t cr = vshlq_n_s32(r, 11);
+    cr = vmlaq_n_s32(cr, g, -1715);
+    *pCr = vmlaq_n_s32(cr, b, -333);
+
+    return y;
+}
+
+// 4:2:0 sampling of a full 8x8 quadrant, four 2x2 blocks per vector
+void JPEGSubSample24_MVE(unsigned char *pSrc, signed char *pLUM, signed char *pCb, signed char *pCr, int lsize, int cx, int cy)
+{
+    if (cx != 8 || cy != 8) {
+        JPEGSubSample24(pSrc, pLUM, pCb, pCr, lsize, cx, cy);
+        return;
+    }
+
+    const uint32x4_t offsets = vmulq_n_u32(vidupq_n_u32(0, 1), 6); // top left pixel of each block
+    const uint32x4_t lum_even = vmulq_n_u32(vidupq_n_u32(0, 1), 2);
+    const uint32x4_t lum_odd = vaddq_n_u32(lum_even, 1);
+
+    for (int y = 0; y < 4; y++) {
+        int32x4_t cb_sum = vdupq_n_s32(0);
+        int32x4_t cr_sum = vdupq_n_s32(0);
+
+        for (int q = 0; q < 4; q++) { // top left, top right, bottom left, bottom right
+            int32x4_t cb, cr;
+            int32x4_t lum = JPEGRGB2YCC_MVE(pSrc + (q & 1) * 3 + (q >> 1) * lsize, offsets, &cb, &cr);
+            vstrbq_scatter_offset_s32(pLUM + (q >> 1) * 8, (q & 1) ? lum_odd : lum_even, lum);
+            cb_sum = vaddq_s32(cb_sum, cb);
+            cr_sum = vaddq_s32(cr_sum, cr);
+        }
+
+        vstrbq_s32(pCb, vshrq_n_s32(cb_sum, 14));
+        vstrbq_s32(pCr, vshrq_n_s32(cr_sum, 14));
+        pCb += 8;
+        pCr += 8;
+        pLUM += 16;
+        pSrc += lsize * 2;
+    }
+} /* JPEGSubSample24_MVE() */
+#define JPEG_SUBSAMPLE24 JPEGSubSample24_MVE
+#else
+#define JPEG_SUBSAMPLE24 JPEGSubSample24
+#endif // JPEG_USE_MVE
 void JPEGSubSample16(unsigned char *pSrc, signed char *pLUM, signed char *pCb, signed char *pCr, int lsize, int cx, int cy)
 {
     int x, y;
@@ -1500,17 +1575,17 @@ void JPEGGetMCU22(unsigned char *pImage, JPEGIMAGE *pPage, int iPitch)
     else if (pPage->ucPixelType == JPEG_PIXEL_RGB888)
     {
         // upper left
-        JPEGSubSample24(pImage, pMCUData, &pMCUData[DCTSIZE*4], &pMCUData[DCTSIZE*5], iPitch, cx, cy);
+        JPEG_SUBSAMPLE24(pImage, pMCUData, &pMCUData[DCTSIZE*4], &pMCUData[DCTSIZE*5], iPitch, cx, cy);
         // upper right
         if (width > 8)
-            JPEGSubSample24(pImage+8*3, &pMCUData[DCTSIZE*1], &pMCUData[4+DCTSIZE*4], &pMCUData[4+DCTSIZE*5], iPitch, width-8, cy);
+            JPEG_SUBSAMPLE24(pImage+8*3, &pMCUData[DCTSIZE*1], &pMCUData[4+DCTSIZE*4], &pMCUData[4+DCTSIZE*5], iPitch, width-8, cy);
         if (height > 8)
         {
             // lower left
-            JPEGSubSample24(pImage+8*iPitch, &pMCUData[DCTSIZE*2], &pMCUData[32+DCTSIZE*4], &pMCUData[32+DCTSIZE*5], iPitch, cx, height - 8);
+            JPEG_SUBSAMPLE24(pImage+8*iPitch, &pMCUData[DCTSIZE*2], &pMCUData[32+DCTSIZE*4], &pMCUData[32+DCTSIZE*5], iPitch, cx, height - 8);
             // lower right
             if (width > 8)
-                JPEGSubSample24(pImage+8*iPitch + 8*3, &pMCUData[DCTSIZE*3], &pMCUData[36+DCTSIZE*4], &pMCUData[36+DCTSIZE*5], iPitch, width - 8, height - 8);
+                JPEG_SUBSAMPLE24(pImage+8*iPitch + 8*3, &pMCUData[DCTSIZE*3], &pMCUData[36+DCTSIZE*4], &pMCUData[36+DCTSIZE*5], iPitch, width - 8, height - 8);
         }
     }
     else if (pPage->ucPixelType == JPEG_PIXEL_ARGB8888)
@@ -1605,6 +1680,34 @@ void JPEGSample24(unsigned char *pSrc, signed char *pMCU, int lsize, int cx, int
 
 } /* JPEGSample24() */
 
+#if JPEG_USE_MVE
+// 4:4:4 sampling of a full 8x8 block, 4 pixels per vector
+void JPEGSample24_MVE(unsigned char *pSrc, signed char *pMCU, int lsize, int cx, int cy)
+{
+    if (cx != 8 || cy != 8) {
+        JPEGSample24(pSrc, pMCU, lsize, cx, cy);
+        return;
+    }
+
+    const uint32x4_t offsets = vmulq_n_u32(vidupq_n_u32(0, 1), 3);
+
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x += 4) {
+            int32x4_t cb, cr;
+            int32x4_t lum = JPEGRGB2YCC_MVE(pSrc + x * 3, offsets, &cb, &cr);
+            vstrbq_s32(pMCU + x, lum);
+            vstrbq_s32(pMCU + 64 + x, vshrq_n_s32(cb, 12));
+            vstrbq_s32(pMCU + 128 + x, vshrq_n_s32(cr, 12));
+        }
+        pMCU += 8;
+        pSrc += lsize;
+    }
+} /* JPEGSample24_MVE() */
+#define JPEG_SAMPLE24 JPEGSample24_MVE
+#else
+#define JPEG_SAMPLE24 JPEGSample24
+#endif // JPEG_USE_MVE
+
 void JPEGGetMCU11(unsigned char *pImage, JPEGIMAGE *pPage, int iPitch)
 {
     int cx, cy;
@@ -1620,7 +1723,7 @@ void JPEGGetMCU11(unsigned char *pImage, JPEGIMAGE *pPage, int iPitch)
 //    if (cy != 8 || cx != 8)
 //        memset(pMCUData, 0, 3*64*sizeof(short)); // make sure unused pixels are 0
     if (pPage->ucPixelType == JPEG_PIXEL_RGB888)
-        JPEGSample24(pImage, pMCUData, iPitch, cx, cy);
+        JPEG_SAMPLE24(pImage, pMCUData, iPitch, cx, cy);
     else if (pPage->ucPixelType == JPEG_PIXEL_RGB565)
         JPEGSample16(pImage, pMCUData, iPitch, cx, cy);
     else // must be 32-bpp
@@ -1711,6 +1814,118 @@ void JPEGFDCT(signed char *pMCUSrc, signed short *pMCUDest)
     } // for each column
 } /* JPEGFDCT() */
 
+#if JPEG_USE_MVE
+// (x * k) >> 8 per lane, keeping the product in 32 bits like JPEGFDCT
+static inline int16x8_t JPEGMulShr8_MVE(int16x8_t x, int16_t k)
+{
+    int32x4_t lo = vshrq_n_s32(vmullbq_int_s16(x, vdupq_n_s16(k)), 8);
+    int32x4_t hi = vshrq_n_s32(vmulltq_int_s16(x, vdupq_n_s16(k)), 8);
+    return vmovntq_s32(vmovnbq_s32(x, lo), hi);
+}
+
+// (d * 98 + x * k) >> 8 per lane, the z5 terms of JPEGFDCT
+static inline int16x8_t JPEGMulAddShr8_MVE(int16x8_t d, int16x8_t x, int16_t k)
+{
+    int32x4_t lo = vaddq_s32(vmullbq_int_s16(d, vdupq_n_s16(98)), vmullbq_int_s16(x, vdupq_n_s16(k)));
+    int32x4_t hi = vaddq_s32(vmulltq_int_s16(d, vdupq_n_s16(98)), vmulltq_int_s16(x, vdupq_n_s16(k)));
+    return vmovntq_s32(vmovnbq_s32(d, vshrq_n_s32(lo, 8)), vshrq_n_s32(hi, 8));
+}
+
+// One 1-D pass of JPEGFDCT over eight lines at once; v[k] holds element k of
+// every line. Intermediates stay within 16 bits for 8-bit input.
+static inline void JPEGFDCT8_MVE(int16x8_t v[8])
+{
+    int16x8_t tmp0 = vaddq_s16(v[0], v[7]);
+    int16x8_t tmp7 = vsubq_s16(v[0], v[7]);
+    int16x8_t tmp1 = vaddq_s16(v[1], v[6]);
+    int16x8_t tmp6 = vsubq_s16(v[1], v[6]);
+    int16x8_t tmp2 = vaddq_s16(v[2], v[5]);
+    int16x8_t tmp5 = vsubq_s16(v[2], v[5]);
+    int16x8_t tmp3 = vaddq_s16(v[3], v[4]);
+    int16x8_t tmp4 = vsubq_s16(v[3], v[4]);
+    // even part
+    int16x8_t tmp10 = vaddq_s16(tmp0, tmp3);
+    int16x8_t tmp13 = vsubq_s16(tmp0, tmp3);
+    int16x8_t tmp11 = vaddq_s16(tmp1, tmp2);
+    int16x8_t tmp12 = vsubq_s16(tmp1, tmp2);
+    v[0] = vaddq_s16(tmp10, tmp11);
+    v[4] = vsubq_s16(tmp10, tmp11);
+    int16x8_t z1 = JPEGMulShr8_MVE(vaddq_s16(tmp12, tmp13), 181);
+    v[2] = vaddq_s16(tmp13, z1);
+    v[6] = vsubq_s16(tmp13, z1);
+    // odd part
+    tmp10 = vaddq_s16(tmp4, tmp5);
+    tmp11 = vaddq_s16(tmp5, tmp6);
+    tmp12 = vaddq_s16(tmp6, tmp7);
+    int16x8_t z5 = vsubq_s16(tmp10, tmp12);
+    int16x8_t z2 = JPEGMulAddShr8_MVE(z5, tmp10, 139);
+    int16x8_t z4 = JPEGMulAddShr8_MVE(z5, tmp12, 334);
+    int16x8_t z3 = JPEGMulShr8_MVE(tmp11, 181);
+    int16x8_t z11 = vaddq_s16(tmp7, z3);
+    int16x8_t z13 = vsubq_s16(tmp7, z3);
+    v[5] = vaddq_s16(z13, z2);
+    v[3] = vsubq_s16(z13, z2);
+    v[1] = vaddq_s16(z11, z4);
+    v[7] = vsubq_s16(z11, z4);
+}
+
+void JPEGFDCT_MVE(signed char *pMCUSrc, signed short *pMCUDest)
+{
+    const uint16x8_t rows = vmulq_n_u16(vidupq_n_u16(0, 1), 8);
+    int16x8_t v[8];
+    int i;
+
+    // rows first: gather column k of all rows into v[k]
+    for (i = 0; i < 8; i++) {
+        v[i] = vldrbq_gather_offset_s16((const int8_t *)pMCUSrc + i, rows);
+    }
+    JPEGFDCT8_MVE(v);
+    // transpose through the destination on the way out
+    for (i = 0; i < 8; i++) {
+        vstrhq_scatter_shifted_offset_s16(pMCUDest + i, rows, v[i]);
+    }
+
+    // then the columns, a row of the intermediate result is a vector
+    for (i = 0; i < 8; i++) {
+        v[i] = vld1q_s16(pMCUDest + i * 8);
+    }
+    JPEGFDCT8_MVE(v);
+    for (i = 0; i < 8; i++) {
+        vst1q_s16(pMCUDest + i * 8, v[i]);
+    }
+} /* JPEGFDCT_MVE() */
+
+int JPEGQuantize_MVE(JPEGIMAGE *pJPEG, signed short *pMCUSrc, int iTable)
+{
+    const signed short *pQuant = &pJPEG->sQuantTable[iTable * DCTSIZE];
+    int32_t sum = 0;
+
+    for (int i = 0; i < DCTSIZE; i += 8) {
+        int16x8_t d = vld1q_s16(&pMCUSrc[i]);
+        int16x8_t sQ2 = vshrq_n_s16(vld1q_s16(&pQuant[i]), 1);
+        int16x8_t recip = vld1q_s16(&pQuant[i + 128]); // 65536/Q
+        int16x8_t t = vaddq_s16(sQ2, vabsq_s16(d));
+
+        int32x4_t lo = vshrq_n_s32(vmullbq_int_s16(t, recip), 16);
+        int32x4_t hi = vshrq_n_s32(vmulltq_int_s16(t, recip), 16);
+        int16x8_t m = vmovntq_s32(vmovnbq_s32(t, lo), hi);
+
+        vst1q_s16(&pMCUSrc[i], vpselq_s16(vnegq_s16(m), m, vcmpltq_n_s16(d, 0)));
+
+        // coefficients 33..63 decide sparseness, as in JPEGQuantize
+        if (i >= 32) {
+            sum = vaddvaq_p_s16(sum, m, i == 32 ? 0xfffc : 0xffff);
+        }
+    }
+    return (sum == 0);
+} /* JPEGQuantize_MVE() */
+#define JPEG_FDCT JPEGFDCT_MVE
+#define JPEG_QUANTIZE JPEGQuantize_MVE
+#else
+#define JPEG_FDCT JPEGFDCT
+#define JPEG_QUANTIZE JPEGQuantize
+#endif // JPEG_USE_MVE
+
 void FlushCode(PIL_CODE *pPC)
 {
     unsigned char c;
@@ -1738,8 +1953,8 @@ int JPEGAddMCU(JPEGIMAGE *pJPEG, JPEGENCODE *pEncode, uint8_t *pPixels, int iPit
     }
     if (pJPEG->ucPixelType == JPEG_PIXEL_GRAYSCALE) {
         JPEGGetMCU(pPixels, iPitch, pJPEG->MCUc);
-        JPEGFDCT(pJPEG->MCUc, pJPEG->MCUs);
-        bSparse = JPEGQuantize(pJPEG, pJPEG->MCUs, 0);
+        JPEG_FDCT(pJPEG->MCUc, pJPEG->MCUs);
+        bSparse = JPEG_QUANTIZE(pJPEG, pJPEG->MCUs, 0);
         pJPEG->iDCPred0 = JPEGEncodeMCU(0, pJPEG, pJPEG->MCUs, pJPEG->iDCPred0, bSparse);
         if (pEncode->x >= (pJPEG->iWidth - pEncode->cx)) { // end of the row?
             // Store the restart marker
@@ -1759,37 +1974,37 @@ int JPEGAddMCU(JPEGIMAGE *pJPEG, JPEGENCODE *pEncode, uint8_t *pPixels, int iPit
     } else { // color
         if (pJPEG->ucSubSample == JPEG_SUBSAMPLE_444) {
             JPEGGetMCU11(pPixels, pJPEG, iPitch);
-            JPEGFDCT(&pJPEG->MCUc[0*DCTSIZE], pJPEG->MCUs);
+            JPEG_FDCT(&pJPEG->MCUc[0*DCTSIZE], pJPEG->MCUs);
             // Y
-            bSparse = JPEGQuantize(pJPEG, pJPEG->MCUs, 0);
+            bSparse = JPEG_QUANTIZE(pJPEG, pJPEG->MCUs, 0);
             pJPEG->iDCPred0 = JPEGEncodeMCU(0, pJPEG, pJPEG->MCUs, pJPEG->iDCPred0, bSparse);
-            JPEGFDCT(&pJPEG->MCUc[1*DCTSIZE], pJPEG->MCUs);
+            JPEG_FDCT(&pJPEG->MCUc[1*DCTSIZE], pJPEG->MCUs);
             // Cb
-            bSparse = JPEGQuantize(pJPEG, pJPEG->MCUs, 1);
+            bSparse = JPEG_QUANTIZE(pJPEG, pJPEG->MCUs, 1);
             pJPEG->iDCPred1 = JPEGEncodeMCU(1, pJPEG, pJPEG->MCUs, pJPEG->iDCPred1, bSparse);
-            JPEGFDCT(&pJPEG->MCUc[2*DCTSIZE], pJPEG->MCUs);
+            JPEG_FDCT(&pJPEG->MCUc[2*DCTSIZE], pJPEG->MCUs);
             // Cr
-            bSparse = JPEGQuantize(pJPEG, pJPEG->MCUs, 1);
+            bSparse = JPEG_QUANTIZE(pJPEG, pJPEG->MCUs, 1);
             pJPEG->iDCPred2 = JPEGEncodeMCU(1, pJPEG, pJPEG->MCUs, pJPEG->iDCPred2, bSparse);
         } else { // must be 420
             JPEGGetMCU22(pPixels, pJPEG, iPitch);
-            JPEGFDCT(&pJPEG->MCUc[0*DCTSIZE], pJPEG->MCUs); // Y0
-            bSparse = JPEGQuantize(pJPEG, pJPEG->MCUs, 0);
+            JPEG_FDCT(&pJPEG->MCUc[0*DCTSIZE], pJPEG->MCUs); // Y0
+            bSparse = JPEG_QUANTIZE(pJPEG, pJPEG->MCUs, 0);
             pJPEG->iDCPred0 = JPEGEncodeMCU(0, pJPEG, pJPEG->MCUs, pJPEG->iDCPred0, bSparse);
-            JPEGFDCT(&pJPEG->MCUc[1*DCTSIZE], pJPEG->MCUs); // Y1
-            bSparse = JPEGQuantize(pJPEG, pJPEG->MCUs, 0);
+            JPEG_FDCT(&pJPEG->MCUc[1*DCTSIZE], pJPEG->MCUs); // Y1
+            bSparse = JPEG_QUANTIZE(pJPEG, pJPEG->MCUs, 0);
             pJPEG->iDCPred0 = JPEGEncodeMCU(0, pJPEG, pJPEG->MCUs, pJPEG->iDCPred0, bSparse);
-            JPEGFDCT(&pJPEG->MCUc[2*DCTSIZE], pJPEG->MCUs); // Y2
-            bSparse = JPEGQuantize(pJPEG, pJPEG->MCUs, 0);
+            JPEG_FDCT(&pJPEG->MCUc[2*DCTSIZE], pJPEG->MCUs); // Y2
+            bSparse = JPEG_QUANTIZE(pJPEG, pJPEG->MCUs, 0);
             pJPEG->iDCPred0 = JPEGEncodeMCU(0, pJPEG, pJPEG->MCUs, pJPEG->iDCPred0, bSparse);
-            JPEGFDCT(&pJPEG->MCUc[3*DCTSIZE], pJPEG->MCUs); // Y3
-            bSparse = JPEGQuantize(pJPEG, pJPEG->MCUs, 0);
+            JPEG_FDCT(&pJPEG->MCUc[3*DCTSIZE], pJPEG->MCUs); // Y3
+            bSparse = JPEG_QUANTIZE(pJPEG, pJPEG->MCUs, 0);
             pJPEG->iDCPred0 = JPEGEncodeMCU(0, pJPEG, pJPEG->MCUs, pJPEG->iDCPred0, bSparse);
-            JPEGFDCT(&pJPEG->MCUc[4*DCTSIZE], pJPEG->MCUs); // Cb
-            bSparse = JPEGQuantize(pJPEG, pJPEG->MCUs, 1);
+            JPEG_FDCT(&pJPEG->MCUc[4*DCTSIZE], pJPEG->MCUs); // Cb
+            bSparse = JPEG_QUANTIZE(pJPEG, pJPEG->MCUs, 1);
             pJPEG->iDCPred1 = JPEGEncodeMCU(1, pJPEG, pJPEG->MCUs, pJPEG->iDCPred1, bSparse);
-            JPEGFDCT(&pJPEG->MCUc[5*DCTSIZE], pJPEG->MCUs); // Cr
-            bSparse = JPEGQuantize(pJPEG, pJPEG->MCUs, 1);
+            JPEG_FDCT(&pJPEG->MCUc[5*DCTSIZE], pJPEG->MCUs); // Cr
+            bSparse = JPEG_QUANTIZE(pJPEG, pJPEG->MCUs, 1);
             pJPEG->iDCPred2 = JPEGEncodeMCU(1, pJPEG, pJPEG->MCUs, pJPEG->iDCPred2, bSparse);
         } // 420 subsample
         if (pEncode->x >= (pJPEG->iWidth - pEncode->cx)) { // end of the row?
@@ -36,12 +36,10 @@
 #include "firmware-sdk-alif/ei_device_info_lib.h"
 #include "firmware-sdk-alif/ei_device_memory.h"
 #include "firmware-sdk-alif/at-server/ei_at_server.h"
-#include "firmware-sdk-alif/at-server/ei_at_command_set.h"
-#include "firmware-sdk-alif/ei_at_handlers_lib.h"
-#include "firmware-sdk-alif/ei_image_lib.h"
 #include "ei_microphone.h"
-#include "ei_run_impulse.h"
+#include "ei_at_commands.h"
 #include "delay.h"
+#include CMSIS_device_header
 
 #include <cstdio>
 
@@ -67,9 +65,71 @@ void *__stack_chk_guard = (void *)0xaeaeaeae;
 extern "C" void ei_sleep_c(int32_t time_ms) { ei_sleep( time_ms ); }
 extern "C" int Init_SysTick(void);
 
-extern "C" unsigned char UartGetc(void);
 extern "C" int arm_ethosu_npu_init(void);
 
+/* Linker script symbols, weak so a script without them just leaves them out */
+extern "C" {
+extern uint8_t __tensor_arena_start__[] __attribute__((weak));
+extern uint8_t __tensor_arena_end__[] __attribute__((weak));
+extern uint8_t __frame_buf_start__[] __attribute__((weak));
+extern uint8_t __frame_buf_end__[] __attribute__((weak));
+extern uint8_t __audio_buf_start__[] __attribute__((weak));
+extern uint8_t __audio_buf_end__[] __attribute__((weak));
+extern uint8_t __bss_start__[] __attribute__((weak));
+extern uint8_t __bss_end__[] __attribute__((weak));
+extern uint8_t __end__[] __attribute__((weak));
+extern uint8_t __HeapLimit[] __attribute__((weak));
+extern uint8_t __StackLimit[] __attribute__((weak));
+extern uint8_t __StackTop[] __attribute__((weak));
+}
+
+static const char *memory_region_name(const uint8_t *addr)
+{
+    uintptr_t a = (uintptr_t)addr;
+
+    if (a < 0x00100000) {
+        return "ITCM";
+    }
+    else if (a >= 0x20000000 && a < 0x20100000) {
+        return "DTCM";
+    }
+    else if (a >= 0x02000000 && a < 0x02400000) {
+        return "SRAM0";
+    }
+    else if (a >= 0x08000000 && a < 0x08280000) {
+        return "SRAM1";
+    }
+    return "?";
+}
+
+static void print_memory_region(const char *name, const uint8_t *start, const uint8_t *end)
+{
+    if (start == nullptr || end == nullptr || end <= start) {
+        return;
+    }
+    ei_printf("\t%-14s 0x%08x %8u bytes (%s)\r\n",
+              name,
+              (unsigned int)(uintptr_t)start,
+              (unsigned int)(end - start),
+              memory_region_name(start));
+}
+
+static void print_memory_map()
+{
+    ei_printf("Memory map:\r\n");
+    if (__tensor_arena_end__ > __tensor_arena_start__) {
+        print_memory_region("tensor arena", __tensor_arena_start__, __tensor_arena_end__);
+    }
+    else {
+        ei_printf("\t%-14s heap, allocated per inference\r\n", "tensor arena");
+    }
+    print_memory_region("frame buffers", __frame_buf_start__, __frame_buf_end__);
+    print_memory_region("audio buffers", __audio_buf_start__, __audio_buf_end__);
+    print_memory_region(".bss", __bss_start__, __bss_end__);
+    print_memory_region("heap", __end__, __HeapLimit);
+    print_memory_region("stack", __StackLimit, __StackTop);
+}
+
 int main()
 {
     init_trigger_rx();
@@ -80,6 +140,8 @@ int main()
               __DATE__,
               __TIME__);
 
+    print_memory_map();
+
     #if ARM_NPU
     arm_ethosu_npu_init();
     ei_printf("ARM ethos init\r\n");
@@ -87,24 +149,7 @@ int main()
 
     sleep_or_wait_msec(10);
 
-    auto at = ATServer::get_instance();
-
-    at->register_command(AT_CONFIG, AT_CONFIG_HELP_TEXT, nullptr, at_get_config, nullptr, nullptr);
-    at->register_command(AT_SAMPLESTART, AT_SAMPLESTART_HELP_TEXT, nullptr, nullptr, at_sample_start, AT_SAMPLESTART_ARGS);
-    at->register_command(AT_READBUFFER, AT_READBUFFER_HELP_TEXT, nullptr, nullptr, at_read_buffer, AT_READBUFFER_ARGS);
-    // at->register_command(AT_READFILE, AT_READFILE_HELP_TEXT, nullptr, nullptr, at_read_file, AT_READFILE_ARGS);
-    at->register_command(AT_MGMTSETTINGS, AT_MGMTSETTINGS_HELP_TEXT, nullptr, at_get_mgmt_url, at_set_mgmt_url, AT_MGMTSETTINGS_ARGS);
-    at->register_command(AT_CLEARCONFIG, AT_CLEARCONFIG_HELP_TEXT, at_clear_config, nullptr, nullptr, nullptr);
-    at->register_command(AT_DEVICEID, AT_DEVICEID_HELP_TEXT, nullptr, at_get_device_id, at_set_device_id, AT_DEVICEID_ARGS);
-    at->register_command(AT_SAMPLESETTINGS, AT_SAMPLESETTINGS_HELP_TEXT, nullptr, at_get_sample_settings, at_set_sample_settings, AT_SAMPLESETTINGS_ARGS);
-    at->register_command(AT_SNAPSHOT, AT_SNAPSHOT_HELP_TEXT, nullptr, at_get_snapshot, at_take_snapshot, AT_SNAPSHOT_ARGS);
-    at->register_command(AT_SNAPSHOTSTREAM, AT_SNAPSHOTSTREAM_HELP_TEXT, nullptr, nullptr, at_snapshot_stream, AT_SNAPSHOTSTREAM_ARGS);
-    at->register_command(AT_UPLOADSETTINGS, AT_UPLOADSETTINGS_HELP_TEXT, nullptr, at_get_upload_settings, at_set_upload_settings, AT_UPLOADSETTINGS_ARGS);
-    at->register_command(AT_UPLOADHOST, AT_UPLOADHOST_HELP_TEXT, nullptr, at_get_upload_host, at_set_upload_host, AT_UPLOADHOST_ARGS);
-    // at->register_command(AT_UNLINKFILE, AT_UNLINKFILE_HELP_TEXT, nullptr, nullptr, at_unlink_file, AT_UNLINKFILE_ARGS);
-    at->register_command(AT_RUNIMPULSE, AT_RUNIMPULSE_HELP_TEXT, run_nn_normal, nullptr, nullptr, nullptr);
-    at->register_command(AT_RUNIMPULSEDEBUG, AT_RUNIMPULSEDEBUG_HELP_TEXT, nullptr, nullptr, run_nn_debug, AT_RUNIMPULSEDEBUG_ARGS);
-    // at->register_command(AT_RUNIMPULSECONT, AT_RUNIMPULSECONT_HELP_TEXT, at_run_impulse_cont, nullptr, nullptr, nullptr);
+    auto at = ei_at_commands_init();
 
     ei_microphone_init();
 
@@ -113,19 +158,22 @@ int main()
         ei_printf("hal_image_init failed with error: %d\n", err);
     }
 
+    // Input is buffered by the UART interrupt, so nothing is lost while a
+    // command runs. Long running commands keep feeding the AT server from
+    // ei_user_invoke_stop_lib, which is how 'b' and async commands get in.
+    // One byte at a time: a command runs from inside handle(), and whatever
+    // follows its '\r' has to still be in the ring for it to read.
     while (1)
     {
-        // blocking call
-        char data = UartGetc();
-        if (data != 0xFF)
+        uint8_t c;
+        if (UartRead(&c, 1) == 0)
         {
-            at->handle(data);
+            // sleep until the next interrupt
+            __WFE();
+            continue;
         }
-        // else
-        // {
-        //     ei_printf("UART read error\n");
-        //     break;
-        // }
+
+        at->handle(c);
     }
 }
 
@@ -0,0 +1,292 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ei_hmac_sha256.h"
+
+#include <string.h>
+
+// the portable schedule below stays as the reference for the Helium one
+#ifndef EI_SHA256_USE_MVE
+#if __ARM_FEATURE_MVE & 1
+#define EI_SHA256_USE_MVE 1
+#else
+#define EI_SHA256_USE_MVE 0
+#endif
+#endif
+
+#if EI_SHA256_USE_MVE
+#include <arm_mve.h>
+#endif
+
+static const uint32_t K[64] __attribute__((aligned(16))) = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
+    0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+    0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC,
+    0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+    0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+    0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+    0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5,
+    0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+    0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+static const uint32_t sha256_iv[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define SIGMA0(x) (ROTR(x, 7) ^ ROTR(x, 18) ^ ((x) >> 3))
+#define SIGMA1(x) (ROTR(x, 17) ^ ROTR(x, 19) ^ ((x) >> 10))
+#define SUM0(x)   (ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22))
+#define SUM1(x)   (ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25))
+
+#define CH(x, y, z)  ((z) ^ ((x) & ((y) ^ (z))))
+#define MAJ(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+
+static inline uint32_t load_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void store_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+/**
+ * @brief Expand one block into W[t] + K[t] for all 64 rounds
+ */
+static void sha256_schedule(const uint8_t *block, uint32_t wk[64])
+{
+    uint32_t W[64] __attribute__((aligned(16)));
+
+#if EI_SHA256_USE_MVE
+    for (int t = 0; t < 16; t += 4) {
+        uint32x4_t w = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(block + 4 * t)));
+        vst1q_u32(&W[t], w);
+    }
+
+    // Four words per step: W[t-16], W[t-15] and W[t-7] are all from earlier
+    // steps, only sigma1(W[t-2]) reaches into the words being computed.
+    for (int t = 16; t < 64; t += 4) {
+        uint32x4_t w15 = vld1q_u32(&W[t - 15]);
+        uint32x4_t s0 = veorq_u32(
+            veorq_u32(vsriq_n_u32(vshlq_n_u32(w15, 25), w15, 7), vsriq_n_u32(vshlq_n_u32(w15, 14), w15, 18)),
+            vshrq_n_u32(w15, 3));
+        uint32x4_t v = vaddq_u32(vaddq_u32(vld1q_u32(&W[t - 16]), vld1q_u32(&W[t - 7])), s0);
+        vst1q_u32(&W[t], v);
+
+        W[t] += SIGMA1(W[t - 2]);
+        W[t + 1] += SIGMA1(W[t - 1]);
+        W[t + 2] += SIGMA1(W[t]);
+        W[t + 3] += SIGMA1(W[t + 1]);
+    }
+
+    for (int t = 0; t < 64; t += 4) {
+        vst1q_u32(&wk[t], vaddq_u32(vld1q_u32(&W[t]), vld1q_u32(&K[t])));
+    }
+#else
+    for (int t = 0; t < 16; t++) {
+        W[t] = load_be32(block + 4 * t);
+    }
+    for (int t = 16; t < 64; t++) {
+        W[t] = SIGMA1(W[t - 2]) + W[t - 7] + SIGMA0(W[t - 15]) + W[t - 16];
+    }
+    for (int t = 0; t < 64; t++) {
+        wk[t] = W[t] + K[t];
+    }
+#endif
+}
+
+#define ROUND(a, b, c, d, e, f, g, h, t)                         \
+    do {                                                         \
+        uint32_t t1 = (h) + SUM1(e) + CH(e, f, g) + wk[t];       \
+        (d) += t1;                                               \
+        (h) = t1 + SUM0(a) + MAJ(a, b, c);                       \
+    } while (0)
+
+void ei_sha256_process(uint32_t state[8], const uint8_t *blocks, size_t block_count)
+{
+    uint32_t wk[64] __attribute__((aligned(16)));
+
+    while (block_count--) {
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        sha256_schedule(blocks, wk);
+
+        // the rounds are serial, unrolled by 8 so the registers rotate by name
+        for (int t = 0; t < 64; t += 8) {
+            ROUND(a, b, c, d, e, f, g, h, t + 0);
+            ROUND(h, a, b, c, d, e, f, g, t + 1);
+            ROUND(g, h, a, b, c, d, e, f, t + 2);
+            ROUND(f, g, h, a, b, c, d, e, t + 3);
+            ROUND(e, f, g, h, a, b, c, d, t + 4);
+            ROUND(d, e, f, g, h, a, b, c, t + 5);
+            ROUND(c, d, e, f, g, h, a, b, t + 6);
+            ROUND(b, c, d, e, f, g, h, a, t + 7);
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+
+        blocks += EI_SHA256_BLOCK_SIZE;
+    }
+}
+
+void ei_sha256_starts(ei_sha256_ctx_t *ctx)
+{
+    memcpy(ctx->state, sha256_iv, sizeof(ctx->state));
+    ctx->total = 0;
+}
+
+void ei_sha256_update(ei_sha256_ctx_t *ctx, const uint8_t *input, size_t length)
+{
+    size_t used = (size_t)(ctx->total & (EI_SHA256_BLOCK_SIZE - 1));
+
+    ctx->total += length;
+
+    if (used) {
+        size_t fill = EI_SHA256_BLOCK_SIZE - used;
+        if (length < fill) {
+            memcpy(&ctx->buffer[used], input, length);
+            return;
+        }
+        memcpy(&ctx->buffer[used], input, fill);
+        ei_sha256_process(ctx->state, ctx->buffer, 1);
+        input += fill;
+        length -= fill;
+    }
+
+    // whole blocks straight from the input
+    size_t blocks = length / EI_SHA256_BLOCK_SIZE;
+    if (blocks) {
+        ei_sha256_process(ctx->state, input, blocks);
+        input += blocks * EI_SHA256_BLOCK_SIZE;
+        length -= blocks * EI_SHA256_BLOCK_SIZE;
+    }
+
+    memcpy(ctx->buffer, input, length);
+}
+
+void ei_sha256_finish(ei_sha256_ctx_t *ctx, uint8_t output[EI_SHA256_DIGEST_SIZE])
+{
+    size_t used = (size_t)(ctx->total & (EI_SHA256_BLOCK_SIZE - 1));
+    uint64_t bits = ctx->total << 3;
+
+    // 0x80, zeros, then the 64 bit length in the last 8 bytes
+    ctx->buffer[used++] = 0x80;
+    if (used > EI_SHA256_BLOCK_SIZE - 8) {
+        memset(&ctx->buffer[used], 0, EI_SHA256_BLOCK_SIZE - used);
+        ei_sha256_process(ctx->state, ctx->buffer, 1);
+        used = 0;
+    }
+    memset(&ctx->buffer[used], 0, EI_SHA256_BLOCK_SIZE - 8 - used);
+    store_be32(&ctx->buffer[56], (uint32_t)(bits >> 32));
+    store_be32(&ctx->buffer[60], (uint32_t)bits);
+    ei_sha256_process(ctx->state, ctx->buffer, 1);
+
+    for (int i = 0; i < 8; i++) {
+        store_be32(&output[4 * i], ctx->state[i]);
+    }
+}
+
+void ei_hmac_sha256_starts(ei_hmac_sha256_ctx_t *ctx, const uint8_t *key, size_t key_length)
+{
+    uint8_t pad[EI_SHA256_BLOCK_SIZE];
+    uint8_t key_hash[EI_SHA256_DIGEST_SIZE];
+
+    if (key_length > EI_SHA256_BLOCK_SIZE) {
+        ei_sha256_starts(&ctx->inner);
+        ei_sha256_update(&ctx->inner, key, key_length);
+        ei_sha256_finish(&ctx->inner, key_hash);
+        key = key_hash;
+        key_length = EI_SHA256_DIGEST_SIZE;
+    }
+
+    memset(pad, 0x36, sizeof(pad));
+    for (size_t i = 0; i < key_length; i++) {
+        pad[i] ^= key[i];
+    }
+    memcpy(ctx->inner_start, sha256_iv, sizeof(ctx->inner_start));
+    ei_sha256_process(ctx->inner_start, pad, 1);
+
+    memset(pad, 0x5c, sizeof(pad));
+    for (size_t i = 0; i < key_length; i++) {
+        pad[i] ^= key[i];
+    }
+    memcpy(ctx->outer_start, sha256_iv, sizeof(ctx->outer_start));
+    ei_sha256_process(ctx->outer_start, pad, 1);
+
+    memset(pad, 0, sizeof(pad));
+    memset(key_hash, 0, sizeof(key_hash));
+
+    ei_hmac_sha256_reset(ctx);
+}
+
+void ei_hmac_sha256_reset(ei_hmac_sha256_ctx_t *ctx)
+{
+    memcpy(ctx->inner.state, ctx->inner_start, sizeof(ctx->inner.state));
+    ctx->inner.total = EI_SHA256_BLOCK_SIZE;
+}
+
+void ei_hmac_sha256_update(ei_hmac_sha256_ctx_t *ctx, const uint8_t *input, size_t length)
+{
+    ei_sha256_update(&ctx->inner, input, length);
+}
+
+void ei_hmac_sha256_finish(ei_hmac_sha256_ctx_t *ctx, uint8_t output[EI_SHA256_DIGEST_SIZE])
+{
+    uint8_t inner_hash[EI_SHA256_DIGEST_SIZE];
+    ei_sha256_ctx_t outer;
+
+    ei_sha256_finish(&ctx->inner, inner_hash);
+
+    memcpy(outer.state, ctx->outer_start, sizeof(outer.state));
+    outer.total = EI_SHA256_BLOCK_SIZE;
+    ei_sha256_update(&outer, inner_hash, sizeof(inner_hash));
+    ei_sha256_finish(&outer, output);
+}
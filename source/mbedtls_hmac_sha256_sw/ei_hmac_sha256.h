@@ -0,0 +1,94 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_HMAC_SHA256_H
+#define EI_HMAC_SHA256_H
+
+/*
+ * Incremental SHA-256 and HMAC-SHA256 (FIPS 180-4, RFC 2104), no heap.
+ *
+ * The compression function has a portable C version and, when built for
+ * Helium, one that computes the message schedule four words at a time.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EI_SHA256_BLOCK_SIZE  64
+#define EI_SHA256_DIGEST_SIZE 32
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t total;                          // bytes hashed so far
+    uint8_t buffer[EI_SHA256_BLOCK_SIZE];    // partial block
+} ei_sha256_ctx_t;
+
+typedef struct {
+    ei_sha256_ctx_t inner;
+    uint32_t inner_start[8];                 // state after hashing key ^ ipad
+    uint32_t outer_start[8];                 // state after hashing key ^ opad
+} ei_hmac_sha256_ctx_t;
+
+void ei_sha256_starts(ei_sha256_ctx_t *ctx);
+void ei_sha256_update(ei_sha256_ctx_t *ctx, const uint8_t *input, size_t length);
+void ei_sha256_finish(ei_sha256_ctx_t *ctx, uint8_t output[EI_SHA256_DIGEST_SIZE]);
+
+/**
+ * @brief Run the compression function over whole 64 byte blocks
+ */
+void ei_sha256_process(uint32_t state[8], const uint8_t *blocks, size_t block_count);
+
+/**
+ * @brief Set up the key and start the first message. The key is folded into
+ * the pad states here, so it is not kept.
+ */
+void ei_hmac_sha256_starts(ei_hmac_sha256_ctx_t *ctx, const uint8_t *key, size_t key_length);
+
+/**
+ * @brief Start a new message with the same key
+ */
+void ei_hmac_sha256_reset(ei_hmac_sha256_ctx_t *ctx);
+
+void ei_hmac_sha256_update(ei_hmac_sha256_ctx_t *ctx, const uint8_t *input, size_t length);
+void ei_hmac_sha256_finish(ei_hmac_sha256_ctx_t *ctx, uint8_t output[EI_SHA256_DIGEST_SIZE]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EI_HMAC_SHA256_H */
@@ -0,0 +1,132 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host stand-in for the MHU link between the two cores: a pair of FIFOs,
+ * named by EI_NATIVE_MHU_RX and EI_NATIVE_MHU_TX, so two native builds (one
+ * with the audio model, one with the camera model) can run the cascade.
+ *
+ * See the README for an example.
+ */
+
+#include "firmware-sdk-alif/ei_cascade_lib.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#define RX_ENV "EI_NATIVE_MHU_RX"
+#define TX_ENV "EI_NATIVE_MHU_TX"
+
+// A message is smaller than PIPE_BUF, so each one is written and read whole
+static_assert(sizeof(ei_cascade_msg_t) <= 512, "cascade messages must be written atomically");
+
+static int rx_fd = -1;
+static int tx_fd = -1;
+
+bool ei_cascade_transport_init(void)
+{
+    const char *rx_path = getenv(RX_ENV);
+    const char *tx_path = getenv(TX_ENV);
+    if (rx_path == nullptr || tx_path == nullptr) {
+        ei_printf("Set %s and %s to a pair of FIFOs shared with the other core\n", RX_ENV, TX_ENV);
+        return false;
+    }
+
+    // Open our end for reading first: opening for writing blocks until the
+    // other side has done the same, so both processes get through
+    rx_fd = open(rx_path, O_RDONLY | O_NONBLOCK);
+    if (rx_fd < 0) {
+        ei_printf("Can't open %s\n", rx_path);
+        return false;
+    }
+
+    // a send to a core that has gone away fails rather than ending the process
+    signal(SIGPIPE, SIG_IGN);
+
+    tx_fd = open(tx_path, O_WRONLY);
+    if (tx_fd < 0) {
+        ei_printf("Can't open %s\n", tx_path);
+        close(rx_fd);
+        rx_fd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+void ei_cascade_transport_deinit(void)
+{
+    if (rx_fd >= 0) {
+        close(rx_fd);
+        rx_fd = -1;
+    }
+    if (tx_fd >= 0) {
+        close(tx_fd);
+        tx_fd = -1;
+    }
+}
+
+bool ei_cascade_transport_send(const ei_cascade_msg_t *msg)
+{
+    ssize_t n;
+    do {
+        n = write(tx_fd, msg, sizeof(*msg));
+    } while (n < 0 && errno == EINTR);
+
+    return n == (ssize_t)sizeof(*msg);
+}
+
+bool ei_cascade_transport_receive(ei_cascade_msg_t *msg)
+{
+    // nothing waiting gives EAGAIN, the other side gone gives 0
+    ssize_t n = read(rx_fd, msg, sizeof(*msg));
+    if (n != (ssize_t)sizeof(*msg)) {
+        return false;
+    }
+
+    return ei_cascade_msg_valid(msg);
+}
+
+void ei_cascade_transport_wait(uint32_t timeout_ms)
+{
+    struct pollfd pfd = { rx_fd, POLLIN, 0 };
+
+    // after the other side has closed the FIFO, poll returns at once
+    if (poll(&pfd, 1, timeout_ms) > 0 && !(pfd.revents & POLLIN)) {
+        ei_sleep(timeout_ms);
+    }
+}
@@ -0,0 +1,91 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host build entry point: the same AT interface as the board, on
+ * stdin/stdout, with camera and microphone data read from the files named by
+ * EI_NATIVE_IMAGE_FILE and EI_NATIVE_AUDIO_FILE.
+ *
+ * eg. printf 'AT+RUNIMPULSE\nb\n' | EI_NATIVE_IMAGE_FILE=frames.ppm ./app
+ *
+ * A running command stops on a 'b' line or at the end of the input, and
+ * the program exits at the end of the input.
+ */
+
+#include "hal.h"
+#include "ei_microphone.h"
+#include "ei_at_commands.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+int main()
+{
+    hal_platform_init();
+
+    ei_printf("Hello from Edge Impulse on Alif Ensemble E7 (native build)\r\n"
+              "Compiled on %s %s\r\n",
+              __DATE__,
+              __TIME__);
+
+    auto at = ei_at_commands_init();
+
+    ei_microphone_init();
+
+    int err = hal_image_init();
+    if (0 != err) {
+        ei_printf("hal_image_init failed with error: %d\n", err);
+    }
+
+    // One byte at a time: a command runs from inside handle(), and whatever
+    // follows its line ending (eg. the 'b' to stop it) has to still be in
+    // stdin for its ei_user_invoke_stop_lib to read.
+    while (1)
+    {
+        uint8_t c;
+        int len = UartRead(&c, 1);
+        if (len < 0)
+        {
+            // stdin closed
+            break;
+        }
+        if (len == 0)
+        {
+            UartWaitRx(-1);
+            continue;
+        }
+
+        at->handle(c);
+    }
+
+    send_wait();
+    return 0;
+}
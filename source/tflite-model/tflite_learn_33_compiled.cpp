@@ -80,7 +80,7 @@ constexpr int kTensorArenaSize = 150048;
 #endif
 
 #if defined(EI_CLASSIFIER_ALLOCATION_STATIC)
-uint8_t tensor_arena[kTensorArenaSize] ALIGN(16);
+uint8_t tensor_arena[kTensorArenaSize] ALIGN(16) __attribute__((section(".bss.tensor_arena")));
 #elif defined(EI_CLASSIFIER_ALLOCATION_STATIC_HIMAX)
 #pragma Bss(".tensor_arena")
 uint8_t tensor_arena[kTensorArenaSize] ALIGN(16);
@@ -89,7 +89,8 @@ uint8_t tensor_arena[kTensorArenaSize] ALIGN(16);
 uint8_t tensor_arena[kTensorArenaSize] ALIGN(16) __attribute__((section(".tensor_arena")));
 #else
 #define EI_CLASSIFIER_ALLOCATION_HEAP 1
-uint8_t* tensor_arena = NULL;
+// plain .bss: with -fdata-sections the pointer would otherwise land in .bss.tensor_arena
+uint8_t* tensor_arena __attribute__((section(".bss"))) = NULL;
 #endif
 
 static uint8_t* tensor_boundary;
@@ -256,6 +257,12 @@ static void * AllocatePersistentBufferImpl(struct TfLiteContext* ctx,
       return NULL;
     }
 
+#if defined(EI_CLASSIFIER_ALLOCATION_STATIC)
+    // the arena is placed by the linker, do not fall back to the heap
+    ei_printf("ERR: Failed to allocate persistent buffer of size %d, tensor arena (%d bytes) is too small\n",
+      (int)bytes, (int)kTensorArenaSize);
+    return NULL;
+#else
     // OK, this will look super weird, but.... we have CMSIS-NN buffers which
     // we cannot calculate beforehand easily.
     ptr = ei_calloc(bytes, 1);
@@ -265,6 +272,7 @@ static void * AllocatePersistentBufferImpl(struct TfLiteContext* ctx,
     }
     overflow_buffers[overflow_buffers_ix++] = ptr;
     return ptr;
+#endif
   }
 
   current_location -= bytes;
@@ -667,7 +675,7 @@ constexpr int kTensorArenaSize = 149680;
 #endif
 
 #if defined(EI_CLASSIFIER_ALLOCATION_STATIC)
-uint8_t tensor_arena[kTensorArenaSize] ALIGN(16);
+uint8_t tensor_arena[kTensorArenaSize] ALIGN(16) __attribute__((section(".bss.tensor_arena")));
 #elif defined(EI_CLASSIFIER_ALLOCATION_STATIC_HIMAX)
 #pragma Bss(".tensor_arena")
 uint8_t tensor_arena[kTensorArenaSize] ALIGN(16);
@@ -676,7 +684,8 @@ uint8_t tensor_arena[kTensorArenaSize] ALIGN(16);
 uint8_t tensor_arena[kTensorArenaSize] ALIGN(16) __attribute__((section(".tensor_arena")));
 #else
 #define EI_CLASSIFIER_ALLOCATION_HEAP 1
-uint8_t* tensor_arena = NULL;
+// plain .bss: with -fdata-sections the pointer would otherwise land in .bss.tensor_arena
+uint8_t* tensor_arena __attribute__((section(".bss"))) = NULL;
 #endif
 
 static uint8_t* tensor_boundary;
@@ -843,6 +852,12 @@ static void * AllocatePersistentBufferImpl(struct TfLiteContext* ctx,
       return NULL;
     }
 
+#if defined(EI_CLASSIFIER_ALLOCATION_STATIC)
+    // the arena is placed by the linker, do not fall back to the heap
+    ei_printf("ERR: Failed to allocate persistent buffer of size %d, tensor arena (%d bytes) is too small\n",
+      (int)bytes, (int)kTensorArenaSize);
+    return NULL;
+#else
     // OK, this will look super weird, but.... we have CMSIS-NN buffers which
     // we cannot calculate beforehand easily.
     ptr = ei_calloc(bytes, 1);
@@ -852,6 +867,7 @@ static void * AllocatePersistentBufferImpl(struct TfLiteContext* ctx,
     }
     overflow_buffers[overflow_buffers_ix++] = ptr;
     return ptr;
+#endif
   }
 
   current_location -= bytes;
@@ -0,0 +1,205 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "at_base64_lib.h"
+#include "bench.h"
+
+#include <catch.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/* Plain scalar encoder, one group at a time, that the library has to match.
+ * base64_mve_tests builds the library with BASE64_USE_MVE, on the host with
+ * the intrinsics emulated by mve/arm_mve.h. */
+static std::string reference_base64(const uint8_t *in, size_t len)
+{
+    static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t group = in[i] << 16;
+        if (i + 1 < len) {
+            group |= in[i + 1] << 8;
+        }
+        if (i + 2 < len) {
+            group |= in[i + 2];
+        }
+        out += chars[(group >> 18) & 0x3f];
+        out += chars[(group >> 12) & 0x3f];
+        out += i + 1 < len ? chars[(group >> 6) & 0x3f] : '=';
+        out += i + 2 < len ? chars[group & 0x3f] : '=';
+    }
+    return out;
+}
+
+static std::string putc_output;
+static std::vector<size_t> block_sizes;
+
+static void test_putc(char c)
+{
+    putc_output += c;
+}
+
+static void test_write(const char *data, size_t length)
+{
+    putc_output.append(data, length);
+    block_sizes.push_back(length);
+}
+
+static std::vector<uint8_t> random_bytes(size_t len)
+{
+    std::vector<uint8_t> data(len);
+    for (auto &b : data) {
+        b = (uint8_t)rand();
+    }
+    return data;
+}
+
+/* Checks every entry point against the reference for one input */
+static void check_encoding(const uint8_t *in, size_t len)
+{
+    const std::string expected = reference_base64(in, len);
+    const char *input = reinterpret_cast<const char *>(in);
+
+    REQUIRE(base64_encoded_length(len) == expected.size());
+
+    std::vector<char> buffer(expected.size() + 1, '\0');
+    REQUIRE(base64_encode_buffer(input, len, buffer.data(), expected.size()) == (int)expected.size());
+    REQUIRE(std::string(buffer.data(), expected.size()) == expected);
+    if (len) {
+        REQUIRE(base64_encode_buffer(input, len, buffer.data(), expected.size() - 1) < 0);
+    }
+
+    putc_output.clear();
+    base64_encode(input, len, test_putc);
+    REQUIRE(putc_output == expected);
+
+    putc_output.clear();
+    block_sizes.clear();
+    base64_encode_blocks(input, len, test_write);
+    REQUIRE(putc_output == expected);
+    for (size_t i = 0; i + 1 < block_sizes.size(); i++) {
+        REQUIRE(block_sizes[i] == block_sizes[0]);
+        REQUIRE(block_sizes[i] % 64 == 0);
+    }
+}
+
+TEST_CASE("Base64 encoding", "[base64]")
+{
+    SECTION("RFC 4648 test vectors")
+    {
+        const char *vectors[][2] = {
+            { "", "" },
+            { "f", "Zg==" },
+            { "fo", "Zm8=" },
+            { "foo", "Zm9v" },
+            { "foob", "Zm9vYg==" },
+            { "fooba", "Zm9vYmE=" },
+            { "foobar", "Zm9vYmFy" },
+        };
+        for (auto &v : vectors) {
+            char out[16] = { 0 };
+            int n = base64_encode_buffer(v[0], strlen(v[0]), out, sizeof(out));
+            REQUIRE(std::string(out, n) == v[1]);
+        }
+    }
+
+    SECTION("Every length up to several vector steps and chunks")
+    {
+        // 48 input bytes per MVE step, 192 per output chunk: covers every
+        // tail of 0, 1 and 2 bytes after each number of whole steps
+        srand(10);
+        const std::vector<uint8_t> data = random_bytes(1024 + 3);
+        for (size_t len = 0; len <= 1024; len++) {
+            check_encoding(data.data(), len);
+        }
+    }
+
+    SECTION("Random lengths and alignments")
+    {
+        srand(11);
+        for (int it = 0; it < 200; it++) {
+            size_t len = rand() % 20000;
+            size_t offset = rand() % 4;
+            const std::vector<uint8_t> data = random_bytes(len + offset);
+            check_encoding(data.data() + offset, len);
+        }
+    }
+
+    SECTION("All byte values")
+    {
+        std::vector<uint8_t> data(3 * 256);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = (uint8_t)(i * 7 + i / 256);
+        }
+        check_encoding(data.data(), data.size());
+    }
+}
+
+static void discard_block(const char *data, size_t length)
+{
+}
+
+TEST_CASE("Base64 encoding benchmark", "[base64][benchmark]")
+{
+    const size_t len = 48 * 1024;
+    const int repeats = 20;
+    srand(12);
+    const std::vector<uint8_t> data = random_bytes(len);
+    const char *input = reinterpret_cast<const char *>(data.data());
+    std::vector<char> out(base64_encoded_length(len));
+
+    uint64_t start = bench_count();
+    for (int i = 0; i < repeats; i++) {
+        REQUIRE(base64_encode_buffer(input, len, out.data(), out.size()) == (int)out.size());
+    }
+    uint64_t buffer_count = bench_count() - start;
+
+    start = bench_count();
+    for (int i = 0; i < repeats; i++) {
+        base64_encode_blocks(input, len, discard_block);
+    }
+    uint64_t blocks_count = bench_count() - start;
+
+#if BASE64_USE_MVE && !(__ARM_FEATURE_MVE & 1)
+    const char *path = "emulated MVE";
+#else
+    const char *path = BASE64_USE_MVE ? "MVE" : "scalar";
+#endif
+    printf("base64_encode_buffer: %.2f " BENCH_UNIT " per byte (%s)\n", (double)buffer_count / (len * repeats), path);
+    printf("base64_encode_blocks: %.2f " BENCH_UNIT " per byte (%s)\n", (double)blocks_count / (len * repeats), path);
+}
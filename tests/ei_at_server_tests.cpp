@@ -0,0 +1,370 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ei_at_server.h"
+#include "ei_at_history.h"
+#include "ei_at_parser.h"
+#include "ei_line_buffer.h"
+#include "test_porting.h"
+
+#include <catch.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/* What the handlers below were last called with */
+static int run_count;
+static int read_count;
+static std::vector<std::string> write_args;
+static ATServer *running_server;
+static const char *typed_while_running;
+
+static bool test_run(void)
+{
+    run_count++;
+    return true;
+}
+
+static bool test_read(void)
+{
+    read_count++;
+    return true;
+}
+
+static bool test_write(const char **argv, const int argc)
+{
+    write_args.assign(argv, argv + argc);
+    return true;
+}
+
+/* A long running command, receiving input as ei_user_invoke_stop_lib feeds it */
+static bool test_long_run(void)
+{
+    for (const char *c = typed_while_running; *c; c++) {
+        running_server->handle(*c);
+    }
+    return true;
+}
+
+static void type(ATServer *server, const char *text)
+{
+    for (const char *c = text; *c; c++) {
+        server->handle(*c);
+    }
+}
+
+static ATServer *new_server(void)
+{
+    run_count = 0;
+    read_count = 0;
+    write_args.clear();
+    test_output_clear();
+
+    ATServer *server = ATServer::get_instance();
+    REQUIRE(server->register_command("CONFIG", "Configure", test_run, test_read, test_write, "A,B"));
+    REQUIRE(server->register_command("RUN", "Run", test_long_run, nullptr, nullptr, nullptr));
+    REQUIRE(server->register_command("SET", "Set", nullptr, test_read, test_write, "X"));
+    return server;
+}
+
+TEST_CASE("AT parser", "[at]")
+{
+    ATParser parser;
+
+    SECTION("Command types")
+    {
+        char run[] = "AT+RUN";
+        const ATParseResult_t &res_run = parser.parse(run);
+        REQUIRE(res_run.type == AT_RUN);
+        REQUIRE(std::string(res_run.command) == "RUN");
+
+        char read[] = "AT+CONFIG?";
+        const ATParseResult_t &res = parser.parse(read);
+        REQUIRE(res.type == AT_READ);
+        REQUIRE(std::string(res.command) == "CONFIG");
+
+        char not_at[] = "ATI";
+        REQUIRE(parser.parse(not_at).type == AT_UNKNOWN);
+
+        char blank[] = "   ";
+        REQUIRE(parser.parse(blank).type == AT_UNKNOWN);
+    }
+
+    SECTION("Arguments and whitespace")
+    {
+        char line[] = "  AT+CONFIG=a,,b \r\n";
+        const ATParseResult_t &res = parser.parse(line);
+        REQUIRE(res.type == AT_WRITE);
+        REQUIRE(std::string(res.command) == "CONFIG");
+        REQUIRE(res.argument_count == 3);
+        REQUIRE(std::string(res.arguments[0]) == "a");
+        REQUIRE(std::string(res.arguments[1]) == "");
+        REQUIRE(std::string(res.arguments[2]) == "b");
+
+        char empty[] = "AT+X=";
+        const ATParseResult_t &res_empty = parser.parse(empty);
+        REQUIRE(res_empty.type == AT_WRITE);
+        REQUIRE(res_empty.argument_count == 1);
+        REQUIRE(res_empty.arguments[0][0] == '\0');
+    }
+
+    SECTION("Argument limit")
+    {
+        std::string line = "AT+X=0";
+        for (int i = 1; i < AT_MAX_ARGUMENTS; i++) {
+            line += "," + std::to_string(i);
+        }
+        std::vector<char> most(line.begin(), line.end());
+        most.push_back('\0');
+        REQUIRE(parser.parse(most.data()).argument_count == AT_MAX_ARGUMENTS);
+
+        line += ",x";
+        std::vector<char> over(line.begin(), line.end());
+        over.push_back('\0');
+        REQUIRE(parser.parse(over.data()).type == AT_UNKNOWN);
+    }
+
+    SECTION("Quoted arguments")
+    {
+        char line[] = "AT+WIFI=\"my, network\",\"\",plain";
+        const ATParseResult_t &res = parser.parse(line);
+        REQUIRE(res.type == AT_WRITE);
+        REQUIRE(res.argument_count == 3);
+        REQUIRE(std::string(res.arguments[0]) == "my, network");
+        REQUIRE(std::string(res.arguments[1]) == "");
+        REQUIRE(std::string(res.arguments[2]) == "plain");
+
+        // a quote inside an argument is just a character
+        char inner[] = "AT+X=a\"b,c";
+        const ATParseResult_t &res_inner = parser.parse(inner);
+        REQUIRE(res_inner.argument_count == 2);
+        REQUIRE(std::string(res_inner.arguments[0]) == "a\"b");
+
+        char unclosed[] = "AT+X=\"a,b";
+        REQUIRE(parser.parse(unclosed).type == AT_UNKNOWN);
+
+        char trailing[] = "AT+X=\"a\"b,c";
+        REQUIRE(parser.parse(trailing).type == AT_UNKNOWN);
+    }
+}
+
+TEST_CASE("AT line buffer", "[at]")
+{
+    LineBuffer buffer;
+
+    SECTION("Editing")
+    {
+        buffer.add("helo");
+        REQUIRE(std::string(buffer.get_string()) == "helo");
+        REQUIRE(buffer.is_at_end());
+
+        buffer.set_position(3);
+        REQUIRE(buffer.add('l'));
+        REQUIRE(std::string(buffer.get_string()) == "hello");
+        REQUIRE(buffer.get_position() == 4);
+
+        REQUIRE(buffer.do_backspace());
+        REQUIRE(std::string(buffer.get_string()) == "helo");
+        REQUIRE(buffer.do_delete());
+        REQUIRE(std::string(buffer.get_string()) == "hel");
+        REQUIRE_FALSE(buffer.do_delete());
+
+        buffer.set_position(-5);
+        REQUIRE(buffer.is_at_begin());
+        REQUIRE_FALSE(buffer.do_backspace());
+        buffer.set_position(100);
+        REQUIRE(buffer.get_position() == buffer.size());
+
+        buffer.clear();
+        REQUIRE(buffer.is_empty());
+        REQUIRE(buffer.get_string()[0] == '\0');
+    }
+
+    SECTION("Full")
+    {
+        for (int i = 0; i < AT_LINE_BUFFER_SIZE; i++) {
+            REQUIRE(buffer.add('x'));
+        }
+        REQUIRE(buffer.is_full());
+        REQUIRE_FALSE(buffer.add('y'));
+        REQUIRE(strlen(buffer.get_string()) == AT_LINE_BUFFER_SIZE);
+    }
+}
+
+TEST_CASE("AT history", "[at]")
+{
+    SECTION("Navigation")
+    {
+        ATHistory history(3);
+        REQUIRE(std::string(history.go_back()) == "");
+
+        history.add("one");
+        history.add("");
+        history.add("two");
+        REQUIRE(history.is_at_end());
+        REQUIRE(std::string(history.go_back()) == "two");
+        REQUIRE(std::string(history.go_back()) == "one");
+        REQUIRE(history.is_at_begin());
+        REQUIRE(std::string(history.go_back()) == "one");
+        REQUIRE(std::string(history.go_next()) == "two");
+        REQUIRE(std::string(history.go_next()) == "");
+        REQUIRE(history.is_at_end());
+    }
+
+    SECTION("Oldest entries are dropped")
+    {
+        ATHistory history(3);
+        history.add("1");
+        history.add("2");
+        history.add("3");
+        history.add("4");
+        REQUIRE(std::string(history.go_back()) == "4");
+        REQUIRE(std::string(history.go_back()) == "3");
+        REQUIRE(std::string(history.go_back()) == "2");
+        REQUIRE(std::string(history.go_back()) == "2");
+    }
+
+    SECTION("Size limits")
+    {
+        ATHistory none(0);
+        none.add("x");
+        REQUIRE(std::string(none.go_back()) == "");
+
+        ATHistory big(AT_HISTORY_MAX_SIZE + 5);
+        for (int i = 0; i < AT_HISTORY_MAX_SIZE + 5; i++) {
+            big.add(std::to_string(i).c_str());
+        }
+        int entries = 0;
+        while (!big.is_at_begin()) {
+            big.go_back();
+            entries++;
+        }
+        REQUIRE(entries == AT_HISTORY_MAX_SIZE);
+    }
+}
+
+TEST_CASE("AT server", "[at]")
+{
+    ATServer *server = new_server();
+
+    SECTION("Handlers")
+    {
+        type(server, "AT+CONFIG=\"a,b\",c\r");
+        REQUIRE(write_args == std::vector<std::string>{"a,b", "c"});
+
+        type(server, "AT+CONFIG?\rAT+CONFIG\n\r");
+        REQUIRE(read_count == 1);
+        REQUIRE(run_count == 1);
+
+        type(server, "AT+NOPE\r");
+        REQUIRE(test_output().find("Command not found! (AT+NOPE)") != std::string::npos);
+
+        type(server, "AT+HELP\r");
+        REQUIRE(test_output().find("AT+CONFIG=A,B") != std::string::npos);
+        REQUIRE_FALSE(server->register_command("HELP", "", test_run, nullptr, nullptr, nullptr));
+    }
+
+    SECTION("Line editing and history")
+    {
+        // backspace, then left arrow and insert
+        type(server, "AT+CONFIG=ac\x7f" "c\x1b[D" "b\r");
+        REQUIRE(write_args == std::vector<std::string>{"abc"});
+
+        write_args.clear();
+        type(server, "\x1b[A\r");
+        REQUIRE(write_args == std::vector<std::string>{"abc"});
+
+        // HOME, then DELETE of the 'A' turns the line into an invalid one
+        type(server, "AT+CONFIG?\x1b[H\x1b[3~\r");
+        REQUIRE(read_count == 0);
+        REQUIRE(test_output().find("Not a valid AT command (T+CONFIG?)") != std::string::npos);
+    }
+
+    SECTION("Overlong line")
+    {
+        type(server, "AT+CONFIG=");
+        for (int i = 0; i < 2 * AT_LINE_BUFFER_SIZE; i++) {
+            server->handle('x');
+        }
+        server->handle('\r');
+        REQUIRE(write_args.size() == 1);
+        REQUIRE(write_args[0].size() == AT_LINE_BUFFER_SIZE - strlen("AT+CONFIG="));
+    }
+
+    SECTION("Input while a command runs")
+    {
+        running_server = server;
+        REQUIRE(server->set_async("SET", true));
+        REQUIRE_FALSE(server->set_async("MISSING", true));
+
+        typed_while_running = "AT+SET=0.5\nAT+CONFIG?\r";
+        type(server, "AT+RUN\r");
+        REQUIRE(write_args == std::vector<std::string>{"0.5"});
+        REQUIRE(read_count == 0);
+        REQUIRE(test_output().find("ERR: AT+CONFIG can't run while a command is executing") != std::string::npos);
+        REQUIRE_FALSE(server->take_stop_request());
+
+        typed_while_running = "b\r";
+        type(server, "AT+RUN\r");
+        REQUIRE(server->take_stop_request());
+        REQUIRE_FALSE(server->take_stop_request());
+
+        // a 'b' inside a line is not a stop
+        typed_while_running = "AT+SET=abc\r";
+        type(server, "AT+RUN\r");
+        REQUIRE_FALSE(server->take_stop_request());
+        REQUIRE(write_args == std::vector<std::string>{"abc"});
+    }
+}
+
+TEST_CASE("AT fuzz entry point", "[at]")
+{
+    // a short run over random input, the libFuzzer build goes further
+    static const char alphabet[] = "AT+CONFIGSET=?,\"\r\n \t\x1b[ABCDFH3~\x7f\x08" "bxyz";
+    uint8_t data[AT_LINE_BUFFER_SIZE + 64];
+
+    srand(1);
+    for (int it = 0; it < 20000; it++) {
+        size_t size = rand() % sizeof(data);
+        for (size_t i = 0; i < size; i++) {
+            data[i] = (rand() % 8) ? alphabet[rand() % (sizeof(alphabet) - 1)] : (uint8_t)rand();
+        }
+        REQUIRE(LLVMFuzzerTestOneInput(data, size) == 0);
+        test_output_clear();
+    }
+}
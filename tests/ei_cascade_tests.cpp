@@ -0,0 +1,364 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ei_cascade_lib.h"
+#include "test_porting.h"
+
+#include <catch.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Sends the message the way the MHU carries it: as bytes in the platform's
+ * payload (a 16 bit id followed by 64 bytes), read back on the other core */
+static ei_cascade_msg_t through_payload(const ei_cascade_msg_t &msg)
+{
+    uint8_t payload[2 + 64];
+    ei_cascade_msg_t received;
+
+    static_assert(sizeof(ei_cascade_msg_t) <= sizeof(payload), "cascade messages must fit the MHU payload");
+    memset(payload, 0xa5, sizeof(payload));
+    memcpy(payload, &msg, sizeof(msg));
+    memcpy(&received, payload, sizeof(received));
+    return received;
+}
+
+TEST_CASE("Cascade messages", "[cascade]")
+{
+    ei_cascade_msg_t msg;
+
+    SECTION("Round trip")
+    {
+        ei_cascade_msg_init(&msg, EI_CASCADE_MSG_RESULT, 200, "person", 0.75f);
+        const ei_cascade_msg_t received = through_payload(msg);
+
+        REQUIRE(ei_cascade_msg_valid(&received));
+        REQUIRE(received.id == EI_CASCADE_MSG_ID);
+        REQUIRE(received.type == EI_CASCADE_MSG_RESULT);
+        REQUIRE(received.seq == 200);
+        REQUIRE(received.confidence == 0.75f);
+        REQUIRE(std::string(received.label) == "person");
+    }
+
+    SECTION("Long labels are truncated and stay terminated")
+    {
+        const std::string label(100, 'x');
+        ei_cascade_msg_init(&msg, EI_CASCADE_MSG_WAKE, 1, label.c_str(), 1.0f);
+        const ei_cascade_msg_t received = through_payload(msg);
+
+        REQUIRE(ei_cascade_msg_valid(&received));
+        REQUIRE(std::string(received.label) == label.substr(0, EI_CASCADE_LABEL_LEN - 1));
+    }
+
+    SECTION("An error has no label")
+    {
+        ei_cascade_msg_init(&msg, EI_CASCADE_MSG_ERROR, 3, nullptr, 0.0f);
+        REQUIRE(ei_cascade_msg_valid(&msg));
+        REQUIRE(msg.label[0] == '\0');
+    }
+
+    SECTION("Rejects other payloads and corrupt messages")
+    {
+        ei_cascade_msg_init(&msg, EI_CASCADE_MSG_WAKE, 1, "yes", 0.9f);
+        REQUIRE(ei_cascade_msg_valid(&msg));
+
+        ei_cascade_msg_t bad = msg;
+        bad.id = 0x0001;
+        REQUIRE_FALSE(ei_cascade_msg_valid(&bad));
+
+        for (uint8_t type : { 0, 4, 255 }) {
+            bad = msg;
+            bad.type = type;
+            REQUIRE_FALSE(ei_cascade_msg_valid(&bad));
+        }
+
+        bad = msg;
+        memset(bad.label, 'x', sizeof(bad.label));
+        REQUIRE_FALSE(ei_cascade_msg_valid(&bad));
+
+        for (float confidence : { -0.1f, 1.1f, NAN, INFINITY }) {
+            bad = msg;
+            bad.confidence = confidence;
+            REQUIRE_FALSE(ei_cascade_msg_valid(&bad));
+        }
+    }
+}
+
+TEST_CASE("Cascade waker", "[cascade]")
+{
+    ei_cascade_waker_t waker;
+    ei_cascade_msg_t msg;
+    ei_cascade_msg_t reply;
+
+    SECTION("Wakes on the wake label over the threshold")
+    {
+        ei_cascade_waker_init(&waker, "yes", 0.8f, 3000);
+
+        REQUIRE_FALSE(ei_cascade_waker_detect(&waker, "no", 0.99f, 0, &msg));
+        REQUIRE_FALSE(ei_cascade_waker_detect(&waker, "yes", 0.79f, 10, &msg));
+        REQUIRE_FALSE(ei_cascade_waker_detect(&waker, nullptr, 0.0f, 20, &msg));
+        REQUIRE(waker.state == EI_CASCADE_LISTENING);
+
+        REQUIRE(ei_cascade_waker_detect(&waker, "yes", 0.8f, 30, &msg));
+        REQUIRE(waker.state == EI_CASCADE_WAITING);
+        REQUIRE(waker.wakes == 1);
+        REQUIRE(ei_cascade_msg_valid(&msg));
+        REQUIRE(msg.type == EI_CASCADE_MSG_WAKE);
+        REQUIRE(msg.seq == 1);
+        REQUIRE(std::string(msg.label) == "yes");
+        REQUIRE(msg.confidence == 0.8f);
+
+        // detections while HP runs are ignored
+        REQUIRE_FALSE(ei_cascade_waker_detect(&waker, "yes", 0.99f, 40, &msg));
+        REQUIRE(waker.wakes == 1);
+    }
+
+    SECTION("VAD: one wake per sound, rearmed once the level drops")
+    {
+        ei_cascade_waker_init(&waker, nullptr, EI_CASCADE_VAD_THRESHOLD, 3000);
+        const float levels[] = { 0.01f, 0.2f, 0.3f, 0.2f, 0.1f, 0.04f, 0.02f, 0.06f };
+        const bool wakes[] = { false, true, false, false, false, false, false, true };
+
+        uint64_t now_ms = 0;
+        for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+            INFO("slice " << i);
+            REQUIRE(ei_cascade_waker_detect(&waker, "sound", levels[i], now_ms, &msg) == wakes[i]);
+
+            // HP answers quickly, well within the sound
+            if (waker.state == EI_CASCADE_WAITING) {
+                ei_cascade_msg_init(&reply, EI_CASCADE_MSG_RESULT, msg.seq, "person", 0.6f);
+                REQUIRE(ei_cascade_waker_receive(&waker, &reply));
+                REQUIRE(waker.state == EI_CASCADE_REARMING);
+            }
+            now_ms += 250;
+        }
+        REQUIRE(waker.wakes == 2);
+        REQUIRE(waker.results == 2);
+        REQUIRE(waker.timeouts == 0);
+    }
+
+    SECTION("Matches answers to the outstanding wake")
+    {
+        ei_cascade_waker_init(&waker, nullptr, 0.5f, 3000);
+        REQUIRE(ei_cascade_waker_detect(&waker, "sound", 0.9f, 0, &msg));
+
+        ei_cascade_msg_init(&reply, EI_CASCADE_MSG_RESULT, msg.seq + 1, "person", 0.6f);
+        REQUIRE_FALSE(ei_cascade_waker_receive(&waker, &reply));
+        ei_cascade_msg_init(&reply, EI_CASCADE_MSG_WAKE, msg.seq, "person", 0.6f);
+        REQUIRE_FALSE(ei_cascade_waker_receive(&waker, &reply));
+        REQUIRE(waker.state == EI_CASCADE_WAITING);
+
+        // an error answers the wake as well
+        ei_cascade_msg_init(&reply, EI_CASCADE_MSG_ERROR, msg.seq, nullptr, 0.0f);
+        REQUIRE(ei_cascade_waker_receive(&waker, &reply));
+        REQUIRE(waker.results == 1);
+
+        // a duplicate is not a second answer
+        REQUIRE_FALSE(ei_cascade_waker_receive(&waker, &reply));
+        REQUIRE(waker.results == 1);
+    }
+
+    SECTION("Times out, and ignores the late answer")
+    {
+        ei_cascade_waker_init(&waker, "yes", 0.8f, 100);
+        REQUIRE_FALSE(ei_cascade_waker_poll(&waker, 1000));
+
+        REQUIRE(ei_cascade_waker_detect(&waker, "yes", 0.9f, 1000, &msg));
+        const uint8_t timed_out_seq = msg.seq;
+        REQUIRE_FALSE(ei_cascade_waker_poll(&waker, 1099));
+        REQUIRE(ei_cascade_waker_poll(&waker, 1100));
+        REQUIRE(waker.timeouts == 1);
+        REQUIRE(waker.state == EI_CASCADE_REARMING);
+        REQUIRE_FALSE(ei_cascade_waker_poll(&waker, 5000));
+        REQUIRE(waker.timeouts == 1);
+
+        // the word has to end before the next wake
+        REQUIRE_FALSE(ei_cascade_waker_detect(&waker, "yes", 0.9f, 1200, &msg));
+        REQUIRE_FALSE(ei_cascade_waker_detect(&waker, "no", 0.9f, 1300, &msg));
+        REQUIRE(ei_cascade_waker_detect(&waker, "yes", 0.9f, 1400, &msg));
+        REQUIRE(msg.seq != timed_out_seq);
+
+        ei_cascade_msg_init(&reply, EI_CASCADE_MSG_RESULT, timed_out_seq, "person", 0.6f);
+        REQUIRE_FALSE(ei_cascade_waker_receive(&waker, &reply));
+        ei_cascade_msg_init(&reply, EI_CASCADE_MSG_RESULT, msg.seq, "person", 0.6f);
+        REQUIRE(ei_cascade_waker_receive(&waker, &reply));
+    }
+
+    SECTION("Sequence numbers wrap")
+    {
+        ei_cascade_waker_init(&waker, nullptr, 0.5f, 3000);
+        for (int i = 1; i <= 300; i++) {
+            REQUIRE(ei_cascade_waker_detect(&waker, "sound", 0.9f, i * 10, &msg));
+            REQUIRE(msg.seq == (uint8_t)i);
+            ei_cascade_msg_init(&reply, EI_CASCADE_MSG_RESULT, msg.seq, "person", 0.6f);
+            REQUIRE(ei_cascade_waker_receive(&waker, &reply));
+            REQUIRE_FALSE(ei_cascade_waker_detect(&waker, "sound", 0.1f, i * 10 + 5, &msg));
+        }
+    }
+}
+
+TEST_CASE("Cascade worker", "[cascade]")
+{
+    ei_cascade_worker_t worker;
+    ei_cascade_waker_t waker;
+    ei_cascade_msg_t wake;
+    ei_cascade_msg_t reply;
+
+    ei_cascade_worker_init(&worker);
+    ei_cascade_waker_init(&waker, "yes", 0.8f, 3000);
+    REQUIRE(ei_cascade_waker_detect(&waker, "yes", 0.9f, 0, &wake));
+
+    SECTION("Runs once per wake and answers it")
+    {
+        ei_cascade_msg_t received = through_payload(wake);
+        REQUIRE(ei_cascade_worker_receive(&worker, &received));
+        REQUIRE(worker.running);
+        REQUIRE_FALSE(ei_cascade_worker_receive(&worker, &received));
+
+        ei_cascade_worker_done(&worker, true, "person", 0.7f, &reply);
+        REQUIRE_FALSE(worker.running);
+        REQUIRE(worker.runs == 1);
+
+        received = through_payload(reply);
+        REQUIRE(ei_cascade_msg_valid(&received));
+        REQUIRE(received.type == EI_CASCADE_MSG_RESULT);
+        REQUIRE(received.seq == wake.seq);
+        REQUIRE(ei_cascade_waker_receive(&waker, &received));
+    }
+
+    SECTION("A failed run answers with an error")
+    {
+        REQUIRE(ei_cascade_worker_receive(&worker, &wake));
+        ei_cascade_worker_done(&worker, false, "person", 0.7f, &reply);
+        REQUIRE(ei_cascade_msg_valid(&reply));
+        REQUIRE(reply.type == EI_CASCADE_MSG_ERROR);
+        REQUIRE(reply.seq == wake.seq);
+        REQUIRE(ei_cascade_waker_receive(&waker, &reply));
+    }
+
+    SECTION("Only wakes start a run")
+    {
+        ei_cascade_msg_init(&reply, EI_CASCADE_MSG_RESULT, 1, "person", 0.7f);
+        REQUIRE_FALSE(ei_cascade_worker_receive(&worker, &reply));
+        REQUIRE_FALSE(worker.running);
+    }
+}
+
+TEST_CASE("Cascade top result", "[cascade]")
+{
+    ei_impulse_result_t result = {};
+    const char *label;
+    float confidence;
+
+#if EI_CLASSIFIER_OBJECT_DETECTION == 1
+    ei_impulse_result_bounding_box_t boxes[3] = {};
+    boxes[0].label = "cup";
+    boxes[0].value = 0.6f;
+    boxes[1].label = "person";
+    boxes[1].value = 0.9f;
+    boxes[2].label = "cup";
+    boxes[2].value = 0.7f;
+
+    REQUIRE_FALSE(ei_cascade_top_result(&result, &label, &confidence));
+    REQUIRE(label == nullptr);
+
+    result.bounding_boxes = boxes;
+    result.bounding_boxes_count = 3;
+    REQUIRE(ei_cascade_top_result(&result, &label, &confidence));
+    REQUIRE(std::string(label) == "person");
+    REQUIRE(confidence == 0.9f);
+#else
+    for (uint32_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        result.classification[ix].label = "other";
+        result.classification[ix].value = 0.1f;
+    }
+    result.classification[EI_CLASSIFIER_LABEL_COUNT - 1].label = "top";
+    result.classification[EI_CLASSIFIER_LABEL_COUNT - 1].value = 0.5f;
+
+    REQUIRE(ei_cascade_top_result(&result, &label, &confidence));
+    REQUIRE(std::string(label) == "top");
+    REQUIRE(confidence == 0.5f);
+#endif
+}
+
+TEST_CASE("Cascade native transport", "[cascade]")
+{
+    // one FIFO as both ends: what we send comes back to us
+    char dir[] = "/tmp/ei_cascade_XXXXXX";
+    REQUIRE(mkdtemp(dir) != nullptr);
+    const std::string fifo = std::string(dir) + "/mhu";
+    REQUIRE(mkfifo(fifo.c_str(), 0600) == 0);
+
+    unsetenv("EI_NATIVE_MHU_RX");
+    unsetenv("EI_NATIVE_MHU_TX");
+    test_output_clear();
+    REQUIRE_FALSE(ei_cascade_transport_init());
+    REQUIRE(test_output().find("EI_NATIVE_MHU_RX") != std::string::npos);
+
+    setenv("EI_NATIVE_MHU_RX", fifo.c_str(), 1);
+    setenv("EI_NATIVE_MHU_TX", fifo.c_str(), 1);
+    REQUIRE(ei_cascade_transport_init());
+
+    ei_cascade_msg_t msg;
+    ei_cascade_msg_t received;
+    REQUIRE_FALSE(ei_cascade_transport_receive(&received));
+
+    ei_cascade_msg_init(&msg, EI_CASCADE_MSG_WAKE, 7, "yes", 0.9f);
+    REQUIRE(ei_cascade_transport_send(&msg));
+    ei_cascade_msg_init(&msg, EI_CASCADE_MSG_RESULT, 7, "person", 0.6f);
+    REQUIRE(ei_cascade_transport_send(&msg));
+
+    // corrupt messages are dropped
+    msg.confidence = 2.0f;
+    REQUIRE(ei_cascade_transport_send(&msg));
+
+    ei_cascade_transport_wait(1000);
+    REQUIRE(ei_cascade_transport_receive(&received));
+    REQUIRE(received.type == EI_CASCADE_MSG_WAKE);
+    REQUIRE(std::string(received.label) == "yes");
+    REQUIRE(ei_cascade_transport_receive(&received));
+    REQUIRE(received.type == EI_CASCADE_MSG_RESULT);
+    REQUIRE(received.seq == 7);
+    REQUIRE(std::string(received.label) == "person");
+    REQUIRE(received.confidence == 0.6f);
+    REQUIRE_FALSE(ei_cascade_transport_receive(&received));
+    REQUIRE_FALSE(ei_cascade_transport_receive(&received));
+
+    ei_cascade_transport_deinit();
+    unlink(fifo.c_str());
+    rmdir(dir);
+}
@@ -0,0 +1,304 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "at_frame_lib.h"
+#include "at_base64_lib.h"
+#include "test_porting.h"
+
+#include <algorithm>
+#include <catch.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/* Bit at a time CRC-32 (IEEE 802.3), that the nibble table has to match */
+static uint32_t reference_crc32(const uint8_t *data, size_t length)
+{
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (crc & 1 ? 0xedb88320 : 0);
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t read_le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+struct frame_t {
+    uint8_t type;
+    uint8_t flags;
+    std::vector<uint8_t> payload;
+};
+
+/* Splits the output back into frames, checking the layout and CRC of each */
+static std::vector<frame_t> parse_frames(const std::string &output)
+{
+    std::vector<frame_t> frames;
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(output.data());
+    const uint8_t *end = p + output.size();
+
+    while (p < end) {
+        REQUIRE(end - p >= EI_FRAME_HEADER_SIZE + EI_FRAME_TRAILER_SIZE);
+        REQUIRE(p[0] == EI_FRAME_MAGIC_0);
+        REQUIRE(p[1] == EI_FRAME_MAGIC_1);
+
+        const uint32_t length = read_le32(&p[4]);
+        REQUIRE((size_t)(end - p) >= EI_FRAME_HEADER_SIZE + length + EI_FRAME_TRAILER_SIZE);
+
+        // the CRC covers type, flags, length and payload
+        const uint8_t *trailer = p + EI_FRAME_HEADER_SIZE + length;
+        REQUIRE(read_le32(trailer) == reference_crc32(&p[2], EI_FRAME_HEADER_SIZE - 2 + length));
+
+        frames.push_back({ p[2], p[3], std::vector<uint8_t>(p + EI_FRAME_HEADER_SIZE, trailer) });
+        p = trailer + EI_FRAME_TRAILER_SIZE;
+    }
+    return frames;
+}
+
+static std::vector<uint8_t> random_bytes(size_t len)
+{
+    std::vector<uint8_t> data(len);
+    for (auto &b : data) {
+        b = (uint8_t)rand();
+    }
+    return data;
+}
+
+/* Base64 goes to stdout, so point it at a temporary file while fn runs */
+template <typename F>
+static std::string capture_stdout(F fn)
+{
+    fflush(stdout);
+    FILE *tmp = tmpfile();
+    REQUIRE(tmp != nullptr);
+    const int saved = dup(fileno(stdout));
+    dup2(fileno(tmp), fileno(stdout));
+
+    fn();
+
+    fflush(stdout);
+    dup2(saved, fileno(stdout));
+    close(saved);
+
+    std::string out;
+    char buf[4096];
+    size_t n;
+    rewind(tmp);
+    while ((n = fread(buf, 1, sizeof(buf), tmp)) > 0) {
+        out.append(buf, n);
+    }
+    fclose(tmp);
+    return out;
+}
+
+static std::string base64_output;
+
+static void base64_putc(char c)
+{
+    base64_output += c;
+}
+
+static std::string one_shot_base64(const std::vector<uint8_t> &data)
+{
+    base64_output.clear();
+    base64_encode(reinterpret_cast<const char *>(data.data()), data.size(), base64_putc);
+    return base64_output;
+}
+
+/* Streams data in pieces of the given sizes, repeated until it is all written */
+static void stream(ei_frame_type_t type, const std::vector<uint8_t> &data, const std::vector<size_t> &pieces)
+{
+    ei_transport_stream_begin(type);
+    size_t i = 0;
+    for (size_t p = 0; i < data.size(); p = (p + 1) % pieces.size()) {
+        const size_t n = std::min(pieces[p], data.size() - i);
+        ei_transport_stream_write(&data[i], n);
+        i += n;
+    }
+    ei_transport_stream_end();
+}
+
+TEST_CASE("Frame CRC-32", "[frame]")
+{
+    const uint8_t check[] = "123456789";
+
+    SECTION("Check value")
+    {
+        REQUIRE(ei_crc32_update(0, check, 9) == 0xCBF43926);
+        REQUIRE(ei_crc32_update(0, check, 0) == 0);
+    }
+
+    SECTION("Updates in pieces match one pass")
+    {
+        for (size_t split = 0; split <= 9; split++) {
+            uint32_t crc = ei_crc32_update(0, check, split);
+            REQUIRE(ei_crc32_update(crc, check + split, 9 - split) == 0xCBF43926);
+        }
+    }
+
+    SECTION("Every byte value")
+    {
+        srand(20);
+        const std::vector<uint8_t> data = random_bytes(4096);
+        for (size_t len : { 1, 2, 255, 256, 4096 }) {
+            REQUIRE(ei_crc32_update(0, data.data(), len) == reference_crc32(data.data(), len));
+        }
+    }
+}
+
+TEST_CASE("Frame layout", "[frame]")
+{
+    // the default ei_transport_send_async writes through ei_putchar
+    srand(21);
+
+    SECTION("Header, payload and trailer of a round trip")
+    {
+        const uint8_t payload[] = { 0x00, 0xA5, 0x5A, 0xFF, 0x10 };
+        test_output_clear();
+        ei_frame_send(EI_FRAME_JPEG, payload, sizeof(payload));
+
+        const std::string &out = test_output();
+        REQUIRE(out.size() == EI_FRAME_HEADER_SIZE + sizeof(payload) + EI_FRAME_TRAILER_SIZE);
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(out.data());
+        const uint8_t header[EI_FRAME_HEADER_SIZE] = { 0xA5, 0x5A, EI_FRAME_JPEG, 0, sizeof(payload), 0, 0, 0 };
+        REQUIRE(memcmp(p, header, sizeof(header)) == 0);
+        REQUIRE(memcmp(p + EI_FRAME_HEADER_SIZE, payload, sizeof(payload)) == 0);
+        REQUIRE(read_le32(p + EI_FRAME_HEADER_SIZE + sizeof(payload)) ==
+                reference_crc32(p + 2, EI_FRAME_HEADER_SIZE - 2 + sizeof(payload)));
+    }
+
+    SECTION("Lengths around the staging block size")
+    {
+        for (size_t len : { 0, 1, 499, 500, 501, 511, 512, 513, 1024, 5000, 70000 }) {
+            const std::vector<uint8_t> data = random_bytes(len);
+            test_output_clear();
+            ei_frame_send(EI_FRAME_SAMPLE_BUFFER, data.data(), len);
+
+            const std::vector<frame_t> frames = parse_frames(test_output());
+            REQUIRE(frames.size() == 1);
+            REQUIRE(frames[0].type == EI_FRAME_SAMPLE_BUFFER);
+            REQUIRE(frames[0].flags == 0);
+            REQUIRE(frames[0].payload == data);
+        }
+    }
+
+    SECTION("Written in pieces, the same bytes as in one go")
+    {
+        const std::vector<uint8_t> data = random_bytes(3000);
+        test_output_clear();
+        ei_frame_send(EI_FRAME_SNAPSHOT_RGB888, data.data(), data.size());
+        const std::string expected = test_output();
+
+        for (size_t piece : { 1, 7, 512, 1000 }) {
+            test_output_clear();
+            ei_frame_begin(EI_FRAME_SNAPSHOT_RGB888, data.size());
+            for (size_t i = 0; i < data.size(); i += piece) {
+                ei_frame_write(&data[i], std::min(piece, data.size() - i));
+            }
+            ei_frame_end();
+            REQUIRE(test_output() == expected);
+        }
+    }
+
+    SECTION("Binary transport sends one frame")
+    {
+        const std::vector<uint8_t> data = random_bytes(777);
+        ei_transport_set_mode(EI_TRANSPORT_BINARY);
+        test_output_clear();
+        ei_transport_send(EI_FRAME_SAMPLE_BUFFER, data.data(), data.size());
+        ei_transport_set_mode(EI_TRANSPORT_BASE64);
+
+        const std::vector<frame_t> frames = parse_frames(test_output());
+        REQUIRE(frames.size() == 1);
+        REQUIRE(frames[0].type == EI_FRAME_SAMPLE_BUFFER);
+        REQUIRE(frames[0].payload == data);
+    }
+}
+
+TEST_CASE("Transport streams", "[frame]")
+{
+    srand(22);
+    const std::vector<size_t> lengths = { 0, 1, 2, 3, 4, 5, 97, 1000, 1021, 4099 };
+    const std::vector<std::vector<size_t>> chunkings = {
+        { 1 }, { 2 }, { 3 }, { 5 }, { 7 }, { 13 }, { 31 }, { 509 }, { 1, 0, 2, 3, 11, 0, 4 },
+    };
+
+    SECTION("Base64 in any chunking is the one-shot encoding")
+    {
+        REQUIRE(ei_transport_get_mode() == EI_TRANSPORT_BASE64);
+        for (size_t len : lengths) {
+            const std::vector<uint8_t> data = random_bytes(len);
+            const std::string expected = one_shot_base64(data);
+            for (const auto &pieces : chunkings) {
+                INFO("length " << len << ", first piece " << pieces[0]);
+                REQUIRE(capture_stdout([&] { stream(EI_FRAME_JPEG, data, pieces); }) == expected);
+            }
+        }
+    }
+
+    SECTION("Binary MORE frames reassemble")
+    {
+        ei_transport_set_mode(EI_TRANSPORT_BINARY);
+        for (size_t len : lengths) {
+            const std::vector<uint8_t> data = random_bytes(len);
+            for (const auto &pieces : chunkings) {
+                INFO("length " << len << ", first piece " << pieces[0]);
+                test_output_clear();
+                stream(EI_FRAME_JPEG, data, pieces);
+                const std::vector<frame_t> frames = parse_frames(test_output());
+
+                // one frame per non-empty write, then an empty closing frame
+                REQUIRE(!frames.empty());
+                std::vector<uint8_t> joined;
+                for (size_t f = 0; f < frames.size(); f++) {
+                    const bool last = f + 1 == frames.size();
+                    REQUIRE(frames[f].type == EI_FRAME_JPEG);
+                    REQUIRE(frames[f].flags == (last ? 0 : EI_FRAME_FLAG_MORE));
+                    REQUIRE(frames[f].payload.empty() == last);
+                    joined.insert(joined.end(), frames[f].payload.begin(), frames[f].payload.end());
+                }
+                REQUIRE(joined == data);
+            }
+        }
+        ei_transport_set_mode(EI_TRANSPORT_BASE64);
+    }
+}
@@ -0,0 +1,208 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ei_hmac_sha256.h"
+#include "bench.h"
+
+#include <catch.hpp>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static std::vector<uint8_t> from_hex(const char *hex)
+{
+    std::vector<uint8_t> out;
+    for (; hex[0] && hex[1]; hex += 2) {
+        unsigned int byte;
+        sscanf(hex, "%2x", &byte);
+        out.push_back((uint8_t)byte);
+    }
+    return out;
+}
+
+static std::string to_hex(const uint8_t *data, size_t length)
+{
+    std::string out;
+    char byte[3];
+    for (size_t i = 0; i < length; i++) {
+        snprintf(byte, sizeof(byte), "%02x", data[i]);
+        out += byte;
+    }
+    return out;
+}
+
+static std::string hmac_hex(ei_hmac_sha256_ctx_t *ctx, const std::vector<uint8_t> &data, size_t split, size_t truncate)
+{
+    uint8_t mac[EI_SHA256_DIGEST_SIZE];
+    ei_hmac_sha256_update(ctx, data.data(), split);
+    ei_hmac_sha256_update(ctx, data.data() + split, data.size() - split);
+    ei_hmac_sha256_finish(ctx, mac);
+    return to_hex(mac, truncate);
+}
+
+/* RFC 4231 section 4. The MVE message schedule is built with
+ * EI_SHA256_USE_MVE by hmac_mve_tests, on the host with the intrinsics
+ * emulated by mve/arm_mve.h. */
+static const struct {
+    const char *key;
+    const char *data;
+    const char *mac;
+    size_t truncate;
+} rfc4231[] = {
+    // 1
+    { "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+      "4869205468657265",
+      "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7", 32 },
+    // 2: key shorter than the output
+    { "4a656665",
+      "7768617420646f2079612077616e7420666f72206e6f7468696e673f",
+      "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843", 32 },
+    // 3: combined length of key and data larger than 64 bytes
+    { "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+      "dddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddddd"
+      "dddddddddddddddddddddddddddd",
+      "773ea91e36800e46854db8ebd09181a72959098b3ef8c122d9635514ced565fe", 32 },
+    // 4
+    { "0102030405060708090a0b0c0d0e0f10111213141516171819",
+      "cdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcdcd"
+      "cdcdcdcdcdcdcdcdcdcdcdcdcdcd",
+      "82558a389a443c0ea4cc819899f2083a85f0faa3e578f8077a2e3ff46729665b", 32 },
+    // 5: truncated to 128 bits
+    { "0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c",
+      "546573742057697468205472756e636174696f6e",
+      "a3b6167473100ee06e0c796c2955552b", 16 },
+    // 6: key larger than a block, hashed first
+    { "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+      "54657374205573696e67204c6172676572205468616e20426c6f636b2d53697a65204b"
+      "6579202d2048617368204b6579204669727374",
+      "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54", 32 },
+    // 7: key and data larger than a block
+    { "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+      "5468697320697320612074657374207573696e672061206c6172676572207468616e20"
+      "626c6f636b2d73697a65206b657920616e642061206c6172676572207468616e20626c"
+      "6f636b2d73697a6520646174612e20546865206b6579206e6565647320746f20626520"
+      "686173686564206265666f7265206265696e6720757365642062792074686520484d41"
+      "4320616c676f726974686d2e",
+      "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2", 32 },
+};
+
+TEST_CASE("HMAC-SHA256", "[hmac]")
+{
+    SECTION("RFC 4231 test cases 1 to 7")
+    {
+        for (size_t i = 0; i < sizeof(rfc4231) / sizeof(rfc4231[0]); i++) {
+            INFO("test case " << i + 1);
+            const std::vector<uint8_t> key = from_hex(rfc4231[i].key);
+            const std::vector<uint8_t> data = from_hex(rfc4231[i].data);
+            const std::string expected(rfc4231[i].mac);
+
+            ei_hmac_sha256_ctx_t ctx;
+            ei_hmac_sha256_starts(&ctx, key.data(), key.size());
+            REQUIRE(hmac_hex(&ctx, data, data.size(), rfc4231[i].truncate) == expected);
+
+            // any split of the data across updates, then again after a reset
+            for (size_t split = 0; split <= data.size(); split++) {
+                INFO("split at " << split);
+                ei_hmac_sha256_reset(&ctx);
+                REQUIRE(hmac_hex(&ctx, data, split, rfc4231[i].truncate) == expected);
+            }
+        }
+    }
+
+    SECTION("Long message in uneven updates")
+    {
+        // checked with Python's hmac module
+        std::vector<uint8_t> data(100000);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = (uint8_t)(i * 7 + 3);
+        }
+
+        ei_hmac_sha256_ctx_t ctx;
+        ei_hmac_sha256_starts(&ctx, (const uint8_t *)"key", 3);
+        for (size_t offset = 0; offset < data.size(); offset += 333) {
+            size_t n = data.size() - offset < 333 ? data.size() - offset : 333;
+            ei_hmac_sha256_update(&ctx, data.data() + offset, n);
+        }
+        uint8_t mac[EI_SHA256_DIGEST_SIZE];
+        ei_hmac_sha256_finish(&ctx, mac);
+        REQUIRE(to_hex(mac, sizeof(mac)) == "4108686973b4409cfa3e0b8b2435cafa5b64153d3b56c2b5ad5cc0b0d3081416");
+    }
+}
+
+TEST_CASE("HMAC-SHA256 benchmark", "[hmac][benchmark]")
+{
+    const size_t len = 64 * 1024;
+    const int repeats = 20;
+    std::vector<uint8_t> data(len);
+    for (size_t i = 0; i < len; i++) {
+        data[i] = (uint8_t)(i * 13);
+    }
+
+    ei_hmac_sha256_ctx_t ctx;
+    uint8_t mac[EI_SHA256_DIGEST_SIZE];
+    ei_hmac_sha256_starts(&ctx, (const uint8_t *)"key", 3);
+
+    uint64_t start = bench_count();
+    for (int i = 0; i < repeats; i++) {
+        ei_hmac_sha256_reset(&ctx);
+        ei_hmac_sha256_update(&ctx, data.data(), len);
+        ei_hmac_sha256_finish(&ctx, mac);
+    }
+    uint64_t count = bench_count() - start;
+
+    // short messages, where the two extra compressions of HMAC dominate
+    const size_t short_len = 64;
+    const int short_repeats = 2000;
+    start = bench_count();
+    for (int i = 0; i < short_repeats; i++) {
+        ei_hmac_sha256_reset(&ctx);
+        ei_hmac_sha256_update(&ctx, data.data(), short_len);
+        ei_hmac_sha256_finish(&ctx, mac);
+    }
+    uint64_t short_count = bench_count() - start;
+
+#if EI_SHA256_USE_MVE && !(__ARM_FEATURE_MVE & 1)
+    const char *path = "emulated MVE";
+#else
+    const char *path = EI_SHA256_USE_MVE ? "MVE" : "scalar";
+#endif
+    printf("ei_hmac_sha256, 64 KiB: %.2f " BENCH_UNIT " per byte (%s)\n", (double)count / (len * repeats), path);
+    printf("ei_hmac_sha256, 64 B: %.0f " BENCH_UNIT " per message (%s)\n", (double)short_count / short_repeats, path);
+}
@@ -0,0 +1,282 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "firmware-sdk-alif/ei_jpeg_lib.h"
+#include "firmware-sdk-alif/jpeg/JPEGENC.h"
+#include "bench.h"
+
+#include <catch.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/* Stages of jpeg/jpeg.h. The test builds it with JPEG_USE_MVE, so both the
+ * scalar reference and the MVE version of each are linked in: the real
+ * intrinsics on Cortex-M55, the emulation in mve/arm_mve.h on the host. */
+int JPEGEncodeBegin(JPEGIMAGE *pJPEG, JPEGENCODE *pEncode, int iWidth, int iHeight, uint8_t ucPixelType, uint8_t ucSubSample, uint8_t ucQFactor);
+void JPEGFDCT(signed char *pMCUSrc, signed short *pMCUDest);
+void JPEGFDCT_MVE(signed char *pMCUSrc, signed short *pMCUDest);
+int JPEGQuantize(JPEGIMAGE *pJPEG, signed short *pMCUSrc, int iTable);
+int JPEGQuantize_MVE(JPEGIMAGE *pJPEG, signed short *pMCUSrc, int iTable);
+void JPEGSample24(unsigned char *pSrc, signed char *pMCU, int lsize, int cx, int cy);
+void JPEGSample24_MVE(unsigned char *pSrc, signed char *pMCU, int lsize, int cx, int cy);
+void JPEGSubSample24(unsigned char *pSrc, signed char *pLUM, signed char *pCb, signed char *pCr, int lsize, int cx, int cy);
+void JPEGSubSample24_MVE(unsigned char *pSrc, signed char *pLUM, signed char *pCb, signed char *pCr, int lsize, int cx, int cy);
+
+#if __ARM_FEATURE_MVE & 1
+#define MVE_NOTE ""
+#else
+#define MVE_NOTE " (emulated MVE)"
+#endif
+
+#define BLOCK 64
+
+static uint8_t jpeg_out[65536];
+
+/* An encoder with its quantisation tables set up for one quality */
+static void begin_encoder(JPEGIMAGE &image, uint8_t quality)
+{
+    JPEGENCODE encode;
+    memset(&image, 0, sizeof(image));
+    image.pOutput = jpeg_out;
+    image.iBufferSize = sizeof(jpeg_out);
+    image.pHighWater = &jpeg_out[sizeof(jpeg_out) - 512];
+    REQUIRE(JPEGEncodeBegin(&image, &encode, 64, 64, JPEG_PIXEL_RGB888, JPEG_SUBSAMPLE_444, quality) == JPEG_SUCCESS);
+}
+
+/* Random samples, with whole blocks at the extremes mixed in */
+static void random_block(signed char *block, int it)
+{
+    for (int i = 0; i < BLOCK; i++) {
+        switch (it % 5) {
+        case 0:
+            block[i] = (i + it) & 1 ? 127 : -128;
+            break;
+        case 1:
+            block[i] = (signed char)(it & 0xff);
+            break;
+        default:
+            block[i] = (signed char)rand();
+            break;
+        }
+    }
+}
+
+static void random_pixels(std::vector<uint8_t> &pixels, int it)
+{
+    for (auto &p : pixels) {
+        p = (it % 4 == 0) ? ((rand() & 1) ? 0xff : 0) : (uint8_t)rand();
+    }
+}
+
+TEST_CASE("JPEG MVE stages match the scalar code", "[jpeg]")
+{
+    srand(20);
+
+    SECTION("Forward DCT")
+    {
+        for (int it = 0; it < 20000; it++) {
+            signed char block[BLOCK];
+            signed short scalar[BLOCK], mve[BLOCK];
+            random_block(block, it);
+            JPEGFDCT(block, scalar);
+            JPEGFDCT_MVE(block, mve);
+            REQUIRE(memcmp(scalar, mve, sizeof(scalar)) == 0);
+        }
+    }
+
+    SECTION("Quantisation and sparseness")
+    {
+        for (uint8_t quality = JPEG_Q_BEST; quality <= JPEG_Q_LOW; quality++) {
+            JPEGIMAGE image;
+            begin_encoder(image, quality);
+
+            int sparse = 0;
+            for (int it = 0; it < 5000; it++) {
+                signed char block[BLOCK];
+                signed short scalar[BLOCK], mve[BLOCK];
+                random_block(block, it);
+                // smooth blocks, so that some are sparse
+                if (it % 3 == 0) {
+                    for (int i = 0; i < BLOCK; i++) {
+                        block[i] = (signed char)((i / 8 + i % 8) * (it % 7) - 60);
+                    }
+                }
+                JPEGFDCT(block, scalar);
+                memcpy(mve, scalar, sizeof(mve));
+
+                const int table = it & 1;
+                const int scalar_sparse = JPEGQuantize(&image, scalar, table);
+                REQUIRE(JPEGQuantize_MVE(&image, mve, table) == scalar_sparse);
+                REQUIRE(memcmp(scalar, mve, sizeof(scalar)) == 0);
+                sparse += scalar_sparse;
+            }
+            REQUIRE(sparse > 0);
+            REQUIRE(sparse < 5000);
+        }
+    }
+
+    SECTION("4:4:4 colour conversion")
+    {
+        const int pitch = 40 * 3;
+        std::vector<uint8_t> pixels(8 * pitch);
+        for (int it = 0; it < 5000; it++) {
+            random_pixels(pixels, it);
+            // partial blocks take the scalar fallback
+            const int cx = (it % 10) ? 8 : 1 + it % 8;
+            const int cy = (it % 10) ? 8 : 1 + (it / 10) % 8;
+            signed char scalar[3 * BLOCK] = { 0 }, mve[3 * BLOCK] = { 0 };
+            JPEGSample24(pixels.data(), scalar, pitch, cx, cy);
+            JPEGSample24_MVE(pixels.data(), mve, pitch, cx, cy);
+            REQUIRE(memcmp(scalar, mve, sizeof(scalar)) == 0);
+        }
+    }
+
+    SECTION("4:2:0 colour conversion")
+    {
+        const int pitch = 40 * 3;
+        std::vector<uint8_t> pixels(8 * pitch);
+        for (int it = 0; it < 5000; it++) {
+            random_pixels(pixels, it);
+            const int cx = (it % 10) ? 8 : 1 + it % 8;
+            const int cy = (it % 10) ? 8 : 1 + (it / 10) % 8;
+            signed char scalar[3 * BLOCK] = { 0 }, mve[3 * BLOCK] = { 0 };
+            JPEGSubSample24(pixels.data(), scalar, scalar + BLOCK, scalar + 2 * BLOCK, pitch, cx, cy);
+            JPEGSubSample24_MVE(pixels.data(), mve, mve + BLOCK, mve + 2 * BLOCK, pitch, cx, cy);
+            REQUIRE(memcmp(scalar, mve, sizeof(scalar)) == 0);
+        }
+    }
+}
+
+static std::vector<uint8_t> stream;
+
+static void collect(const uint8_t *data, size_t length)
+{
+    stream.insert(stream.end(), data, data + length);
+}
+
+static void discard(const uint8_t *data, size_t length)
+{
+}
+
+static std::vector<uint8_t> test_image(int width, int height)
+{
+    std::vector<uint8_t> rgb(width * height * 3);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t *p = &rgb[(y * width + x) * 3];
+            p[0] = (uint8_t)(x * 255 / width);
+            p[1] = (uint8_t)(y * 255 / height);
+            p[2] = (uint8_t)((x ^ y) * 4 + (rand() & 7));
+        }
+    }
+    return rgb;
+}
+
+TEST_CASE("JPEG encoding", "[jpeg]")
+{
+    srand(21);
+
+    // sizes that are and aren't whole MCUs
+    const int sizes[][2] = { { 96, 96 }, { 100, 70 }, { 7, 9 } };
+    for (auto &size : sizes) {
+        const std::vector<uint8_t> rgb = test_image(size[0], size[1]);
+        for (uint8_t subsample = JPEG_SUBSAMPLE_444; subsample <= JPEG_SUBSAMPLE_420; subsample++) {
+            for (uint8_t quality = JPEG_Q_BEST; quality <= JPEG_Q_LOW; quality++) {
+                REQUIRE(ei_jpeg_set_settings(quality, subsample));
+                ei_jpeg_stats_t stats;
+                stream.clear();
+                REQUIRE(ei_jpeg_encode_rgb888(rgb.data(), size[0], size[1], collect, &stats) == 0);
+                REQUIRE(stats.size == stream.size());
+                REQUIRE(stream.size() > 4);
+                REQUIRE(stream[0] == 0xff);
+                REQUIRE(stream[1] == 0xd8);
+                REQUIRE(stream[stream.size() - 2] == 0xff);
+                REQUIRE(stream[stream.size() - 1] == 0xd9);
+            }
+        }
+    }
+
+    REQUIRE_FALSE(ei_jpeg_set_settings(JPEG_Q_LOW + 1, JPEG_SUBSAMPLE_444));
+    REQUIRE_FALSE(ei_jpeg_set_settings(JPEG_Q_BEST, JPEG_SUBSAMPLE_420 + 1));
+}
+
+TEST_CASE("JPEG encoding benchmark", "[jpeg][benchmark]")
+{
+    const int width = 320, height = 240, repeats = 5;
+    srand(22);
+    const std::vector<uint8_t> rgb = test_image(width, height);
+
+    for (uint8_t subsample = JPEG_SUBSAMPLE_444; subsample <= JPEG_SUBSAMPLE_420; subsample++) {
+        const int mcu_size = subsample == JPEG_SUBSAMPLE_444 ? 8 : 16;
+        const int mcus = ((width + mcu_size - 1) / mcu_size) * ((height + mcu_size - 1) / mcu_size);
+        REQUIRE(ei_jpeg_set_settings(JPEG_Q_HIGH, subsample));
+
+        uint64_t start = bench_count();
+        for (int i = 0; i < repeats; i++) {
+            REQUIRE(ei_jpeg_encode_rgb888(rgb.data(), width, height, discard, nullptr) == 0);
+        }
+        const uint64_t count = bench_count() - start;
+        printf("JPEG %dx%d %s: %.0f " BENCH_UNIT " per MCU" MVE_NOTE "\n", width, height,
+               ei_jpeg_subsample_name(subsample), (double)count / (mcus * repeats));
+    }
+
+    // the stages on their own, scalar and MVE
+    const int blocks = 20000;
+    std::vector<signed char> samples(BLOCK * 64);
+    for (auto &s : samples) {
+        s = (signed char)rand();
+    }
+    signed short coefficients[BLOCK];
+    JPEGIMAGE image;
+    begin_encoder(image, JPEG_Q_HIGH);
+
+    uint64_t start = bench_count();
+    for (int i = 0; i < blocks; i++) {
+        JPEGFDCT(&samples[(i % 64) * BLOCK], coefficients);
+        JPEGQuantize(&image, coefficients, 0);
+    }
+    const uint64_t scalar_count = bench_count() - start;
+
+    start = bench_count();
+    for (int i = 0; i < blocks; i++) {
+        JPEGFDCT_MVE(&samples[(i % 64) * BLOCK], coefficients);
+        JPEGQuantize_MVE(&image, coefficients, 0);
+    }
+    const uint64_t mve_count = bench_count() - start;
+
+    printf("JPEG DCT and quantisation: %.0f " BENCH_UNIT " per block scalar, %.0f MVE" MVE_NOTE "\n",
+           (double)scalar_count / blocks, (double)mve_count / blocks);
+}
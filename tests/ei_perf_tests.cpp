@@ -0,0 +1,230 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ei_perf_lib.h"
+#include "test_porting.h"
+
+#include <catch.hpp>
+#include <cstdint>
+#include <string>
+
+#if defined(ARM_NPU)
+extern "C" {
+#include "ethosu_profiler.h"
+}
+
+/* perf_npu_tests: the Ethos-U PMU, with the counters the test sets */
+static ethosu_pmu_counters npu_counters;
+
+void ethosu_pmu_init(void)
+{
+}
+
+void ethosu_pmu_reset_counters(void)
+{
+}
+
+ethosu_pmu_counters ethosu_get_pmu_counters(void)
+{
+    return npu_counters;
+}
+#endif
+
+/* Runs one inference on the stopped clock: begin at start_us, end total_us later */
+static const ei_perf_record_t *run(uint64_t start_us, uint32_t total_us, int64_t dsp_us, int64_t classification_us)
+{
+    ei_impulse_result_t result = {};
+    result.timing.dsp_us = dsp_us;
+    result.timing.classification_us = classification_us;
+
+    test_timer_set(start_us);
+    ei_perf_begin();
+    test_timer_set(start_us + total_us);
+    ei_perf_end(&result, nullptr);
+    test_timer_release();
+
+    return ei_perf_get_last();
+}
+
+TEST_CASE("Perf stage split", "[perf]")
+{
+#if defined(ARM_NPU)
+    npu_counters = {};
+#endif
+
+    SECTION("Host builds count microseconds")
+    {
+        const ei_perf_record_t *record = run(1000, 5000, 1000, 3000);
+        REQUIRE(record->cpu_hz == 1000000);
+        REQUIRE(record->total == 5000);
+        REQUIRE(record->dsp == 1000);
+        REQUIRE(record->npu_wait == 0);
+        REQUIRE(record->cpu_ops == 3000);
+        REQUIRE(record->post == 1000);
+    }
+
+    SECTION("Post is 0 when the stages add up to more than the total")
+    {
+        const ei_perf_record_t *record = run(1000, 3000, 1000, 2500);
+        REQUIRE(record->total == 3000);
+        REQUIRE(record->dsp == 1000);
+        REQUIRE(record->cpu_ops == 2500);
+        REQUIRE(record->post == 0);
+
+        // dsp + classification past 32 bits must not wrap back under the total
+        record = run(0, 4000000000u, 3000000000LL, 3000000000LL);
+        REQUIRE(record->post == 0);
+    }
+
+    SECTION("Stage times saturate rather than truncate")
+    {
+        const ei_perf_record_t *record = run(0, 100, 1LL << 40, -5);
+        REQUIRE(record->dsp == UINT32_MAX);
+        REQUIRE(record->cpu_ops == 0);
+        REQUIRE(record->post == 0);
+    }
+
+    SECTION("Total across a wrap of the 32 bit counter")
+    {
+        const ei_perf_record_t *record = run(0xFFFFFF00u, 0x200, 0x80, 0x100);
+        REQUIRE(record->total == 0x200);
+        REQUIRE(record->post == 0x80);
+    }
+
+#if defined(ARM_NPU)
+    SECTION("Classification splits into NPU wait and CPU operators")
+    {
+        npu_counters.cpu_wait_ccnt = 2000;
+        const ei_perf_record_t *record = run(0, 5000, 1000, 3000);
+        REQUIRE(record->npu_wait == 2000);
+        REQUIRE(record->cpu_ops == 1000);
+        REQUIRE(record->post == 1000);
+    }
+
+    SECTION("NPU wait is capped at the classification time")
+    {
+        npu_counters.cpu_wait_ccnt = 4000;
+        const ei_perf_record_t *record = run(0, 5000, 1000, 3000);
+        REQUIRE(record->npu_wait == 3000);
+        REQUIRE(record->cpu_ops == 0);
+        REQUIRE(record->post == 1000);
+    }
+#endif
+}
+
+TEST_CASE("Perf record", "[perf]")
+{
+#if defined(ARM_NPU)
+    npu_counters = {};
+#endif
+
+    SECTION("Each inference gets the next sequence number")
+    {
+        const uint32_t sequence = run(0, 10, 0, 0)->sequence;
+        REQUIRE(sequence > 0);
+        REQUIRE(run(0, 10, 0, 0)->sequence == sequence + 1);
+    }
+
+    SECTION("Camera stages, with crop, resize and colour correction as one")
+    {
+        ei_impulse_result_t result = {};
+        const ei_camera_stage_cycles_t capture = { 100, 200, 30, 40, 50 };
+
+        test_timer_set(0);
+        ei_perf_begin();
+        ei_perf_end(&result, &capture);
+        test_timer_release();
+
+        const ei_perf_record_t *record = ei_perf_get_last();
+        REQUIRE(record->capture == 100);
+        REQUIRE(record->demosaic == 200);
+        REQUIRE(record->resize == 120);
+        // capture is outside the run of the impulse
+        REQUIRE(record->total == 0);
+    }
+
+#if defined(ARM_NPU)
+    SECTION("Ethos-U counters")
+    {
+        npu_counters.npu_evt_counters[0].counter_value = 11;
+        npu_counters.npu_evt_counters[1].counter_value = 22;
+        npu_counters.npu_evt_counters[2].counter_value = 33;
+        npu_counters.npu_evt_counters[3].counter_value = 44;
+        npu_counters.npu_derived_counters[0].counter_value = 55;
+
+        const ei_perf_record_t *record = run(0, 10, 0, 0);
+        REQUIRE(record->npu_idle == 11);
+        REQUIRE(record->axi0_rd_beats == 22);
+        REQUIRE(record->axi0_wr_beats == 33);
+        REQUIRE(record->axi1_rd_beats == 44);
+        REQUIRE(record->npu_active == 55);
+    }
+#endif
+
+    SECTION("AT+PERF prints one line of JSON")
+    {
+        ei_perf_record_t record = {};
+        record.sequence = 7;
+        record.cpu_hz = 400000000;
+        record.capture = 1;
+        record.demosaic = 2;
+        record.resize = 3;
+        record.dsp = 4;
+        record.npu_wait = 5;
+        record.cpu_ops = 6;
+        record.post = 7;
+        record.total = 22;
+        record.npu_active = 300;
+        record.npu_idle = 100;
+        record.axi0_rd_beats = 100;
+        record.axi0_wr_beats = 50;
+        record.axi1_rd_beats = 25;
+
+        test_output_clear();
+        ei_perf_print(&record);
+        REQUIRE(test_output() ==
+            "{\"seq\":7,\"cpu_hz\":400000000,"
+            "\"capture\":1,\"demosaic\":2,\"resize\":3,\"dsp\":4,"
+            "\"npu_wait\":5,\"cpu_ops\":6,\"post\":7,\"total\":22,"
+            "\"npu_active\":300,\"npu_idle\":100,"
+            "\"axi0_rd_bytes\":800,\"axi0_wr_bytes\":400,\"axi1_rd_bytes\":200,"
+            "\"axi_bytes_per_npu_cycle\":3.50}\n");
+
+        // no NPU cycles, no ratio
+        record.npu_active = record.npu_idle = 0;
+        test_output_clear();
+        ei_perf_print(&record);
+        REQUIRE(test_output().find("\"axi_bytes_per_npu_cycle\":0.00}") != std::string::npos);
+    }
+}
@@ -0,0 +1,103 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ei_threshold_lib.h"
+
+#include <catch.hpp>
+#include <cmath>
+#include <string>
+
+TEST_CASE("Result threshold", "[threshold]")
+{
+    SECTION("Accepts 0 to 1 and counts changes")
+    {
+        uint32_t changes = ei_threshold_changes();
+
+        REQUIRE(ei_threshold_set(0.7f));
+        REQUIRE(ei_threshold_get() == 0.7f);
+        REQUIRE(ei_threshold_set(0.7f));
+        REQUIRE(ei_threshold_changes() == changes + 2);
+
+        for (float threshold : { -0.01f, 1.01f, NAN }) {
+            REQUIRE_FALSE(ei_threshold_set(threshold));
+        }
+        REQUIRE(ei_threshold_get() == 0.7f);
+        REQUIRE(ei_threshold_changes() == changes + 2);
+
+        REQUIRE(ei_threshold_set(0.0f));
+        REQUIRE(ei_threshold_set(1.0f));
+        REQUIRE(ei_threshold_set(EI_RESULT_THRESHOLD));
+    }
+
+#if EI_CLASSIFIER_OBJECT_DETECTION == 1
+    SECTION("Drops the objects under it, in order")
+    {
+        const float values[] = { 0.6f, 0.9f, 0.3f, 0.75f, 0.0f };
+        const char *labels[] = { "a", "b", "c", "d", "e" };
+        ei_impulse_result_bounding_box_t boxes[5] = {};
+        for (int i = 0; i < 5; i++) {
+            boxes[i].label = labels[i];
+            boxes[i].value = values[i];
+            boxes[i].x = i;
+        }
+
+        ei_impulse_result_t result = {};
+        result.bounding_boxes = boxes;
+        result.bounding_boxes_count = 5;
+
+        // the default keeps everything
+        REQUIRE(ei_threshold_set(EI_RESULT_THRESHOLD));
+        ei_threshold_apply(&result);
+        REQUIRE(result.bounding_boxes_count == 5);
+
+        REQUIRE(ei_threshold_set(0.6f));
+        ei_threshold_apply(&result);
+        REQUIRE(result.bounding_boxes_count == 3);
+        REQUIRE(std::string(boxes[0].label) == "a");
+        REQUIRE(std::string(boxes[1].label) == "b");
+        REQUIRE(std::string(boxes[2].label) == "d");
+        REQUIRE(boxes[2].x == 3);
+
+        REQUIRE(ei_threshold_set(1.0f));
+        ei_threshold_apply(&result);
+        REQUIRE(result.bounding_boxes_count == 0);
+
+        result.bounding_boxes = nullptr;
+        ei_threshold_apply(&result);
+        REQUIRE(result.bounding_boxes_count == 0);
+
+        REQUIRE(ei_threshold_set(EI_RESULT_THRESHOLD));
+    }
+#endif
+}
@@ -0,0 +1,117 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Fuzz entry point for the AT parser and the line editor. Built as a
+ * libFuzzer target with EI_TESTS_FUZZ, and run over random input by
+ * ei_at_server_tests.cpp otherwise.
+ *
+ * The first byte picks the target: even parses the rest as one command line,
+ * odd feeds it to a server a character at a time, as if typed.
+ */
+
+#include "ei_at_server.h"
+#include "ei_at_parser.h"
+#include <cstdint>
+#include <cstring>
+
+static bool fuzz_run(void)
+{
+    return true;
+}
+
+static bool fuzz_read(void)
+{
+    return true;
+}
+
+static bool fuzz_write(const char **argv, const int argc)
+{
+    // every argument must be a string inside the line
+    size_t total = 0;
+    for (int i = 0; i < argc; i++) {
+        total += strlen(argv[i]);
+    }
+    return total <= AT_LINE_BUFFER_SIZE;
+}
+
+static ATServer *fuzz_server(void)
+{
+    static ATServer *server = nullptr;
+
+    if (server == nullptr) {
+        server = ATServer::get_instance();
+        server->register_command("CONFIG", "", fuzz_run, fuzz_read, fuzz_write, "A,B");
+        server->register_command("RUN", "", fuzz_run, nullptr, nullptr, nullptr);
+        server->register_command("SET", "", nullptr, fuzz_read, fuzz_write, "X");
+        server->set_async("SET", true);
+    }
+    return server;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+
+    if ((data[0] & 1) == 0) {
+        char line[AT_LINE_BUFFER_SIZE + 1];
+        size_t len = size - 1 < AT_LINE_BUFFER_SIZE ? size - 1 : AT_LINE_BUFFER_SIZE;
+        memcpy(line, data + 1, len);
+        line[len] = '\0';
+
+        ATParser parser;
+        const ATParseResult_t &res = parser.parse(line);
+        if (res.type == AT_WRITE && (res.argument_count < 1 || res.argument_count > AT_MAX_ARGUMENTS)) {
+            __builtin_trap();
+        }
+        for (int i = 0; i < res.argument_count; i++) {
+            if (res.arguments[i] < line || res.arguments[i] > line + len) {
+                __builtin_trap();
+            }
+        }
+    }
+    else {
+        ATServer *server = fuzz_server();
+        for (size_t i = 1; i < size; i++) {
+            server->handle((char)data[i]);
+        }
+        // end any escape sequence and run the line, so the next input
+        // starts from an empty line
+        server->handle('Z');
+        server->handle('\r');
+    }
+
+    return 0;
+}
@@ -0,0 +1,409 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Lane by lane host emulation of the MVE (Helium) intrinsics the firmware
+ * uses, for C and C++, so the vector code paths can be built and compared with the scalar
+ * ones on the host. Only on the include path of host builds, Cortex-M55
+ * builds get the compiler's arm_mve.h.
+ *
+ * Semantics follow the Arm C Language Extensions: integer arithmetic wraps,
+ * shifts right are arithmetic for signed types, and predicates have one bit
+ * per byte of the vector.
+ */
+
+#ifndef TEST_ARM_MVE_EMULATION_H
+#define TEST_ARM_MVE_EMULATION_H
+
+#include <stdint.h>
+#include <string.h>
+
+typedef struct { uint8_t val[16]; } uint8x16_t;
+typedef struct { int16_t val[8]; } int16x8_t;
+typedef struct { uint16_t val[8]; } uint16x8_t;
+typedef struct { int32_t val[4]; } int32x4_t;
+typedef struct { uint32_t val[4]; } uint32x4_t;
+typedef struct { uint8x16_t val[4]; } uint8x16x4_t;
+typedef uint16_t mve_pred16_t;
+
+/* Lane i of an N lane vector is active when predicate bit i * 16 / N is set */
+#define MVE_EMU_ACTIVE(p, i, lanes) (((p) >> ((i) * (16 / (lanes)))) & 1)
+
+/* u8 ---------------------------------------------------------------------- */
+
+static inline uint8x16_t vdupq_n_u8(uint8_t a)
+{
+    uint8x16_t r;
+    for (int i = 0; i < 16; i++) r.val[i] = a;
+    return r;
+}
+
+static inline uint8x16_t vidupq_n_u8(uint32_t a, int imm)
+{
+    uint8x16_t r;
+    for (int i = 0; i < 16; i++) r.val[i] = (uint8_t)(a + i * imm);
+    return r;
+}
+
+static inline uint8x16_t vmulq_n_u8(uint8x16_t a, uint8_t b)
+{
+    for (int i = 0; i < 16; i++) a.val[i] = (uint8_t)(a.val[i] * b);
+    return a;
+}
+
+static inline uint8x16_t vandq_u8(uint8x16_t a, uint8x16_t b)
+{
+    for (int i = 0; i < 16; i++) a.val[i] &= b.val[i];
+    return a;
+}
+
+static inline uint8x16_t vorrq_u8(uint8x16_t a, uint8x16_t b)
+{
+    for (int i = 0; i < 16; i++) a.val[i] |= b.val[i];
+    return a;
+}
+
+static inline uint8x16_t vshlq_n_u8(uint8x16_t a, int imm)
+{
+    for (int i = 0; i < 16; i++) a.val[i] = (uint8_t)(a.val[i] << imm);
+    return a;
+}
+
+static inline uint8x16_t vshrq_n_u8(uint8x16_t a, int imm)
+{
+    for (int i = 0; i < 16; i++) a.val[i] = (uint8_t)(a.val[i] >> imm);
+    return a;
+}
+
+static inline uint8x16_t vldrbq_gather_offset_u8(const uint8_t *base, uint8x16_t offset)
+{
+    uint8x16_t r;
+    for (int i = 0; i < 16; i++) r.val[i] = base[offset.val[i]];
+    return r;
+}
+
+static inline void vst4q_u8(uint8_t *addr, uint8x16x4_t v)
+{
+    for (int i = 0; i < 16; i++) {
+        for (int j = 0; j < 4; j++) addr[i * 4 + j] = v.val[j].val[i];
+    }
+}
+
+static inline uint8x16_t vld1q_u8(const uint8_t *base)
+{
+    uint8x16_t r;
+    for (int i = 0; i < 16; i++) r.val[i] = base[i];
+    return r;
+}
+
+/* Reverses the bytes of each 32 bit element */
+static inline uint8x16_t vrev32q_u8(uint8x16_t a)
+{
+    uint8x16_t r;
+    for (int i = 0; i < 16; i++) r.val[i] = a.val[(i & ~3) + 3 - (i & 3)];
+    return r;
+}
+
+/* s16 / u16 --------------------------------------------------------------- */
+
+static inline int16x8_t vdupq_n_s16(int16_t a)
+{
+    int16x8_t r;
+    for (int i = 0; i < 8; i++) r.val[i] = a;
+    return r;
+}
+
+static inline uint16x8_t vidupq_n_u16(uint32_t a, int imm)
+{
+    uint16x8_t r;
+    for (int i = 0; i < 8; i++) r.val[i] = (uint16_t)(a + i * imm);
+    return r;
+}
+
+static inline uint16x8_t vmulq_n_u16(uint16x8_t a, uint16_t b)
+{
+    for (int i = 0; i < 8; i++) a.val[i] = (uint16_t)(a.val[i] * b);
+    return a;
+}
+
+static inline int16x8_t vld1q_s16(const int16_t *base)
+{
+    int16x8_t r;
+    for (int i = 0; i < 8; i++) r.val[i] = base[i];
+    return r;
+}
+
+static inline void vst1q_s16(int16_t *base, int16x8_t v)
+{
+    for (int i = 0; i < 8; i++) base[i] = v.val[i];
+}
+
+static inline int16x8_t vaddq_s16(int16x8_t a, int16x8_t b)
+{
+    for (int i = 0; i < 8; i++) a.val[i] = (int16_t)(a.val[i] + b.val[i]);
+    return a;
+}
+
+static inline int16x8_t vsubq_s16(int16x8_t a, int16x8_t b)
+{
+    for (int i = 0; i < 8; i++) a.val[i] = (int16_t)(a.val[i] - b.val[i]);
+    return a;
+}
+
+static inline int16x8_t vabsq_s16(int16x8_t a)
+{
+    for (int i = 0; i < 8; i++) a.val[i] = (int16_t)(a.val[i] < 0 ? -a.val[i] : a.val[i]);
+    return a;
+}
+
+static inline int16x8_t vnegq_s16(int16x8_t a)
+{
+    for (int i = 0; i < 8; i++) a.val[i] = (int16_t)-a.val[i];
+    return a;
+}
+
+static inline int16x8_t vshrq_n_s16(int16x8_t a, int imm)
+{
+    for (int i = 0; i < 8; i++) a.val[i] = (int16_t)(a.val[i] >> imm);
+    return a;
+}
+
+static inline mve_pred16_t vcmpltq_n_s16(int16x8_t a, int16_t b)
+{
+    mve_pred16_t p = 0;
+    for (int i = 0; i < 8; i++) {
+        if (a.val[i] < b) p |= 3 << (i * 2);
+    }
+    return p;
+}
+
+static inline int16x8_t vpselq_s16(int16x8_t a, int16x8_t b, mve_pred16_t p)
+{
+    for (int i = 0; i < 8; i++) {
+        if (!MVE_EMU_ACTIVE(p, i, 8)) a.val[i] = b.val[i];
+    }
+    return a;
+}
+
+static inline int32_t vaddvaq_p_s16(int32_t a, int16x8_t b, mve_pred16_t p)
+{
+    for (int i = 0; i < 8; i++) {
+        if (MVE_EMU_ACTIVE(p, i, 8)) a += b.val[i];
+    }
+    return a;
+}
+
+static inline int16x8_t vldrbq_gather_offset_s16(const int8_t *base, uint16x8_t offset)
+{
+    int16x8_t r;
+    for (int i = 0; i < 8; i++) r.val[i] = base[offset.val[i]];
+    return r;
+}
+
+static inline void vstrhq_scatter_shifted_offset_s16(int16_t *base, uint16x8_t offset, int16x8_t v)
+{
+    for (int i = 0; i < 8; i++) base[offset.val[i]] = v.val[i];
+}
+
+/* Widening multiplies of the even (bottom) or odd (top) lanes */
+static inline int32x4_t vmullbq_int_s16(int16x8_t a, int16x8_t b)
+{
+    int32x4_t r;
+    for (int i = 0; i < 4; i++) r.val[i] = (int32_t)a.val[2 * i] * b.val[2 * i];
+    return r;
+}
+
+static inline int32x4_t vmulltq_int_s16(int16x8_t a, int16x8_t b)
+{
+    int32x4_t r;
+    for (int i = 0; i < 4; i++) r.val[i] = (int32_t)a.val[2 * i + 1] * b.val[2 * i + 1];
+    return r;
+}
+
+/* Narrowing moves into the even (bottom) or odd (top) lanes of a */
+static inline int16x8_t vmovnbq_s32(int16x8_t a, int32x4_t b)
+{
+    for (int i = 0; i < 4; i++) a.val[2 * i] = (int16_t)b.val[i];
+    return a;
+}
+
+static inline int16x8_t vmovntq_s32(int16x8_t a, int32x4_t b)
+{
+    for (int i = 0; i < 4; i++) a.val[2 * i + 1] = (int16_t)b.val[i];
+    return a;
+}
+
+/* s32 / u32 --------------------------------------------------------------- */
+
+static inline int32x4_t vdupq_n_s32(int32_t a)
+{
+    int32x4_t r;
+    for (int i = 0; i < 4; i++) r.val[i] = a;
+    return r;
+}
+
+static inline uint32x4_t vidupq_n_u32(uint32_t a, int imm)
+{
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) r.val[i] = a + i * imm;
+    return r;
+}
+
+static inline uint32x4_t vaddq_n_u32(uint32x4_t a, uint32_t b)
+{
+    for (int i = 0; i < 4; i++) a.val[i] += b;
+    return a;
+}
+
+static inline uint32x4_t vmulq_n_u32(uint32x4_t a, uint32_t b)
+{
+    for (int i = 0; i < 4; i++) a.val[i] *= b;
+    return a;
+}
+
+static inline int32x4_t vreinterpretq_s32_u32(uint32x4_t a)
+{
+    int32x4_t r;
+    for (int i = 0; i < 4; i++) r.val[i] = (int32_t)a.val[i];
+    return r;
+}
+
+/* Little endian, as the Cortex-M55 is configured */
+static inline uint32x4_t vreinterpretq_u32_u8(uint8x16_t a)
+{
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r.val[i] = (uint32_t)a.val[4 * i] | (uint32_t)a.val[4 * i + 1] << 8 |
+                   (uint32_t)a.val[4 * i + 2] << 16 | (uint32_t)a.val[4 * i + 3] << 24;
+    }
+    return r;
+}
+
+static inline uint32x4_t vld1q_u32(const uint32_t *base)
+{
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) r.val[i] = base[i];
+    return r;
+}
+
+static inline void vst1q_u32(uint32_t *base, uint32x4_t v)
+{
+    for (int i = 0; i < 4; i++) base[i] = v.val[i];
+}
+
+static inline uint32x4_t vaddq_u32(uint32x4_t a, uint32x4_t b)
+{
+    for (int i = 0; i < 4; i++) a.val[i] += b.val[i];
+    return a;
+}
+
+static inline uint32x4_t veorq_u32(uint32x4_t a, uint32x4_t b)
+{
+    for (int i = 0; i < 4; i++) a.val[i] ^= b.val[i];
+    return a;
+}
+
+static inline uint32x4_t vshlq_n_u32(uint32x4_t a, int imm)
+{
+    for (int i = 0; i < 4; i++) a.val[i] <<= imm;
+    return a;
+}
+
+static inline uint32x4_t vshrq_n_u32(uint32x4_t a, int imm)
+{
+    for (int i = 0; i < 4; i++) a.val[i] >>= imm;
+    return a;
+}
+
+/* Shifts b right and inserts it into a, keeping the top imm bits of a */
+static inline uint32x4_t vsriq_n_u32(uint32x4_t a, uint32x4_t b, int imm)
+{
+    const uint32_t mask = 0xffffffffu >> imm;
+    for (int i = 0; i < 4; i++) a.val[i] = (a.val[i] & ~mask) | (b.val[i] >> imm);
+    return a;
+}
+
+static inline int32x4_t vaddq_s32(int32x4_t a, int32x4_t b)
+{
+    for (int i = 0; i < 4; i++) a.val[i] = (int32_t)((uint32_t)a.val[i] + (uint32_t)b.val[i]);
+    return a;
+}
+
+static inline int32x4_t vsubq_n_s32(int32x4_t a, int32_t b)
+{
+    for (int i = 0; i < 4; i++) a.val[i] = (int32_t)((uint32_t)a.val[i] - (uint32_t)b);
+    return a;
+}
+
+static inline int32x4_t vmulq_n_s32(int32x4_t a, int32_t b)
+{
+    for (int i = 0; i < 4; i++) a.val[i] = (int32_t)((uint32_t)a.val[i] * (uint32_t)b);
+    return a;
+}
+
+static inline int32x4_t vmlaq_n_s32(int32x4_t a, int32x4_t b, int32_t c)
+{
+    for (int i = 0; i < 4; i++) a.val[i] = (int32_t)((uint32_t)a.val[i] + (uint32_t)b.val[i] * (uint32_t)c);
+    return a;
+}
+
+static inline int32x4_t vshlq_n_s32(int32x4_t a, int imm)
+{
+    for (int i = 0; i < 4; i++) a.val[i] = (int32_t)((uint32_t)a.val[i] << imm);
+    return a;
+}
+
+static inline int32x4_t vshrq_n_s32(int32x4_t a, int imm)
+{
+    for (int i = 0; i < 4; i++) a.val[i] >>= imm;
+    return a;
+}
+
+static inline uint32x4_t vldrbq_gather_offset_u32(const uint8_t *base, uint32x4_t offset)
+{
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) r.val[i] = base[offset.val[i]];
+    return r;
+}
+
+static inline void vstrbq_s32(int8_t *base, int32x4_t v)
+{
+    for (int i = 0; i < 4; i++) base[i] = (int8_t)v.val[i];
+}
+
+static inline void vstrbq_scatter_offset_s32(int8_t *base, uint32x4_t offset, int32x4_t v)
+{
+    for (int i = 0; i < 4; i++) base[offset.val[i]] = (int8_t)v.val[i];
+}
+
+#endif /* TEST_ARM_MVE_EMULATION_H */
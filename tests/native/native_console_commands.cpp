@@ -0,0 +1,76 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* AT commands for the native console test: a long running AT+RUNIMPULSE
+ * that polls for a stop the way inference does, and an async AT+PING. The
+ * test feeds main_native.cpp input on stdin and checks how the run ended.
+ */
+
+#include "ei_at_commands.h"
+#include "firmware-sdk-alif/ei_device_lib.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+static bool run_impulse(void)
+{
+    ei_printf("Starting inferencing, press 'b' to break\n");
+
+    // about 10 s of frames, long enough for the slowest CI machine
+    for (int frame = 0; frame < 1000; frame++) {
+        if (ei_user_invoke_stop_lib()) {
+            ei_printf("Inferencing stopped by user\n");
+            return true;
+        }
+        ei_sleep(10);
+    }
+
+    ei_printf("Inferencing not stopped\n");
+    return true;
+}
+
+static bool ping(void)
+{
+    ei_printf("PONG\n");
+    return true;
+}
+
+ATServer *ei_at_commands_init(void)
+{
+    auto at = ATServer::get_instance();
+
+    at->register_command("RUNIMPULSE", "Runs the impulse", run_impulse, nullptr, nullptr, nullptr);
+    at->register_command("PING", "Answers PONG", nullptr, ping, nullptr, nullptr);
+    at->set_async("PING", true);
+
+    return at;
+}
@@ -0,0 +1,133 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host porting layer for the unit tests: output is collected in a string
+ * instead of printed, time comes from the monotonic clock unless a test set it
+ */
+
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "test_porting.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <time.h>
+
+static std::string output;
+static bool timer_set = false;
+static uint64_t timer_us;
+
+const std::string &test_output(void)
+{
+    return output;
+}
+
+void test_output_clear(void)
+{
+    output.clear();
+}
+
+void test_timer_set(uint64_t us)
+{
+    timer_set = true;
+    timer_us = us;
+}
+
+void test_timer_release(void)
+{
+    timer_set = false;
+}
+
+void ei_printf(const char *format, ...)
+{
+    char buf[1024];
+    va_list myargs;
+    va_start(myargs, format);
+    int len = vsnprintf(buf, sizeof(buf), format, myargs);
+    va_end(myargs);
+    if (len > 0) {
+        output.append(buf, (size_t)len < sizeof(buf) ? len : sizeof(buf) - 1);
+    }
+}
+
+void ei_printf_float(float f)
+{
+    ei_printf("%f", f);
+}
+
+void ei_putchar(char c)
+{
+    output.push_back(c);
+}
+
+EI_IMPULSE_ERROR ei_sleep(int32_t time_ms)
+{
+    if (time_ms > 0) {
+        struct timespec ts;
+        ts.tv_sec = time_ms / 1000;
+        ts.tv_nsec = (time_ms % 1000) * 1000000L;
+        nanosleep(&ts, NULL);
+    }
+    return EI_IMPULSE_OK;
+}
+
+uint64_t ei_read_timer_us()
+{
+    if (timer_set) {
+        return timer_us;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint64_t ei_read_timer_ms()
+{
+    return ei_read_timer_us() / 1000;
+}
+
+void *ei_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void *ei_calloc(size_t nitems, size_t size)
+{
+    return calloc(nitems, size);
+}
+
+void ei_free(void *ptr)
+{
+    free(ptr);
+}